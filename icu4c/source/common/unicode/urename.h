@@ -1253,6 +1253,8 @@
 #define unumf_closeResult U_ICU_ENTRY_POINT_RENAME(unumf_closeResult)
 #define unumf_formatDecimal U_ICU_ENTRY_POINT_RENAME(unumf_formatDecimal)
 #define unumf_formatDouble U_ICU_ENTRY_POINT_RENAME(unumf_formatDouble)
+#define unumf_formatDoubleArray U_ICU_ENTRY_POINT_RENAME(unumf_formatDoubleArray)
+#define unumf_formatDoubleArrayToUTF8 U_ICU_ENTRY_POINT_RENAME(unumf_formatDoubleArrayToUTF8)
 #define unumf_formatInt U_ICU_ENTRY_POINT_RENAME(unumf_formatInt)
 #define unumf_openForSkeletonAndLocale U_ICU_ENTRY_POINT_RENAME(unumf_openForSkeletonAndLocale)
 #define unumf_openForSkeletonAndLocaleWithError U_ICU_ENTRY_POINT_RENAME(unumf_openForSkeletonAndLocaleWithError)
@@ -1262,6 +1264,7 @@
 #define unumf_resultNextFieldPosition U_ICU_ENTRY_POINT_RENAME(unumf_resultNextFieldPosition)
 #define unumf_resultToDecimalNumber U_ICU_ENTRY_POINT_RENAME(unumf_resultToDecimalNumber)
 #define unumf_resultToString U_ICU_ENTRY_POINT_RENAME(unumf_resultToString)
+#define unumf_resultToUTF8 U_ICU_ENTRY_POINT_RENAME(unumf_resultToUTF8)
 #define unumrf_close U_ICU_ENTRY_POINT_RENAME(unumrf_close)
 #define unumrf_closeResult U_ICU_ENTRY_POINT_RENAME(unumrf_closeResult)
 #define unumrf_formatDecimalRange U_ICU_ENTRY_POINT_RENAME(unumrf_formatDecimalRange)
@@ -1886,6 +1889,15 @@
 #define utrie_swapAnyVersion U_ICU_ENTRY_POINT_RENAME(utrie_swapAnyVersion)
 #define utrie_unserialize U_ICU_ENTRY_POINT_RENAME(utrie_unserialize)
 #define utrie_unserializeDummy U_ICU_ENTRY_POINT_RENAME(utrie_unserializeDummy)
+#define uunitconv_close U_ICU_ENTRY_POINT_RENAME(uunitconv_close)
+#define uunitconv_convert U_ICU_ENTRY_POINT_RENAME(uunitconv_convert)
+#define uunitconv_convertArray U_ICU_ENTRY_POINT_RENAME(uunitconv_convertArray)
+#define uunitconv_open U_ICU_ENTRY_POINT_RENAME(uunitconv_open)
+#define uunitrouter_close U_ICU_ENTRY_POINT_RENAME(uunitrouter_close)
+#define uunitrouter_countOutputUnits U_ICU_ENTRY_POINT_RENAME(uunitrouter_countOutputUnits)
+#define uunitrouter_getOutputUnit U_ICU_ENTRY_POINT_RENAME(uunitrouter_getOutputUnit)
+#define uunitrouter_open U_ICU_ENTRY_POINT_RENAME(uunitrouter_open)
+#define uunitrouter_route U_ICU_ENTRY_POINT_RENAME(uunitrouter_route)
 #define vzone_clone U_ICU_ENTRY_POINT_RENAME(vzone_clone)
 #define vzone_close U_ICU_ENTRY_POINT_RENAME(vzone_close)
 #define vzone_countTransitionRules U_ICU_ENTRY_POINT_RENAME(vzone_countTransitionRules)
@@ -102,7 +102,8 @@ UnifiedCache::UnifiedCache(UErrorCode &status) :
         fMaxUnused(DEFAULT_MAX_UNUSED),
         fMaxPercentageOfInUse(DEFAULT_PERCENTAGE_OF_IN_USE),
         fAutoEvictedCount(0),
-        fNoValue(nullptr) {
+        fNoValue(nullptr),
+        fNumPendingDeletes(0) {
     if (U_FAILURE(status)) {
         return;
     }
@@ -156,18 +157,31 @@ int32_t UnifiedCache::keyCount() const {
 }
 
 void UnifiedCache::flush() const {
-    std::lock_guard<std::mutex> lock(*gCacheMutex);
-
     // Use a loop in case cache items that are flushed held hard references to
     // other cache items making those additional cache items eligible for
     // flushing.
-    while (_flush(FALSE));
+    for (;;) {
+        {
+            std::lock_guard<std::mutex> lock(*gCacheMutex);
+            while (_flush(FALSE));
+            if (fNumPendingDeletes == 0) {
+                return;
+            }
+        }
+        deletePendingValues();
+    }
 }
 
 void UnifiedCache::handleUnreferencedObject() const {
-    std::lock_guard<std::mutex> lock(*gCacheMutex);
-    --fNumValuesInUse;
-    _runEvictionSlice();
+    {
+        std::lock_guard<std::mutex> lock(*gCacheMutex);
+        --fNumValuesInUse;
+        _runEvictionSlice();
+        if (fNumPendingDeletes == 0) {
+            return;
+        }
+    }
+    deletePendingValues();
 }
 
 #ifdef UNIFIED_CACHE_DEBUG
@@ -227,6 +241,7 @@ UnifiedCache::~UnifiedCache() {
         std::lock_guard<std::mutex> lock(*gCacheMutex);
         _flush(TRUE);
     }
+    deletePendingValues();
     uhash_close(fHashtable);
     fHashtable = nullptr;
     delete fNoValue;
@@ -325,22 +340,28 @@ void UnifiedCache::_putIfAbsentAndGet(
         const CacheKeyBase &key,
         const SharedObject *&value,
         UErrorCode &status) const {
-    std::lock_guard<std::mutex> lock(*gCacheMutex);
-    const UHashElement *element = uhash_find(fHashtable, &key);
-    if (element != NULL && !_inProgress(element)) {
-        _fetch(element, value, status);
-        return;
-    }
-    if (element == NULL) {
-        UErrorCode putError = U_ZERO_ERROR;
-        // best-effort basis only.
-        _putNew(key, value, status, putError);
-    } else {
-        _put(element, value, status);
+    {
+        std::lock_guard<std::mutex> lock(*gCacheMutex);
+        const UHashElement *element = uhash_find(fHashtable, &key);
+        if (element != NULL && !_inProgress(element)) {
+            _fetch(element, value, status);
+            return;
+        }
+        if (element == NULL) {
+            UErrorCode putError = U_ZERO_ERROR;
+            // best-effort basis only.
+            _putNew(key, value, status, putError);
+        } else {
+            _put(element, value, status);
+        }
+        // Run an eviction slice. This will run even if we added a primary entry
+        // which doesn't increase the unused count, but that is still o.k
+        _runEvictionSlice();
+        if (fNumPendingDeletes == 0) {
+            return;
+        }
     }
-    // Run an eviction slice. This will run even if we added a primary entry
-    // which doesn't increase the unused count, but that is still o.k
-    _runEvictionSlice();
+    deletePendingValues();
 }
 
 
@@ -485,7 +506,13 @@ void UnifiedCache::removeSoftRef(const SharedObject *value) const {
     if (--value->softRefCount == 0) {
         --fNumValuesTotal;
         if (value->noHardReferences()) {
-            delete value;
+            if (fNumPendingDeletes == fPendingDeletes.getCapacity() &&
+                    fPendingDeletes.resize(2 * fNumPendingDeletes, fNumPendingDeletes) == nullptr) {
+                // Out of memory: fall back to deleting the value right away.
+                delete value;
+                return;
+            }
+            fPendingDeletes[fNumPendingDeletes++] = value;
         } else {
             // This path only happens from flush(all). Which only happens from the
             // UnifiedCache destructor.  Nulling out value.cacheptr changes the behavior
@@ -495,6 +522,20 @@ void UnifiedCache::removeSoftRef(const SharedObject *value) const {
     }
 }
 
+void UnifiedCache::deletePendingValues() const {
+    for (;;) {
+        const SharedObject *value;
+        {
+            std::lock_guard<std::mutex> lock(*gCacheMutex);
+            if (fNumPendingDeletes == 0) {
+                return;
+            }
+            value = fPendingDeletes[--fNumPendingDeletes];
+        }
+        delete value;
+    }
+}
+
 int32_t UnifiedCache::removeHardRef(const SharedObject *value) const {
     int refCount = 0;
     if (value) {
@@ -19,6 +19,7 @@
 #include "unicode/locid.h"
 #include "sharedobject.h"
 #include "unicode/unistr.h"
+#include "cmemory.h"
 #include "cstring.h"
 #include "ustr_imp.h"
 
@@ -353,6 +354,11 @@ class U_COMMON_API UnifiedCache : public UnifiedCacheBase {
    int32_t fMaxPercentageOfInUse;
    mutable int64_t fAutoEvictedCount;
    SharedObject *fNoValue;
+   // Values that lost their last reference while gCacheMutex was held.
+   // They are deleted after the mutex is released, because their destructors
+   // may release references to other cached values, which locks the mutex again.
+   mutable MaybeStackArray<const SharedObject *, 8> fPendingDeletes;
+   mutable int32_t fNumPendingDeletes;
    
    UnifiedCache(const UnifiedCache &other);
    UnifiedCache &operator=(const UnifiedCache &other);
@@ -494,6 +500,12 @@ class U_COMMON_API UnifiedCache : public UnifiedCacheBase {
      * @param value the SharedObject to be acted on.
      */
    void removeSoftRef(const SharedObject *value) const;
+
+    /**
+     * Deletes the values that removeSoftRef() could not delete while gCacheMutex was held.
+     * gCacheMutex must not be held by the caller.
+     */
+   void deletePendingValues() const;
    
    /**
     * Increment the hard reference count of the given SharedObject.
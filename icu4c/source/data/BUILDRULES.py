@@ -33,6 +33,7 @@ def generate(config, io, common_vars):
     requests += generate_full_unicore_data(config, io, common_vars)
     requests += generate_unames(config, io, common_vars)
     requests += generate_misc(config, io, common_vars)
+    requests += generate_units(config, io, common_vars)
     requests += generate_curr_supplemental(config, io, common_vars)
     requests += generate_zone_supplemental(config, io, common_vars)
     requests += generate_translit(config, io, common_vars)
@@ -378,6 +379,24 @@ def generate_misc(config, io, common_vars):
     ]
 
 
+def generate_units(config, io, common_vars):
+    # Precompiled unit identifier tables and conversion factors
+    input_file = InFile("misc/units.txt")
+    output_file = OutFile("units.icu")
+    return [
+        SingleExecutionRequest(
+            name = "units",
+            category = "units",
+            dep_targets = [DepTarget("misc_res")],
+            input_files = [input_file],
+            output_files = [output_file],
+            tool = IcuTool("genunits"),
+            args = "-i {OUT_DIR} -d {OUT_DIR} -q",
+            format_with = {}
+        )
+    ]
+
+
 def generate_curr_supplemental(config, io, common_vars):
     # Currency Supplemental Res File
     input_file = InFile("curr/supplementalData.txt")
@@ -6,8 +6,10 @@
 #if !UCONFIG_NO_FORMATTING
 
 #include "formatted_string_builder.h"
+#include "unicode/bytestream.h"
 #include "unicode/ustring.h"
 #include "unicode/utf16.h"
+#include "unicode/utf8.h"
 #include "unicode/unum.h" // for UNumberFormatFields literals
 
 namespace {
@@ -241,6 +243,22 @@ FormattedStringBuilder::insert(int32_t index, const FormattedStringBuilder &othe
     return count;
 }
 
+int32_t
+FormattedStringBuilder::insert(int32_t index, const char16_t *chars, const Field *fields, int32_t count,
+                               UErrorCode &status) {
+    if (count == 0) {
+        // Nothing to insert.
+        return 0;
+    }
+    int32_t position = prepareForInsert(index, count, status);
+    if (U_FAILURE(status)) {
+        return count;
+    }
+    uprv_memcpy(getCharPtr() + position, chars, sizeof(char16_t) * count);
+    uprv_memcpy(getFieldPtr() + position, fields, sizeof(Field) * count);
+    return count;
+}
+
 void FormattedStringBuilder::writeTerminator(UErrorCode& status) {
     int32_t position = prepareForInsert(fLength, 1, status);
     if (U_FAILURE(status)) {
@@ -362,6 +380,44 @@ const UnicodeString FormattedStringBuilder::toTempUnicodeString() const {
     return UnicodeString(FALSE, getCharPtr() + fZero, fLength);
 }
 
+void FormattedStringBuilder::appendToUTF8(ByteSink &sink) const {
+    const char16_t *chars = getCharPtr() + fZero;
+    // Transcode in chunks that fit into the stack buffer: one UTF-16 unit
+    // needs at most three UTF-8 bytes, and a surrogate pair needs four.
+    char stackBuffer[1024];
+    const int32_t maxChunkLength = UPRV_LENGTHOF(stackBuffer) / 3;
+    int32_t start = 0;
+    while (start < fLength) {
+        int32_t limit = fLength - start <= maxChunkLength ? fLength : start + maxChunkLength;
+        if (limit < fLength && U16_IS_LEAD(chars[limit - 1])) {
+            // Do not split a surrogate pair.
+            limit--;
+        }
+        int32_t capacity;
+        char *utf8 = sink.GetAppendBuffer(
+            3 * (limit - start), 3 * (fLength - start),
+            stackBuffer, UPRV_LENGTHOF(stackBuffer), &capacity);
+        int32_t length8 = 0;
+        for (int32_t i = start; i < limit;) {
+            UChar32 c = chars[i++];
+            if (c <= 0x7f) {
+                utf8[length8++] = (char)c;
+                continue;
+            }
+            if (U16_IS_SURROGATE(c)) {
+                if (U16_IS_SURROGATE_LEAD(c) && i < limit && U16_IS_TRAIL(chars[i])) {
+                    c = U16_GET_SUPPLEMENTARY(c, chars[i++]);
+                } else {
+                    c = 0xfffd;
+                }
+            }
+            U8_APPEND_UNSAFE(utf8, length8, c);
+        }
+        sink.Append(utf8, length8);
+        start = limit;
+    }
+}
+
 UnicodeString FormattedStringBuilder::toDebugString() const {
     UnicodeString sb;
     sb.append(u"<FormattedStringBuilder [", -1);
@@ -17,6 +17,7 @@
 
 U_NAMESPACE_BEGIN
 
+class ByteSink;
 class FormattedValueStringBuilderImpl;
 
 /**
@@ -152,6 +153,13 @@ class U_I18N_API FormattedStringBuilder : public UMemory {
     /** Inserts a formatted string. Note: insert at index 0 is very efficient. */
     int32_t insert(int32_t index, const FormattedStringBuilder &other, UErrorCode &status);
 
+    /**
+     * Inserts count code units, each with the field at the same index in fields.
+     * Note: insert at index 0 is very efficient.
+     */
+    int32_t insert(int32_t index, const char16_t *chars, const Field *fields, int32_t count,
+                   UErrorCode &status);
+
     /**
      * Ensures that the string buffer contains a NUL terminator. The NUL terminator does
      * not count toward the string length. Any further changes to the string (insert or
@@ -173,6 +181,12 @@ class U_I18N_API FormattedStringBuilder : public UMemory {
      */
     const UnicodeString toTempUnicodeString() const;
 
+    /**
+     * Appends the string to the sink as UTF-8, without going through a UnicodeString.
+     * Unpaired surrogates are replaced with U+FFFD, as in UnicodeString::toUTF8().
+     */
+    void appendToUTF8(ByteSink &sink) const;
+
     UnicodeString toDebugString() const;
 
     const char16_t *chars() const;
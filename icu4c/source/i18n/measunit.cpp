@@ -22,6 +22,7 @@
 #include "cstring.h"
 #include "uassert.h"
 #include "measunit_impl.h"
+#include "ustr_imp.h"
 
 U_NAMESPACE_BEGIN
 
@@ -2102,6 +2103,10 @@ static int32_t binarySearch(
     return -1;
 }
 
+static int32_t hashIdentifier(StringPiece identifier) {
+    return ustr_hashCharsN(identifier.data(), identifier.length());
+}
+
 MeasureUnit::MeasureUnit() : MeasureUnit(kBaseTypeIdx, kBaseSubTypeIdx) {
 }
 
@@ -2124,6 +2129,7 @@ MeasureUnit::MeasureUnit(MeasureUnit &&other) noexcept
 MeasureUnit::MeasureUnit(MeasureUnitImpl&& impl)
         : fImpl(nullptr), fSubTypeId(-1), fTypeId(-1) {
     if (!findBySubType(impl.identifier.toStringPiece(), this)) {
+        impl.identifierHash = hashIdentifier(impl.identifier.toStringPiece());
         fImpl = new MeasureUnitImpl(std::move(impl));
     }
 }
@@ -2204,7 +2210,23 @@ UBool MeasureUnit::operator==(const UObject& other) const {
         return FALSE;
     }
     const MeasureUnit &rhs = static_cast<const MeasureUnit&>(other);
-    return uprv_strcmp(getIdentifier(), rhs.getIdentifier()) == 0;
+    // A unit with an fImpl never has the identifier of a built-in unit, so
+    // built-in units compare by index, and others by identifier once their
+    // hashes match.
+    if (fImpl == nullptr || rhs.fImpl == nullptr) {
+        return fImpl == rhs.fImpl && fTypeId == rhs.fTypeId && fSubTypeId == rhs.fSubTypeId;
+    }
+    return fImpl->identifierHash == rhs.fImpl->identifierHash &&
+        fImpl->identifier == rhs.fImpl->identifier.toStringPiece();
+}
+
+int32_t MeasureUnit::hashCode() const {
+    // Built-in units hash to their index in gSubTypes, others to the hash of
+    // their identifier, computed when the MeasureUnit was built.
+    if (fImpl != nullptr) {
+        return fImpl->identifierHash;
+    }
+    return getOffset();
 }
 
 int32_t MeasureUnit::getAvailable(
@@ -2317,6 +2339,7 @@ void MeasureUnit::initCurrency(StringPiece isoCurrency) {
     if (result == -1) {
         fImpl = new MeasureUnitImpl(MeasureUnitImpl::forCurrencyCode(isoCurrency));
         if (fImpl) {
+            fImpl->identifierHash = hashIdentifier(fImpl->identifier.toStringPiece());
             fSubTypeId = -1;
             return;
         }
@@ -2348,6 +2371,7 @@ MeasureUnitImpl MeasureUnitImpl::copy(UErrorCode &status) const {
     MeasureUnitImpl result;
     result.complexity = complexity;
     result.identifier.append(identifier, status);
+    result.identifierHash = identifierHash;
     for (int32_t i = 0; i < singleUnits.length(); i++) {
         SingleUnitImpl *item = result.singleUnits.emplaceBack(*singleUnits[i]);
         if (!item) {
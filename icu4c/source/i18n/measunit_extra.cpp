@@ -17,6 +17,7 @@
 #include "cstring.h"
 #include "measunit_impl.h"
 #include "resource.h"
+#include "sharedobject.h"
 #include "uarrsort.h"
 #include "uassert.h"
 #include "ucln_in.h"
@@ -29,6 +30,8 @@
 #include "unicode/stringtriebuilder.h"
 #include "unicode/ures.h"
 #include "unicode/ustringtrie.h"
+#include "unifiedcache.h"
+#include "units_prebuilt.h"
 #include "uresimp.h"
 #include "util.h"
 #include <cstdlib>
@@ -237,6 +240,11 @@ class SimpleUnitIdentifiersSink : public icu::ResourceSink {
         }
     }
 
+    /**
+     * Returns the number of simple unit identifiers collected so far.
+     */
+    int32_t getCount() const { return outIndex; }
+
   private:
     const char **outArray;
     int32_t *outCategories;
@@ -313,79 +321,69 @@ class CategoriesSink : public icu::ResourceSink {
     int32_t outIndex;
 };
 
-icu::UInitOnce gUnitExtrasInitOnce = U_INITONCE_INITIALIZER;
-
-// Array of simple unit IDs.
-//
-// The array memory itself is owned by this pointer, but the individual char* in
-// that array point at static memory. (Note that these char* are also returned
-// by SingleUnitImpl::getSimpleUnitID().)
-const char **gSimpleUnits = nullptr;
-
-// Maps from the value associated with each simple unit ID to an index into the
-// gCategories array.
-int32_t *gSimpleUnitCategories = nullptr;
-
-char *gSerializedUnitExtrasStemTrie = nullptr;
-
-// Array of UChar* pointing at the unit categories (aka "quantities", aka
-// "types"), as found in the `unitQuantities` resource. The array memory itself
-// is owned by this pointer, but the individual UChar* in that array point at
-// static memory.
-const UChar **gCategories = nullptr;
-// Number of items in `gCategories`.
-int32_t gCategoriesCount = 0;
-// TODO: rather save an index into gCategories?
-const char *kConsumption = "consumption";
-size_t kConsumptionLen = strlen("consumption");
-// Serialized BytesTrie for mapping from base units to indices into gCategories.
-char *gSerializedUnitCategoriesTrie = nullptr;
-
-UBool U_CALLCONV cleanupUnitExtras() {
-    uprv_free(gSerializedUnitCategoriesTrie);
-    gSerializedUnitCategoriesTrie = nullptr;
-    uprv_free(gCategories);
-    gCategories = nullptr;
-    uprv_free(gSerializedUnitExtrasStemTrie);
-    gSerializedUnitExtrasStemTrie = nullptr;
-    uprv_free(gSimpleUnitCategories);
-    gSimpleUnitCategories = nullptr;
-    uprv_free(gSimpleUnits);
-    gSimpleUnits = nullptr;
-    gUnitExtrasInitOnce.reset();
-    return TRUE;
-}
+/**
+ * The tables needed for parsing unit identifiers and for looking up unit
+ * categories, as built from the "units" resource bundle.
+ */
+struct UnitExtrasTables : public UMemory {
+    // Array of simple unit IDs.
+    //
+    // The array memory itself is owned by this struct, but the individual
+    // char* in that array point at static memory. (Note that these char* are
+    // also returned by SingleUnitImpl::getSimpleUnitID().)
+    LocalMemory<const char *> simpleUnits;
+    int32_t simpleUnitsCount = 0;
+
+    // Maps from the value associated with each simple unit ID to an index
+    // into the categories array.
+    LocalMemory<int32_t> simpleUnitCategories;
+
+    // Serialized BytesTrie for parsing unit identifiers.
+    LocalMemory<char> stemTrie;
+    int32_t stemTrieLength = 0;
+
+    // Array of UChar* pointing at the unit categories (aka "quantities", aka
+    // "types"), as found in the `unitQuantities` resource. The array memory
+    // itself is owned by this struct, but the individual UChar* in that array
+    // point at static memory.
+    LocalMemory<const UChar *> categories;
+    int32_t categoriesCount = 0;
+
+    // Serialized BytesTrie for mapping from base units to indices into
+    // categories.
+    LocalMemory<char> categoriesTrie;
+    int32_t categoriesTrieLength = 0;
+};
 
-void U_CALLCONV initUnitExtras(UErrorCode& status) {
-    ucln_i18n_registerCleanup(UCLN_I18N_UNIT_EXTRAS, cleanupUnitExtras);
+/**
+ * Builds all UnitExtrasTables from the "units" resource bundle.
+ */
+void buildUnitExtrasTables(UnitExtrasTables &tables, UErrorCode &status) {
     LocalUResourceBundlePointer unitsBundle(ures_openDirect(nullptr, "units", &status));
 
-    // Collect unitQuantities information into gSerializedUnitCategoriesTrie and gCategories.
+    // Collect unitQuantities information into categoriesTrie and categories.
     const char *CATEGORY_TABLE_NAME = "unitQuantities";
     LocalUResourceBundlePointer unitQuantities(
         ures_getByKey(unitsBundle.getAlias(), CATEGORY_TABLE_NAME, nullptr, &status));
     if (U_FAILURE(status)) { return; }
-    gCategoriesCount = unitQuantities.getAlias()->fSize;
-    size_t quantitiesMallocSize = sizeof(UChar *) * gCategoriesCount;
-    gCategories = static_cast<const UChar **>(uprv_malloc(quantitiesMallocSize));
-    if (gCategories == nullptr) {
+    tables.categoriesCount = unitQuantities.getAlias()->fSize;
+    if (tables.categories.allocateInsteadAndReset(tables.categoriesCount) == nullptr) {
         status = U_MEMORY_ALLOCATION_ERROR;
         return;
     }
-    uprv_memset(gCategories, 0, quantitiesMallocSize);
     BytesTrieBuilder quantitiesBuilder(status);
-    CategoriesSink categoriesSink(gCategories, gCategoriesCount, quantitiesBuilder);
+    CategoriesSink categoriesSink(tables.categories.getAlias(), tables.categoriesCount,
+                                  quantitiesBuilder);
     ures_getAllItemsWithFallback(unitsBundle.getAlias(), CATEGORY_TABLE_NAME, categoriesSink, status);
     StringPiece resultQuantities = quantitiesBuilder.buildStringPiece(USTRINGTRIE_BUILD_FAST, status);
     if (U_FAILURE(status)) { return; }
-    // Copy the result into the global constant pointer
-    size_t numBytesQuantities = resultQuantities.length();
-    gSerializedUnitCategoriesTrie = static_cast<char *>(uprv_malloc(numBytesQuantities));
-    if (gSerializedUnitCategoriesTrie == nullptr) {
+    // Copy the result into the tables
+    tables.categoriesTrieLength = resultQuantities.length();
+    if (tables.categoriesTrie.allocateInsteadAndReset(tables.categoriesTrieLength) == nullptr) {
         status = U_MEMORY_ALLOCATION_ERROR;
         return;
     }
-    uprv_memcpy(gSerializedUnitCategoriesTrie, resultQuantities.data(), numBytesQuantities);
+    uprv_memcpy(tables.categoriesTrie.getAlias(), resultQuantities.data(), tables.categoriesTrieLength);
 
     // Build the BytesTrie that Parser needs for parsing unit identifiers.
 
@@ -430,39 +428,112 @@ void U_CALLCONV initUnitExtras(UErrorCode& status) {
     // Allocate enough space: with identifierSink below skipping kilogram, we're
     // probably allocating one more than needed.
     int32_t simpleUnitsCount = convertUnits.getAlias()->fSize;
-    int32_t arrayMallocSize = sizeof(char *) * simpleUnitsCount;
-    gSimpleUnits = static_cast<const char **>(uprv_malloc(arrayMallocSize));
-    if (gSimpleUnits == nullptr) {
+    if (tables.simpleUnits.allocateInsteadAndReset(simpleUnitsCount) == nullptr ||
+        tables.simpleUnitCategories.allocateInsteadAndReset(simpleUnitsCount) == nullptr) {
         status = U_MEMORY_ALLOCATION_ERROR;
         return;
     }
-    uprv_memset(gSimpleUnits, 0, arrayMallocSize);
-    arrayMallocSize = sizeof(int32_t) * simpleUnitsCount;
-    gSimpleUnitCategories = static_cast<int32_t *>(uprv_malloc(arrayMallocSize));
-    if (gSimpleUnitCategories == nullptr) {
-        status = U_MEMORY_ALLOCATION_ERROR;
-        return;
-    }
-    uprv_memset(gSimpleUnitCategories, 0, arrayMallocSize);
 
-    // Populate gSimpleUnits and build the associated trie.
-    SimpleUnitIdentifiersSink identifierSink(resultQuantities, gSimpleUnits, gSimpleUnitCategories,
-                                             simpleUnitsCount, b, kSimpleUnitOffset);
+    // Populate simpleUnits and build the associated trie.
+    SimpleUnitIdentifiersSink identifierSink(resultQuantities, tables.simpleUnits.getAlias(),
+                                             tables.simpleUnitCategories.getAlias(), simpleUnitsCount,
+                                             b, kSimpleUnitOffset);
     ures_getAllItemsWithFallback(unitsBundle.getAlias(), "convertUnits", identifierSink, status);
+    tables.simpleUnitsCount = identifierSink.getCount();
 
     // Build the CharsTrie
     // TODO: Use SLOW or FAST here?
     StringPiece result = b.buildStringPiece(USTRINGTRIE_BUILD_FAST, status);
     if (U_FAILURE(status)) { return; }
 
-    // Copy the result into the global constant pointer
-    size_t numBytes = result.length();
-    gSerializedUnitExtrasStemTrie = static_cast<char *>(uprv_malloc(numBytes));
-    if (gSerializedUnitExtrasStemTrie == nullptr) {
+    // Copy the result into the tables
+    tables.stemTrieLength = result.length();
+    if (tables.stemTrie.allocateInsteadAndReset(tables.stemTrieLength) == nullptr) {
+        status = U_MEMORY_ALLOCATION_ERROR;
+        return;
+    }
+    uprv_memcpy(tables.stemTrie.getAlias(), result.data(), tables.stemTrieLength);
+}
+
+icu::UInitOnce gUnitExtrasInitOnce = U_INITONCE_INITIALIZER;
+
+// Owns the arrays that the global pointers below point at, except for those
+// pointing into units.icu.
+UnitExtrasTables *gUnitExtrasTables = nullptr;
+
+// Array of simple unit IDs, see UnitExtrasTables::simpleUnits.
+const char *const *gSimpleUnits = nullptr;
+
+// Maps from the value associated with each simple unit ID to an index into the
+// gCategories array.
+const int32_t *gSimpleUnitCategories = nullptr;
+
+const char *gSerializedUnitExtrasStemTrie = nullptr;
+
+// Array of UChar* pointing at the unit categories, see
+// UnitExtrasTables::categories.
+const UChar *const *gCategories = nullptr;
+// Number of items in `gCategories`.
+int32_t gCategoriesCount = 0;
+// TODO: rather save an index into gCategories?
+const char *kConsumption = "consumption";
+size_t kConsumptionLen = strlen("consumption");
+// Serialized BytesTrie for mapping from base units to indices into gCategories.
+const char *gSerializedUnitCategoriesTrie = nullptr;
+
+UBool U_CALLCONV cleanupUnitExtras() {
+    gSerializedUnitCategoriesTrie = nullptr;
+    gCategories = nullptr;
+    gCategoriesCount = 0;
+    gSerializedUnitExtrasStemTrie = nullptr;
+    gSimpleUnitCategories = nullptr;
+    gSimpleUnits = nullptr;
+    delete gUnitExtrasTables;
+    gUnitExtrasTables = nullptr;
+    gUnitExtrasInitOnce.reset();
+    return TRUE;
+}
+
+void U_CALLCONV initUnitExtras(UErrorCode& status) {
+    ucln_i18n_registerCleanup(UCLN_I18N_UNIT_EXTRAS, cleanupUnitExtras);
+    const units::PrebuiltUnitsData *prebuilt = units::PrebuiltUnitsData::getInstance(status);
+    if (U_FAILURE(status)) { return; }
+    gUnitExtrasTables = new UnitExtrasTables();
+    if (gUnitExtrasTables == nullptr) {
         status = U_MEMORY_ALLOCATION_ERROR;
         return;
     }
-    uprv_memcpy(gSerializedUnitExtrasStemTrie, result.data(), numBytes);
+    UnitExtrasTables &tables = *gUnitExtrasTables;
+
+    if (prebuilt != nullptr) {
+        // Use the tables from units.icu: only the arrays of string pointers
+        // need to be set up.
+        tables.simpleUnitsCount = prebuilt->getSimpleUnitsCount();
+        tables.categoriesCount = prebuilt->getCategoriesCount();
+        if (tables.simpleUnits.allocateInsteadAndReset(tables.simpleUnitsCount) == nullptr ||
+            tables.categories.allocateInsteadAndReset(tables.categoriesCount) == nullptr) {
+            status = U_MEMORY_ALLOCATION_ERROR;
+            return;
+        }
+        for (int32_t i = 0; i < tables.simpleUnitsCount; i++) {
+            tables.simpleUnits[i] = prebuilt->getSimpleUnit(i);
+        }
+        for (int32_t i = 0; i < tables.categoriesCount; i++) {
+            tables.categories[i] = prebuilt->getCategory(i);
+        }
+        gSimpleUnitCategories = prebuilt->getSimpleUnitCategories();
+        gSerializedUnitExtrasStemTrie = prebuilt->getStemTrie();
+        gSerializedUnitCategoriesTrie = prebuilt->getCategoriesTrie();
+    } else {
+        buildUnitExtrasTables(tables, status);
+        if (U_FAILURE(status)) { return; }
+        gSimpleUnitCategories = tables.simpleUnitCategories.getAlias();
+        gSerializedUnitExtrasStemTrie = tables.stemTrie.getAlias();
+        gSerializedUnitCategoriesTrie = tables.categoriesTrie.getAlias();
+    }
+    gSimpleUnits = tables.simpleUnits.getAlias();
+    gCategories = tables.categories.getAlias();
+    gCategoriesCount = tables.categoriesCount;
 }
 
 class Token {
@@ -801,9 +872,9 @@ class Parser {
 // Sorting function wrapping SingleUnitImpl::compareTo for use with uprv_sortArray.
 int32_t U_CALLCONV
 compareSingleUnits(const void* /*context*/, const void* left, const void* right) {
-    auto realLeft = static_cast<const SingleUnitImpl* const*>(left);
-    auto realRight = static_cast<const SingleUnitImpl* const*>(right);
-    return (*realLeft)->compareTo(**realRight);
+    auto realLeft = static_cast<const SingleUnitImpl*>(left);
+    auto realRight = static_cast<const SingleUnitImpl*>(right);
+    return realLeft->compareTo(*realRight);
 }
 
 // Returns an index into the gCategories array, for the "unitQuantity" (aka
@@ -874,6 +945,44 @@ CharString U_I18N_API getUnitQuantity(StringPiece baseUnitIdentifier, UErrorCode
     return result;
 }
 
+int32_t U_I18N_API getSimpleUnitsCount(UErrorCode &status) {
+    umtx_initOnce(gUnitExtrasInitOnce, &initUnitExtras, status);
+    if (U_FAILURE(status)) {
+        return 0;
+    }
+    return gUnitExtrasTables->simpleUnitsCount;
+}
+
+void U_I18N_API getCategoryBaseUnits(MaybeStackVector<CharString> &result, UErrorCode &status) {
+    umtx_initOnce(gUnitExtrasInitOnce, &initUnitExtras, status);
+    if (U_FAILURE(status)) {
+        return;
+    }
+    BytesTrie::Iterator iter(gSerializedUnitCategoriesTrie, 0, status);
+    while (iter.next(status)) {
+        result.emplaceBackAndCheckErrorCode(status, iter.getString(), status);
+        if (U_FAILURE(status)) {
+            return;
+        }
+    }
+}
+
+void U_I18N_API addUnitExtrasToPrebuiltData(units::PrebuiltUnitsDataBuilder &builder,
+                                            UErrorCode &status) {
+    UnitExtrasTables tables;
+    buildUnitExtrasTables(tables, status);
+    if (U_FAILURE(status)) { return; }
+    builder.setStemTrie(StringPiece(tables.stemTrie.getAlias(), tables.stemTrieLength), status);
+    builder.setCategoriesTrie(
+        StringPiece(tables.categoriesTrie.getAlias(), tables.categoriesTrieLength), status);
+    for (int32_t i = 0; i < tables.simpleUnitsCount; i++) {
+        builder.addSimpleUnit(tables.simpleUnits[i], tables.simpleUnitCategories[i], status);
+    }
+    for (int32_t i = 0; i < tables.categoriesCount; i++) {
+        builder.addCategory(tables.categories[i], u_strlen(tables.categories[i]), status);
+    }
+}
+
 // In ICU4J, this is MeasureUnit.getSingleUnitImpl().
 SingleUnitImpl SingleUnitImpl::forMeasureUnit(const MeasureUnit& measureUnit, UErrorCode& status) {
     MeasureUnitImpl temp;
@@ -963,6 +1072,105 @@ MeasureUnitImpl MeasureUnitImpl::forIdentifier(StringPiece identifier, UErrorCod
     return Parser::from(identifier, status).parse(status);
 }
 
+namespace {
+
+// Counters for MeasureUnitImpl::getIdentifierCacheCounts().
+u_atomic_int32_t gIdentifierCacheLookups {};
+u_atomic_int32_t gIdentifierCacheMisses {};
+
+// A parsed unit identifier, as stored in the UnifiedCache.
+class SharedMeasureUnitImpl : public SharedObject {
+  public:
+    MeasureUnitImpl impl;
+
+    SharedMeasureUnitImpl(MeasureUnitImpl &&impl) : impl(std::move(impl)) {}
+    virtual ~SharedMeasureUnitImpl();
+};
+
+SharedMeasureUnitImpl::~SharedMeasureUnitImpl() {}
+
+// Cache key: the unit identifier, as passed to forIdentifierCached().
+class MeasureUnitIdentifierCacheKey : public CacheKey<SharedMeasureUnitImpl> {
+  public:
+    MeasureUnitIdentifierCacheKey(StringPiece identifier, UErrorCode &status)
+        : fIdentifier(identifier, status) {}
+    MeasureUnitIdentifierCacheKey(const MeasureUnitIdentifierCacheKey &other)
+        : CacheKey<SharedMeasureUnitImpl>(other) {
+        UErrorCode localStatus = U_ZERO_ERROR;
+        fIdentifier.append(other.fIdentifier, localStatus);
+    }
+    virtual ~MeasureUnitIdentifierCacheKey();
+
+    virtual int32_t hashCode() const {
+        return (int32_t)(37u * (uint32_t)CacheKey<SharedMeasureUnitImpl>::hashCode() +
+                         (uint32_t)ustr_hashCharsN(fIdentifier.data(), fIdentifier.length()));
+    }
+    virtual UBool operator==(const CacheKeyBase &other) const {
+        if (this == &other) {
+            return TRUE;
+        }
+        if (!CacheKey<SharedMeasureUnitImpl>::operator==(other)) {
+            return FALSE;
+        }
+        // We know that this and other are of same class if we get this far.
+        const MeasureUnitIdentifierCacheKey &realOther =
+            static_cast<const MeasureUnitIdentifierCacheKey &>(other);
+        return realOther.fIdentifier.toStringPiece() == fIdentifier.toStringPiece();
+    }
+    virtual CacheKeyBase *clone() const {
+        return new MeasureUnitIdentifierCacheKey(*this);
+    }
+    virtual const SharedMeasureUnitImpl *createObject(const void * /*unused*/,
+                                                      UErrorCode &status) const {
+        umtx_atomic_inc(&gIdentifierCacheMisses);
+        MeasureUnitImpl impl = Parser::from(fIdentifier.toStringPiece(), status).parse(status);
+        if (U_FAILURE(status)) {
+            return nullptr;
+        }
+        LocalPointer<SharedMeasureUnitImpl> result(new SharedMeasureUnitImpl(std::move(impl)),
+                                                   status);
+        if (U_FAILURE(status)) {
+            return nullptr;
+        }
+        result->addRef();
+        return result.orphan();
+    }
+    virtual char *writeDescription(char *buffer, int32_t bufLen) const {
+        uprv_strncpy(buffer, fIdentifier.data(), bufLen);
+        buffer[bufLen - 1] = 0;
+        return buffer;
+    }
+
+  private:
+    CharString fIdentifier;
+};
+
+MeasureUnitIdentifierCacheKey::~MeasureUnitIdentifierCacheKey() {}
+
+} // namespace
+
+MeasureUnitImpl MeasureUnitImpl::forIdentifierCached(StringPiece identifier, UErrorCode& status) {
+    const UnifiedCache *cache = UnifiedCache::getInstance(status);
+    MeasureUnitIdentifierCacheKey key(identifier, status);
+    if (U_FAILURE(status)) {
+        return MeasureUnitImpl();
+    }
+    umtx_atomic_inc(&gIdentifierCacheLookups);
+    const SharedMeasureUnitImpl *shared = nullptr;
+    cache->get(key, shared, status);
+    if (U_FAILURE(status)) {
+        return MeasureUnitImpl();
+    }
+    MeasureUnitImpl result = shared->impl.copy(status);
+    shared->removeRef();
+    return result;
+}
+
+void MeasureUnitImpl::getIdentifierCacheCounts(int32_t &hits, int32_t &misses) {
+    misses = umtx_loadAcquire(gIdentifierCacheMisses);
+    hits = umtx_loadAcquire(gIdentifierCacheLookups) - misses;
+}
+
 const MeasureUnitImpl& MeasureUnitImpl::forMeasureUnit(
         const MeasureUnit& measureUnit, MeasureUnitImpl& memory, UErrorCode& status) {
     if (measureUnit.fImpl) {
@@ -1066,7 +1274,7 @@ void MeasureUnitImpl::serialize(UErrorCode &status) {
     if (this->complexity == UMEASURE_UNIT_COMPOUND) {
         // Note: don't sort a MIXED unit
         uprv_sortArray(this->singleUnits.getAlias(), this->singleUnits.length(),
-                       sizeof(this->singleUnits[0]), compareSingleUnits, nullptr, false, &status);
+                       sizeof(SingleUnitImpl), compareSingleUnits, nullptr, false, &status);
         if (U_FAILURE(status)) {
             return;
         }
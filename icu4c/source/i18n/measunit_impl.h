@@ -37,6 +37,31 @@ static const char kDefaultCurrency8[] = "XXX";
  */
 CharString U_I18N_API getUnitQuantity(StringPiece baseUnitIdentifier, UErrorCode &status);
 
+/**
+ * Returns the number of simple units, such as "meter" or "fluid-ounce": the
+ * values of SingleUnitImpl::index range from 0 to this number minus one.
+ */
+int32_t U_I18N_API getSimpleUnitsCount(UErrorCode &status);
+
+/**
+ * Appends the identifiers of the base units of all unit categories, such as
+ * "meter" for "length" or "cubic-meter-per-meter" for "consumption", to
+ * `result`. Their categories can be looked up with getUnitQuantity().
+ */
+void U_I18N_API getCategoryBaseUnits(MaybeStackVector<CharString> &result, UErrorCode &status);
+
+namespace units {
+class PrebuiltUnitsDataBuilder;
+} // namespace units
+
+/**
+ * Builds the tables for parsing unit identifiers and looking up unit
+ * categories from the `units` resource, ignoring any units.icu, and adds them
+ * to `builder`. Used by the genunits tool.
+ */
+void U_I18N_API addUnitExtrasToPrebuiltData(units::PrebuiltUnitsDataBuilder &builder,
+                                            UErrorCode &status);
+
 /**
  * A struct representing a single unit (optional SI or binary prefix, and dimensionality).
  */
@@ -171,15 +196,81 @@ struct U_I18N_API SingleUnitImpl : public UMemory {
 // Forward declaration
 struct MeasureUnitImplWithIndex;
 
-// Export explicit template instantiations of MaybeStackArray, MemoryPool and
-// MaybeStackVector. This is required when building DLLs for Windows. (See
-// datefmt.h, collationiterator.h, erarules.h and others for similar examples.)
+// Export an explicit template instantiation of MaybeStackArray. This is
+// required when building DLLs for Windows. (See datefmt.h,
+// collationiterator.h, erarules.h and others for similar examples.)
 #if U_PF_WINDOWS <= U_PLATFORM && U_PLATFORM <= U_PF_CYGWIN
-template class U_I18N_API MaybeStackArray<SingleUnitImpl *, 8>;
-template class U_I18N_API MemoryPool<SingleUnitImpl, 8>;
-template class U_I18N_API MaybeStackVector<SingleUnitImpl, 8>;
+template class U_I18N_API MaybeStackArray<SingleUnitImpl, 4>;
 #endif
 
+/**
+ * The single units of a MeasureUnitImpl, stored by value in one contiguous
+ * array. Room for kInlineCapacity single units is reserved inside the object,
+ * which covers nearly all units: parsing, copying and combining those does not
+ * allocate memory per single unit, unlike with MaybeStackVector.
+ *
+ * Element access is the same as with MaybeStackVector: operator[] returns a
+ * pointer. Appending may move the elements, invalidating these pointers.
+ */
+class U_I18N_API SingleUnitVector : public UMemory {
+  public:
+    static constexpr int32_t kInlineCapacity = 4;
+
+    SingleUnitVector() = default;
+    SingleUnitVector(SingleUnitVector &&src) U_NOEXCEPT
+        : fArray(std::move(src.fArray)), fLength(src.fLength) {
+        src.fLength = 0;
+    }
+    SingleUnitVector &operator=(SingleUnitVector &&src) U_NOEXCEPT {
+        fArray = std::move(src.fArray);
+        fLength = src.fLength;
+        src.fLength = 0;
+        return *this;
+    }
+
+    int32_t length() const { return fLength; }
+
+    SingleUnitImpl *getAlias() { return fArray.getAlias(); }
+    const SingleUnitImpl *getAlias() const { return fArray.getAlias(); }
+
+    SingleUnitImpl *operator[](int32_t i) { return fArray.getAlias() + i; }
+    const SingleUnitImpl *operator[](int32_t i) const { return fArray.getAlias() + i; }
+
+    /**
+     * Appends a copy of `singleUnit`.
+     *
+     * @return A pointer to the new element, or nullptr if memory allocation
+     * failed.
+     */
+    SingleUnitImpl *emplaceBack(const SingleUnitImpl &singleUnit) {
+        if (fLength == fArray.getCapacity() && fArray.resize(2 * fLength, fLength) == nullptr) {
+            return nullptr;
+        }
+        SingleUnitImpl *result = fArray.getAlias() + fLength++;
+        *result = singleUnit;
+        return result;
+    }
+
+    /**
+     * Like emplaceBack(), but sets U_MEMORY_ALLOCATION_ERROR if memory
+     * allocation failed.
+     */
+    SingleUnitImpl *emplaceBackAndCheckErrorCode(UErrorCode &status, const SingleUnitImpl &singleUnit) {
+        if (U_FAILURE(status)) {
+            return nullptr;
+        }
+        SingleUnitImpl *result = emplaceBack(singleUnit);
+        if (result == nullptr) {
+            status = U_MEMORY_ALLOCATION_ERROR;
+        }
+        return result;
+    }
+
+  private:
+    MaybeStackArray<SingleUnitImpl, kInlineCapacity> fArray;
+    int32_t fLength = 0;
+};
+
 /**
  * Internal representation of measurement units. Capable of representing all complexities of units,
  * including mixed and compound units.
@@ -209,6 +300,27 @@ class U_I18N_API MeasureUnitImpl : public UMemory {
      */
     static MeasureUnitImpl forIdentifier(StringPiece identifier, UErrorCode& status);
 
+    /**
+     * Like forIdentifier(), but looks the identifier up in a cache of parsed
+     * identifiers first. The cache is part of the UnifiedCache: it is shared
+     * by all threads, and unused entries are evicted according to its
+     * eviction policy. Invalid identifiers are cached too.
+     *
+     * Worthwhile for callers that parse the same identifiers over and over.
+     *
+     * @param identifier The unit identifier string.
+     * @param status Set if the identifier string is not valid.
+     * @return A copy of the cached value object.
+     */
+    static MeasureUnitImpl forIdentifierCached(StringPiece identifier, UErrorCode& status);
+
+    /**
+     * Returns how many forIdentifierCached() calls found their identifier in
+     * the cache, and how many had to parse it, since the process started. The
+     * counters wrap around on overflow.
+     */
+    static void getIdentifierCacheCounts(int32_t &hits, int32_t &misses);
+
     /**
      * Extract the MeasureUnitImpl from a MeasureUnit, or parse if it is not present.
      * 
@@ -281,13 +393,20 @@ class U_I18N_API MeasureUnitImpl : public UMemory {
      * The "dimensionless" unit (SingleUnitImpl default constructor) must not be
      * added to this list.
      */
-    MaybeStackVector<SingleUnitImpl> singleUnits;
+    SingleUnitVector singleUnits;
 
     /**
      * The full unit identifier.  Owned by the MeasureUnitImpl.  Empty if not computed.
      */
     CharString identifier;
 
+    /**
+     * The hash code of the identifier, for MeasureUnit::hashCode() and
+     * operator==. Set by MeasureUnit when it takes ownership of this
+     * MeasureUnitImpl, 0 before that. Copied by copy().
+     */
+    int32_t identifierHash = 0;
+
   private:
     /**
      * Normalizes a MeasureUnitImpl and generate the identifier string in place.
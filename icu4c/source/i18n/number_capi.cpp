@@ -16,6 +16,7 @@
 #include "number_decnum.h"
 #include "unicode/numberformatter.h"
 #include "unicode/unumberformatter.h"
+#include "ustr_imp.h"
 
 using namespace icu;
 using namespace icu::number;
@@ -146,6 +147,26 @@ unumf_formatDecimal(const UNumberFormatter* uformatter, const char* value, int32
     formatter->fFormatter.formatImpl(&result->fData, *ec);
 }
 
+U_CAPI int32_t U_EXPORT2
+unumf_formatDoubleArray(const UNumberFormatter* uformatter, const double* values, int32_t count,
+                        UChar* buffer, int32_t bufferCapacity, int32_t* offsets, UErrorCode* ec) {
+    const UNumberFormatterData* formatter = UNumberFormatterData::validate(uformatter, *ec);
+    if (U_FAILURE(*ec)) { return 0; }
+
+    return formatter->fFormatter.formatDoubleArray(values, count, buffer, bufferCapacity, offsets, *ec);
+}
+
+U_CAPI int32_t U_EXPORT2
+unumf_formatDoubleArrayToUTF8(const UNumberFormatter* uformatter, const double* values,
+                              int32_t count, char* buffer, int32_t bufferCapacity, int32_t* offsets,
+                              UErrorCode* ec) {
+    const UNumberFormatterData* formatter = UNumberFormatterData::validate(uformatter, *ec);
+    if (U_FAILURE(*ec)) { return 0; }
+
+    return formatter->fFormatter.formatDoubleArrayToUTF8(values, count, buffer, bufferCapacity,
+                                                         offsets, *ec);
+}
+
 U_CAPI int32_t U_EXPORT2
 unumf_resultToString(const UFormattedNumber* uresult, UChar* buffer, int32_t bufferCapacity,
                      UErrorCode* ec) {
@@ -160,6 +181,25 @@ unumf_resultToString(const UFormattedNumber* uresult, UChar* buffer, int32_t buf
     return result->fData.toTempString(*ec).extract(buffer, bufferCapacity, *ec);
 }
 
+U_CAPI int32_t U_EXPORT2
+unumf_resultToUTF8(const UFormattedNumber* uresult, char* buffer, int32_t bufferCapacity,
+                   UErrorCode* ec) {
+    const auto* result = UFormattedNumberApiHelper::validate(uresult, *ec);
+    if (U_FAILURE(*ec)) { return 0; }
+
+    if (buffer == nullptr ? bufferCapacity != 0 : bufferCapacity < 0) {
+        *ec = U_ILLEGAL_ARGUMENT_ERROR;
+        return 0;
+    }
+
+    CheckedArrayByteSink sink(buffer, bufferCapacity);
+    result->fData.getStringRef().appendToUTF8(sink);
+    if (sink.Overflowed()) {
+        *ec = U_BUFFER_OVERFLOW_ERROR;
+    }
+    return u_terminateChars(buffer, bufferCapacity, sink.NumberOfBytesAppended(), ec);
+}
+
 U_CAPI UBool U_EXPORT2
 unumf_resultNextFieldPosition(const UFormattedNumber* uresult, UFieldPosition* ufpos, UErrorCode* ec) {
     const auto* result = UFormattedNumberApiHelper::validate(uresult, *ec);
@@ -17,6 +17,8 @@
 #include "number_decimalquantity.h"
 #include "number_roundingutils.h"
 #include "double-conversion.h"
+#include "double-conversion-bignum-dtoa.h"
+#include "double-conversion-fast-dtoa.h"
 #include "charstr.h"
 #include "number_utils.h"
 #include "uassert.h"
@@ -26,7 +28,10 @@ using namespace icu;
 using namespace icu::number;
 using namespace icu::number::impl;
 
+using icu::double_conversion::BignumDtoa;
 using icu::double_conversion::DoubleToStringConverter;
+using icu::double_conversion::FastDtoa;
+using icu::double_conversion::Vector;
 using icu::double_conversion::StringToDoubleConverter;
 
 namespace {
@@ -488,20 +493,16 @@ void DecimalQuantity::convertToAccurateDouble() {
     int32_t delta = origDelta;
 
     // Call the slow oracle function (Double.toString in Java, DoubleToAscii in C++).
-    char buffer[DoubleToStringConverter::kBase10MaximalLength + 1];
-    bool sign; // unused; always positive
-    int32_t length;
-    int32_t point;
-    DoubleToStringConverter::DoubleToAscii(
-        origDouble,
-        DoubleToStringConverter::DtoaMode::SHORTEST,
-        0,
-        buffer,
-        sizeof(buffer),
-        &sign,
-        &length,
-        &point
-    );
+    // origDouble is always positive and finite here, so call the shortest-digits algorithms
+    // directly instead of going through DoubleToAscii's sign and special-value handling:
+    // Grisu3 (FastDtoa) gives up on a small fraction of inputs, for which Bignum is exact.
+    char buffer[double_conversion::kFastDtoaMaximalLength + 1];
+    Vector<char> digits(buffer, UPRV_LENGTHOF(buffer));
+    int length;
+    int point;
+    if (!FastDtoa(origDouble, double_conversion::FAST_DTOA_SHORTEST, 0, digits, &length, &point)) {
+        BignumDtoa(origDouble, double_conversion::BIGNUM_DTOA_SHORTEST, 0, digits, &length, &point);
+    }
 
     setBcdToZero();
     readDoubleConversionToBcd(buffer, length, point);
@@ -634,6 +635,7 @@ DecNum& DecimalQuantity::toDecNum(DecNum& output, UErrorCode& status) const {
     // Special handling for zero
     if (precision == 0) {
         output.setTo("0", status);
+        return output;
     }
 
     // Use the BCD constructor. We need to do a little bit of work to convert, though.
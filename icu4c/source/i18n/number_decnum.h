@@ -52,6 +52,16 @@ class U_I18N_API DecNum : public UMemory {
 
     void divideBy(const DecNum& rhs, UErrorCode& status);
 
+    /** Adds rhs, rounding the result to the precision of this DecNum. */
+    void add(const DecNum& rhs, UErrorCode& status);
+
+    /**
+     * Makes the results of arithmetic on this DecNum keep up to `digits`
+     * significant digits, widening the storage if needed. Never reduces the
+     * precision; the value is unchanged.
+     */
+    void ensureCapacity(int32_t digits, UErrorCode& status);
+
     bool isNegative() const;
 
     bool isZero() const;
@@ -14,6 +14,9 @@
 #include "number_utils.h"
 #include "number_utypes.h"
 #include "number_mapper.h"
+#include "unicode/bytestream.h"
+#include "unicode/ustring.h"
+#include "ustr_imp.h"
 #include "util.h"
 #include "fphdlimp.h"
 
@@ -465,7 +468,7 @@ void LocalizedNumberFormatter::lnfMoveHelper(LNF&& src) {
     // Copy over the compiled formatter and set call count to INT32_MIN as in computeCompiled().
     // Don't copy the call count directly because doing so requires a loadAcquire/storeRelease.
     // The bits themselves appear to be platform-dependent, so copying them might not be safe.
-    delete fCompiled;
+    SharedObject::clearPtr(fCompiled);
     if (src.fCompiled != nullptr) {
         auto* callCount = reinterpret_cast<u_atomic_int32_t*>(fUnsafeCallCount);
         umtx_storeRelease(*callCount, INT32_MIN);
@@ -484,7 +487,7 @@ void LocalizedNumberFormatter::lnfMoveHelper(LNF&& src) {
 
 void LocalizedNumberFormatter::lnfCopyHelper(const LNF&, UErrorCode& status) {
     // When copying, always reset the compiled formatter.
-    delete fCompiled;
+    SharedObject::clearPtr(fCompiled);
     resetCompiled();
 
     // If MacroProps has a reference to AffixPatternProvider, we need to copy it.
@@ -513,7 +516,7 @@ void LocalizedNumberFormatter::lnfCopyHelper(const LNF&, UErrorCode& status) {
 
 
 LocalizedNumberFormatter::~LocalizedNumberFormatter() {
-    delete fCompiled;
+    SharedObject::clearPtr(fCompiled);
     delete fWarehouse;
 }
 
@@ -592,6 +595,133 @@ FormattedNumber LocalizedNumberFormatter::formatDecimal(StringPiece value, UErro
     }
 }
 
+namespace {
+
+// Appends the batch output of formatDoubleArray() to a char16_t buffer.
+class UTF16ArrayWriter {
+  public:
+    UTF16ArrayWriter(char16_t* dest, int32_t destCapacity) : fDest(dest), fCapacity(destCapacity) {}
+
+    int32_t length() const { return fLength; }
+
+    void append(const FormattedStringBuilder& string, UErrorCode& status) {
+        int32_t stringLength = string.length();
+        if (stringLength > INT32_MAX - fLength) {
+            status = U_INDEX_OUTOFBOUNDS_ERROR;
+            return;
+        }
+        if (stringLength <= fCapacity - fLength) {
+            u_memcpy(fDest + fLength, string.chars(), stringLength);
+        }
+        fLength += stringLength;
+    }
+
+  private:
+    char16_t* fDest;
+    int32_t fCapacity;
+    int32_t fLength = 0;
+};
+
+// Appends the batch output of formatDoubleArrayToUTF8() to a char buffer.
+class UTF8ArrayWriter {
+  public:
+    UTF8ArrayWriter(char* dest, int32_t destCapacity) : fSink(dest, destCapacity) {}
+
+    int32_t length() const { return fSink.NumberOfBytesAppended(); }
+
+    void append(const FormattedStringBuilder& string, UErrorCode& status) {
+        // A UTF-16 code unit takes at most 3 bytes in UTF-8.
+        if (string.length() > (INT32_MAX - length()) / 3) {
+            status = U_INDEX_OUTOFBOUNDS_ERROR;
+            return;
+        }
+        string.appendToUTF8(fSink);
+    }
+
+  private:
+    CheckedArrayByteSink fSink;
+};
+
+// Formats each value with one string builder and quantity, and appends the results to writer.
+// compiled is nullptr for the slow path.
+template<typename Writer>
+void formatDoubleArrayImpl(const NumberFormatterImpl* compiled, const MacroProps& macros,
+                           const double* values, int32_t count, int32_t* offsets, Writer& writer,
+                           UErrorCode& status) {
+    UFormattedNumberData results;
+    FormattedStringBuilder& string = results.getStringRef();
+    for (int32_t i = 0; i < count; i++) {
+        offsets[i] = writer.length();
+        string.clear();
+        results.quantity.setToDouble(values[i]);
+        if (compiled != nullptr) {
+            compiled->format(&results, status);
+        } else {
+            NumberFormatterImpl::formatStatic(macros, &results, status);
+        }
+        if (U_FAILURE(status)) { return; }
+        writer.append(string, status);
+        if (U_FAILURE(status)) { return; }
+    }
+    offsets[count] = writer.length();
+}
+
+} // namespace
+
+const NumberFormatterImpl*
+LocalizedNumberFormatter::getCompiledForArray(int32_t count, const NumberFormatterImpl*& tempCompiled,
+                                              UErrorCode& status) const {
+    // Use the compiled data structure for the whole batch. If the call count has not yet reached
+    // the threshold, get a temporary one: that is cheaper than the slow path for every value.
+    tempCompiled = nullptr;
+    if (computeCompiled(status)) {
+        return fCompiled;
+    } else if (fMacros.threshold > 0 && count > 1) {
+        return tempCompiled = NumberFormatterImpl::getInstance(fMacros, status);
+    }
+    return nullptr;
+}
+
+int32_t LocalizedNumberFormatter::formatDoubleArray(const double* values, int32_t count, char16_t* dest,
+                                                    int32_t destCapacity, int32_t* offsets,
+                                                    UErrorCode& status) const {
+    if (U_FAILURE(status)) { return 0; }
+    if (count < 0 || (values == nullptr && count > 0) || offsets == nullptr ||
+            destCapacity < 0 || (dest == nullptr && destCapacity > 0)) {
+        status = U_ILLEGAL_ARGUMENT_ERROR;
+        return 0;
+    }
+
+    const NumberFormatterImpl* tempCompiled;
+    const NumberFormatterImpl* compiled = getCompiledForArray(count, tempCompiled, status);
+    if (U_FAILURE(status)) { return 0; }
+    UTF16ArrayWriter writer(dest, destCapacity);
+    formatDoubleArrayImpl(compiled, fMacros, values, count, offsets, writer, status);
+    SharedObject::clearPtr(tempCompiled);
+    if (U_FAILURE(status)) { return 0; }
+    return u_terminateUChars(dest, destCapacity, writer.length(), &status);
+}
+
+int32_t LocalizedNumberFormatter::formatDoubleArrayToUTF8(const double* values, int32_t count,
+                                                          char* dest, int32_t destCapacity,
+                                                          int32_t* offsets, UErrorCode& status) const {
+    if (U_FAILURE(status)) { return 0; }
+    if (count < 0 || (values == nullptr && count > 0) || offsets == nullptr ||
+            destCapacity < 0 || (dest == nullptr && destCapacity > 0)) {
+        status = U_ILLEGAL_ARGUMENT_ERROR;
+        return 0;
+    }
+
+    const NumberFormatterImpl* tempCompiled;
+    const NumberFormatterImpl* compiled = getCompiledForArray(count, tempCompiled, status);
+    if (U_FAILURE(status)) { return 0; }
+    UTF8ArrayWriter writer(dest, destCapacity);
+    formatDoubleArrayImpl(compiled, fMacros, values, count, offsets, writer, status);
+    SharedObject::clearPtr(tempCompiled);
+    if (U_FAILURE(status)) { return 0; }
+    return u_terminateChars(dest, destCapacity, writer.length(), &status);
+}
+
 FormattedNumber
 LocalizedNumberFormatter::formatDecimalQuantity(const DecimalQuantity& dq, UErrorCode& status) const {
     if (U_FAILURE(status)) { return FormattedNumber(U_ILLEGAL_ARGUMENT_ERROR); }
@@ -666,10 +796,9 @@ bool LocalizedNumberFormatter::computeCompiled(UErrorCode& status) const {
     }
 
     if (currentCount == fMacros.threshold && fMacros.threshold > 0) {
-        // Build the data structure and then use it (slow to fast path).
-        const NumberFormatterImpl* compiled = new NumberFormatterImpl(fMacros, status);
+        // Build the data structure, or get it from the cache, and then use it (slow to fast path).
+        const NumberFormatterImpl* compiled = NumberFormatterImpl::getInstance(fMacros, status);
         if (compiled == nullptr) {
-            status = U_MEMORY_ALLOCATION_ERROR;
             return false;
         }
         U_ASSERT(fCompiled == nullptr);
@@ -15,20 +15,256 @@
 #include "number_utils.h"
 #include "unicode/numberformatter.h"
 #include "unicode/dcfmtsym.h"
+#include "unicode/numsys.h"
 #include "number_scientific.h"
 #include "number_compact.h"
 #include "uresimp.h"
 #include "ureslocs.h"
+#include "unifiedcache.h"
+#include "util.h"
 
 using namespace icu;
 using namespace icu::number;
 using namespace icu::number::impl;
 
 
+namespace {
+
+// Cache key for shared NumberFormatterImpls: the locale and the key from getCacheKey().
+// The MacroProps to build the NumberFormatterImpl from are the creation context.
+class NumberFormatterImplCacheKey : public CacheKey<NumberFormatterImpl> {
+  public:
+    NumberFormatterImplCacheKey(const Locale& locale, const UnicodeString& settings)
+        : fLocale(locale), fSettings(settings) {}
+    NumberFormatterImplCacheKey(const NumberFormatterImplCacheKey& other)
+        : CacheKey<NumberFormatterImpl>(other), fLocale(other.fLocale), fSettings(other.fSettings) {}
+    virtual ~NumberFormatterImplCacheKey();
+
+    virtual int32_t hashCode() const {
+        uint32_t hash = (uint32_t)CacheKey<NumberFormatterImpl>::hashCode();
+        hash = 37u * hash + (uint32_t)fLocale.hashCode();
+        hash = 37u * hash + (uint32_t)fSettings.hashCode();
+        return (int32_t)hash;
+    }
+    virtual UBool operator==(const CacheKeyBase& other) const {
+        if (this == &other) {
+            return TRUE;
+        }
+        if (!CacheKey<NumberFormatterImpl>::operator==(other)) {
+            return FALSE;
+        }
+        // We know that this and other are of same class if we get this far.
+        const auto& realOther = static_cast<const NumberFormatterImplCacheKey&>(other);
+        return realOther.fLocale == fLocale && realOther.fSettings == fSettings;
+    }
+    virtual CacheKeyBase* clone() const {
+        return new NumberFormatterImplCacheKey(*this);
+    }
+    virtual const NumberFormatterImpl* createObject(const void* creationContext,
+                                                    UErrorCode& status) const {
+        const auto* macros = static_cast<const MacroProps*>(creationContext);
+        LocalPointer<NumberFormatterImpl> result(new NumberFormatterImpl(*macros, status), status);
+        if (U_FAILURE(status)) {
+            return nullptr;
+        }
+        result->addRef();
+        return result.orphan();
+    }
+    virtual char* writeDescription(char* buffer, int32_t bufLen) const {
+        CharString description;
+        UErrorCode localStatus = U_ZERO_ERROR;
+        description.append(fLocale.getName(), localStatus)
+            .append(':', localStatus)
+            .appendInvariantChars(fSettings, localStatus);
+        uprv_strncpy(buffer, description.data(), bufLen);
+        buffer[bufLen - 1] = 0;
+        return buffer;
+    }
+
+  private:
+    Locale fLocale;
+    UnicodeString fSettings;
+};
+
+NumberFormatterImplCacheKey::~NumberFormatterImplCacheKey() {}
+
+} // namespace
+
 NumberFormatterImpl::NumberFormatterImpl(const MacroProps& macros, UErrorCode& status)
     : NumberFormatterImpl(macros, true, status) {
 }
 
+NumberFormatterImpl::~NumberFormatterImpl() {}
+
+const NumberFormatterImpl* NumberFormatterImpl::getInstance(const MacroProps& macros,
+                                                            UErrorCode& status) {
+    if (U_FAILURE(status)) {
+        return nullptr;
+    }
+    UnicodeString settings;
+    if (getCacheKey(macros, settings)) {
+        const UnifiedCache* cache = UnifiedCache::getInstance(status);
+        if (U_FAILURE(status)) {
+            return nullptr;
+        }
+        NumberFormatterImplCacheKey key(macros.locale, settings);
+        const NumberFormatterImpl* result = nullptr;
+        cache->get(key, &macros, result, status);
+        return result;
+    }
+    LocalPointer<NumberFormatterImpl> result(new NumberFormatterImpl(macros, status), status);
+    if (U_FAILURE(status)) {
+        return nullptr;
+    }
+    result->addRef();
+    return result.orphan();
+}
+
+namespace {
+
+// The digits of 0 to 99, two per value, for converting integers two digits at a time.
+const char kDigitPairs[] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+// The fast path handles integer parts that fit into a uint64_t, and the grouping separators of all
+// locales.
+constexpr int32_t kMaxFastIntegerDigits = 18;
+constexpr int32_t kMaxFastGroupingSeparatorLength = 4;
+
+void appendKeyNumber(UnicodeString& key, int32_t n) {
+    ICU_Utility::appendNumber(key, n).append(u',');
+}
+
+void appendKeyString(UnicodeString& key, const char* s) {
+    key.append(UnicodeString(s, -1, US_INV)).append(u',');
+}
+
+void appendKeyUnit(UnicodeString& key, const MeasureUnit& unit) {
+    appendKeyString(key, unit.getType());
+    appendKeyString(key, unit.getIdentifier());
+}
+
+} // namespace
+
+bool NumberFormatterImpl::getCacheKey(const MacroProps& macros, UnicodeString& key) {
+    UErrorCode localStatus = U_ZERO_ERROR;
+    if (macros.copyErrorTo(localStatus)) {
+        return false;
+    }
+    // Objects owned by the caller, and custom symbols, are not part of the key.
+    if (macros.affixProvider != nullptr || macros.rules != nullptr ||
+            macros.symbols.isDecimalFormatSymbols() || macros.scale.fArbitrary != nullptr) {
+        return false;
+    }
+    key.remove();
+
+    const Notation& notation = macros.notation;
+    appendKeyNumber(key, notation.fType);
+    if (notation.fType == Notation::NTN_SCIENTIFIC) {
+        const Notation::ScientificSettings& settings = notation.fUnion.scientific;
+        appendKeyNumber(key, settings.fEngineeringInterval);
+        appendKeyNumber(key, settings.fRequireMinInt);
+        appendKeyNumber(key, settings.fMinExponentDigits);
+        appendKeyNumber(key, settings.fExponentSignDisplay);
+    } else if (notation.fType == Notation::NTN_COMPACT) {
+        appendKeyNumber(key, notation.fUnion.compactStyle);
+    }
+
+    appendKeyUnit(key, macros.unit);
+    appendKeyUnit(key, macros.perUnit);
+
+    const Precision& precision = macros.precision;
+    appendKeyNumber(key, precision.fType);
+    switch (precision.fType) {
+        case Precision::RND_FRACTION:
+        case Precision::RND_SIGNIFICANT:
+        case Precision::RND_FRACTION_SIGNIFICANT:
+            appendKeyNumber(key, precision.fUnion.fracSig.fMinFrac);
+            appendKeyNumber(key, precision.fUnion.fracSig.fMaxFrac);
+            appendKeyNumber(key, precision.fUnion.fracSig.fMinSig);
+            appendKeyNumber(key, precision.fUnion.fracSig.fMaxSig);
+            // The priority is set only when both are present.
+            if (precision.fType == Precision::RND_FRACTION_SIGNIFICANT) {
+                appendKeyNumber(key, precision.fUnion.fracSig.fPriority);
+            }
+            break;
+        case Precision::RND_INCREMENT:
+        case Precision::RND_INCREMENT_ONE:
+        case Precision::RND_INCREMENT_FIVE: {
+            // The exact bits of the increment, in 16-bit pieces.
+            uint16_t pieces[sizeof(double) / sizeof(uint16_t)];
+            uprv_memcpy(pieces, &precision.fUnion.increment.fIncrement, sizeof(double));
+            for (uint16_t piece : pieces) {
+                appendKeyNumber(key, piece);
+            }
+            appendKeyNumber(key, precision.fUnion.increment.fMinFrac);
+            appendKeyNumber(key, precision.fUnion.increment.fMaxFrac);
+            break;
+        }
+        case Precision::RND_CURRENCY:
+            appendKeyNumber(key, precision.fUnion.currencyUsage);
+            break;
+        default:
+            break;
+    }
+    appendKeyNumber(key, precision.fTrailingZeroDisplay);
+    appendKeyNumber(key, macros.roundingMode);
+
+    const Grouper& grouper = macros.grouper;
+    if (grouper.isBogus()) {
+        key.append(u"-,", -1);
+    } else {
+        appendKeyNumber(key, grouper.fGrouping1);
+        appendKeyNumber(key, grouper.fGrouping2);
+        appendKeyNumber(key, grouper.fMinGrouping);
+        appendKeyNumber(key, grouper.fStrategy);
+    }
+
+    const Padder& padder = macros.padder;
+    appendKeyNumber(key, padder.fWidth);
+    if (padder.fWidth > 0) {
+        appendKeyNumber(key, padder.fUnion.padding.fCp);
+        appendKeyNumber(key, padder.fUnion.padding.fPosition);
+    }
+
+    const IntegerWidth& integerWidth = macros.integerWidth;
+    if (integerWidth.isBogus()) {
+        key.append(u"-,", -1);
+    } else {
+        appendKeyNumber(key, integerWidth.fUnion.minMaxInt.fMinInt);
+        appendKeyNumber(key, integerWidth.fUnion.minMaxInt.fMaxInt);
+        appendKeyNumber(key, integerWidth.fUnion.minMaxInt.fFormatFailIfMoreThanMaxDigits);
+    }
+
+    if (macros.symbols.isNumberingSystem()) {
+        const NumberingSystem* ns = macros.symbols.getNumberingSystem();
+        appendKeyString(key, ns->getName());
+        appendKeyNumber(key, ns->getRadix());
+        appendKeyNumber(key, ns->isAlgorithmic());
+        key.append(ns->getDescription()).append(u',');
+    } else {
+        key.append(u"-,", -1);
+    }
+
+    appendKeyNumber(key, macros.unitWidth);
+    appendKeyNumber(key, macros.sign);
+    appendKeyNumber(key, macros.decimal);
+    appendKeyNumber(key, macros.scale.fMagnitude);
+    // StringProp values are invariant-character identifiers.
+    appendKeyString(key, macros.usage.isSet() ? macros.usage.fValue : "");
+    appendKeyString(key, macros.unitDisplayCase.isSet() ? macros.unitDisplayCase.fValue : "");
+    return true;
+}
+
 int32_t NumberFormatterImpl::formatStatic(const MacroProps &macros, UFormattedNumberData *results,
                                           UErrorCode &status) {
     DecimalQuantity &inValue = results->quantity;
@@ -331,6 +567,12 @@ NumberFormatterImpl::macrosToMicroGenerator(const MacroProps& macros, bool safe,
     // Use monetary separator symbols
     fMicros.useCurrency = isCurrency;
 
+    // Integer digits can be converted in one go if each digit is a single code unit. The other notations
+    // give the quantity an exponent, which the digits to display do not include.
+    UChar32 codePointZero = fMicros.symbols->getCodePointZero();
+    fMicros.fastIntegerDigits = macros.notation.fType == Notation::NTN_SIMPLE
+            && codePointZero != -1 && codePointZero + 9 <= 0xffff;
+
     // Inner modifier (scientific notation)
     if (macros.notation.fType == Notation::NTN_SCIENTIFIC) {
         auto newScientificHandler = new ScientificHandler(&macros.notation, fMicros.symbols, chain);
@@ -558,15 +800,22 @@ int32_t NumberFormatterImpl::writeIntegerDigits(const MicroProps& micros, Decima
                                                 UErrorCode& status) {
     int length = 0;
     int integerCount = quantity.getUpperDisplayMagnitude() + 1;
+    const UnicodeString& groupingSeparator = micros.useCurrency
+            ? micros.symbols->getSymbol(
+                    DecimalFormatSymbols::ENumberFormatSymbol::kMonetaryGroupingSeparatorSymbol)
+            : micros.symbols->getSymbol(
+                    DecimalFormatSymbols::ENumberFormatSymbol::kGroupingSeparatorSymbol);
+    if (micros.fastIntegerDigits && integerCount <= kMaxFastIntegerDigits &&
+            groupingSeparator.length() <= kMaxFastGroupingSeparatorLength) {
+        return writeIntegerDigitsFast(
+            micros, quantity, integerCount, groupingSeparator, string, index, status);
+    }
     for (int i = 0; i < integerCount; i++) {
         // Add grouping separator
         if (micros.grouping.groupAtPosition(i, quantity)) {
             length += string.insert(
                     index,
-                    micros.useCurrency ? micros.symbols->getSymbol(
-                            DecimalFormatSymbols::ENumberFormatSymbol::kMonetaryGroupingSeparatorSymbol)
-                                       : micros.symbols->getSymbol(
-                            DecimalFormatSymbols::ENumberFormatSymbol::kGroupingSeparatorSymbol),
+                    groupingSeparator,
                     {UFIELD_CATEGORY_NUMBER, UNUM_GROUPING_SEPARATOR_FIELD},
                     status);
         }
@@ -585,6 +834,62 @@ int32_t NumberFormatterImpl::writeIntegerDigits(const MicroProps& micros, Decima
     return length;
 }
 
+int32_t NumberFormatterImpl::writeIntegerDigitsFast(const MicroProps& micros, DecimalQuantity& quantity,
+                                                    int32_t integerCount,
+                                                    const UnicodeString& groupingSeparator,
+                                                    FormattedStringBuilder& string, int32_t index,
+                                                    UErrorCode& status) {
+    U_ASSERT(micros.fastIntegerDigits && integerCount <= kMaxFastIntegerDigits);
+
+    // The digits of the integer part, least significant first, followed by leading zeros.
+    // With simple notation, the quantity has no exponent, so these are the digits to display.
+    char digits[kMaxFastIntegerDigits];
+    int64_t signedValue = quantity.toLong(true);
+    uint64_t value = quantity.isNegative() ? 0 - static_cast<uint64_t>(signedValue)
+                                           : static_cast<uint64_t>(signedValue);
+    int32_t digitCount = 0;
+    while (value >= 100) {
+        int32_t pair = static_cast<int32_t>(value % 100) * 2;
+        value /= 100;
+        digits[digitCount++] = kDigitPairs[pair + 1];
+        digits[digitCount++] = kDigitPairs[pair];
+    }
+    if (value >= 10) {
+        int32_t pair = static_cast<int32_t>(value) * 2;
+        digits[digitCount++] = kDigitPairs[pair + 1];
+        digits[digitCount++] = kDigitPairs[pair];
+    } else if (value > 0) {
+        digits[digitCount++] = static_cast<char>('0' + value);
+    }
+    while (digitCount < integerCount) {
+        digits[digitCount++] = '0';
+    }
+
+    // Same as Grouper::groupAtPosition(), with the tests that do not depend on the position hoisted.
+    const Grouper& grouper = micros.grouping;
+    int32_t grouping1 = grouper.fGrouping1;
+    int32_t grouping2 = grouper.fGrouping2;
+    bool grouped = grouping1 > 0 && integerCount - grouping1 >= grouper.fMinGrouping;
+
+    char16_t chars[kMaxFastIntegerDigits * (1 + kMaxFastGroupingSeparatorLength)];
+    Field fields[kMaxFastIntegerDigits * (1 + kMaxFastGroupingSeparatorLength)];
+    const Field integerField = {UFIELD_CATEGORY_NUMBER, UNUM_INTEGER_FIELD};
+    const Field groupingField = {UFIELD_CATEGORY_NUMBER, UNUM_GROUPING_SEPARATOR_FIELD};
+    const char16_t zero = static_cast<char16_t>(micros.symbols->getCodePointZero());
+    int32_t length = 0;
+    for (int32_t i = integerCount - 1; i >= 0; i--) {
+        chars[length] = static_cast<char16_t>(zero + (digits[i] - '0'));
+        fields[length++] = integerField;
+        if (grouped && i >= grouping1 && (i - grouping1) % grouping2 == 0) {
+            for (int32_t j = 0; j < groupingSeparator.length(); j++) {
+                chars[length] = groupingSeparator.charAt(j);
+                fields[length++] = groupingField;
+            }
+        }
+    }
+    return string.insert(index, chars, fields, length, status);
+}
+
 int32_t NumberFormatterImpl::writeFractionDigits(const MicroProps& micros, DecimalQuantity& quantity,
                                                  FormattedStringBuilder& string, int32_t index,
                                                  UErrorCode& status) {
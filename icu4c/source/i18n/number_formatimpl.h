@@ -17,6 +17,7 @@
 #include "number_compact.h"
 #include "number_microprops.h"
 #include "number_utypes.h"
+#include "sharedobject.h"
 
 U_NAMESPACE_BEGIN namespace number {
 namespace impl {
@@ -25,7 +26,7 @@ namespace impl {
  * This is the "brain" of the number formatting pipeline. It ties all the pieces together, taking in a MacroProps and a
  * DecimalQuantity and outputting a properly formatted number string.
  */
-class NumberFormatterImpl : public UMemory {
+class NumberFormatterImpl : public SharedObject {
   public:
     /**
      * Builds a "safe" MicroPropsGenerator, which is thread-safe and can be used repeatedly.
@@ -33,6 +34,15 @@ class NumberFormatterImpl : public UMemory {
      */
     NumberFormatterImpl(const MacroProps &macros, UErrorCode &status);
 
+    virtual ~NumberFormatterImpl();
+
+    /**
+     * Returns a "safe" NumberFormatterImpl for the macros, with a reference added for the caller;
+     * release it with removeRef(). All callers with the same settings and locale share one instance
+     * through the UnifiedCache, unless the settings reference objects owned by the caller.
+     */
+    static const NumberFormatterImpl *getInstance(const MacroProps &macros, UErrorCode &status);
+
     /**
      * Builds and evaluates an "unsafe" MicroPropsGenerator, which is cheaper but can be used only once.
      */
@@ -149,9 +159,25 @@ class NumberFormatterImpl : public UMemory {
     writeIntegerDigits(const MicroProps &micros, DecimalQuantity &quantity, FormattedStringBuilder &string,
                        int32_t index, UErrorCode &status);
 
+    /**
+     * Writes integerCount integer digits into a local buffer two at a time, and inserts them into the
+     * string at once. Requires micros.fastIntegerDigits.
+     */
+    static int32_t
+    writeIntegerDigitsFast(const MicroProps &micros, DecimalQuantity &quantity, int32_t integerCount,
+                           const UnicodeString &groupingSeparator, FormattedStringBuilder &string,
+                           int32_t index, UErrorCode &status);
+
     static int32_t
     writeFractionDigits(const MicroProps &micros, DecimalQuantity &quantity, FormattedStringBuilder &string,
                         int32_t index, UErrorCode &status);
+
+    /**
+     * Sets key to a string that determines the NumberFormatterImpl built from the macros, apart from the
+     * locale. Returns false if the macros cannot be shared, for example with custom symbols or with the
+     * affix provider of DecimalFormat.
+     */
+    static bool getCacheKey(const MacroProps &macros, UnicodeString &key);
 };
 
 }  // namespace impl
@@ -17,6 +17,11 @@
 #include "number_microprops.h"
 #include <algorithm>
 #include "cstring.h"
+#include "mutex.h"
+#include "sharedobject.h"
+#include "umutex.h"
+#include "unifiedcache.h"
+#include "ustr_imp.h"
 #include "util.h"
 
 using namespace icu;
@@ -431,12 +436,12 @@ class PluralTableSink : public ResourceSink {
  *     (For any missing case-specific data, we fall back to nominative.)
  * @param outArray must be of fixed length ARRAY_LENGTH.
  */
-void getMeasureData(const Locale &locale,
-                    const MeasureUnit &unit,
-                    const UNumberUnitWidth &width,
-                    const char *unitDisplayCase,
-                    UnicodeString *outArray,
-                    UErrorCode &status) {
+void loadMeasureData(const Locale &locale,
+                     const MeasureUnit &unit,
+                     const UNumberUnitWidth &width,
+                     const char *unitDisplayCase,
+                     UnicodeString *outArray,
+                     UErrorCode &status) {
     PluralTableSink sink(outArray);
     LocalUResourceBundlePointer unitsBundle(ures_open(U_ICUDATA_UNIT, locale.getName(), &status));
     if (U_FAILURE(status)) { return; }
@@ -515,6 +520,159 @@ void getMeasureData(const Locale &locale,
     ures_getAllItemsWithFallback(unitsBundle.getAlias(), key.data(), sink, status);
 }
 
+// Counters for LongNameHandler::getMeasureDataCacheStats(). They are only
+// statistics and do not order other memory accesses, so they are updated and
+// read with relaxed atomic operations.
+u_atomic_int32_t gMeasureDataLookups {};
+u_atomic_int32_t gMeasureDataMisses {};
+u_atomic_int32_t gMeasureDataBytes {};
+
+// The outArray of loadMeasureData(), as stored in the UnifiedCache: the raw
+// pattern strings. Each LongNameHandler compiles the ones it uses into
+// SimpleFormatters when it is constructed.
+class SharedMeasureData : public SharedObject {
+  public:
+    UnicodeString patterns[ARRAY_LENGTH];
+
+    SharedMeasureData() {}
+    virtual ~SharedMeasureData();
+
+    // Adds the approximate memory used by this object to gMeasureDataBytes.
+    // Call once, after populating `patterns`.
+    void account() {
+        fBytes = static_cast<int32_t>(sizeof(*this));
+        for (const UnicodeString &pattern : patterns) {
+            fBytes += pattern.length() * U_SIZEOF_UCHAR;
+        }
+        gMeasureDataBytes.fetch_add(fBytes, std::memory_order_relaxed);
+    }
+
+  private:
+    int32_t fBytes = 0;
+};
+
+SharedMeasureData::~SharedMeasureData() {
+    gMeasureDataBytes.fetch_sub(fBytes, std::memory_order_relaxed);
+}
+
+// Cache key for the display data of one unit, for one locale, width and case.
+class MeasureDataCacheKey : public CacheKey<SharedMeasureData> {
+  public:
+    MeasureDataCacheKey(const Locale &locale, const MeasureUnit &unit, UNumberUnitWidth width,
+                        const char *unitDisplayCase, UErrorCode &status)
+        : fLocale(locale), fUnit(unit), fWidth(width) {
+        fUnitDisplayCase.append(unitDisplayCase, status);
+    }
+    MeasureDataCacheKey(const MeasureDataCacheKey &other)
+        : CacheKey<SharedMeasureData>(other), fLocale(other.fLocale), fUnit(other.fUnit),
+          fWidth(other.fWidth) {
+        UErrorCode localStatus = U_ZERO_ERROR;
+        fUnitDisplayCase.append(other.fUnitDisplayCase, localStatus);
+    }
+    virtual ~MeasureDataCacheKey();
+
+    virtual int32_t hashCode() const {
+        const char *unit = fUnit.getIdentifier();
+        uint32_t hash = (uint32_t)CacheKey<SharedMeasureData>::hashCode();
+        hash = 37u * hash + (uint32_t)fLocale.hashCode();
+        hash = 37u * hash + (uint32_t)ustr_hashCharsN(unit, (int32_t)uprv_strlen(unit));
+        hash = 37u * hash + (uint32_t)fWidth;
+        hash = 37u * hash + (uint32_t)ustr_hashCharsN(fUnitDisplayCase.data(),
+                                                      fUnitDisplayCase.length());
+        return (int32_t)hash;
+    }
+    virtual UBool operator==(const CacheKeyBase &other) const {
+        if (this == &other) {
+            return TRUE;
+        }
+        if (!CacheKey<SharedMeasureData>::operator==(other)) {
+            return FALSE;
+        }
+        // We know that this and other are of same class if we get this far.
+        const MeasureDataCacheKey &realOther = static_cast<const MeasureDataCacheKey &>(other);
+        return realOther.fLocale == fLocale && realOther.fUnit == fUnit &&
+               realOther.fWidth == fWidth &&
+               realOther.fUnitDisplayCase.toStringPiece() == fUnitDisplayCase.toStringPiece();
+    }
+    virtual CacheKeyBase *clone() const {
+        return new MeasureDataCacheKey(*this);
+    }
+    virtual const SharedMeasureData *createObject(const void * /*unused*/,
+                                                  UErrorCode &status) const {
+        gMeasureDataMisses.fetch_add(1, std::memory_order_relaxed);
+        LocalPointer<SharedMeasureData> result(new SharedMeasureData(), status);
+        if (U_FAILURE(status)) {
+            return nullptr;
+        }
+        loadMeasureData(fLocale, fUnit, fWidth, fUnitDisplayCase.data(), result->patterns, status);
+        if (U_FAILURE(status)) {
+            return nullptr;
+        }
+        result->account();
+        result->addRef();
+        return result.orphan();
+    }
+    virtual char *writeDescription(char *buffer, int32_t bufLen) const {
+        CharString description;
+        UErrorCode localStatus = U_ZERO_ERROR;
+        description.append(fLocale.getName(), localStatus)
+            .append(':', localStatus)
+            .append(fUnit.getIdentifier(), localStatus)
+            .append(':', localStatus)
+            .appendNumber(fWidth, localStatus)
+            .append(':', localStatus)
+            .append(fUnitDisplayCase, localStatus);
+        uprv_strncpy(buffer, description.data(), bufLen);
+        buffer[bufLen - 1] = 0;
+        return buffer;
+    }
+
+  private:
+    Locale fLocale;
+    MeasureUnit fUnit;
+    UNumberUnitWidth fWidth;
+    CharString fUnitDisplayCase;
+};
+
+MeasureDataCacheKey::~MeasureDataCacheKey() {}
+
+/**
+ * Like loadMeasureData(), but shares the data through the UnifiedCache, so
+ * that the resource bundles are only read once per locale, unit, width and
+ * case. Unused entries are evicted according to the UnifiedCache's eviction
+ * policy.
+ */
+void getMeasureData(const Locale &locale,
+                    const MeasureUnit &unit,
+                    const UNumberUnitWidth &width,
+                    const char *unitDisplayCase,
+                    UnicodeString *outArray,
+                    UErrorCode &status) {
+    if (U_FAILURE(status)) {
+        return;
+    }
+    const UnifiedCache *cache = UnifiedCache::getInstance(status);
+    MeasureDataCacheKey key(locale, unit, width, unitDisplayCase, status);
+    if (U_FAILURE(status)) {
+        return;
+    }
+    gMeasureDataLookups.fetch_add(1, std::memory_order_relaxed);
+    UErrorCode localStatus = U_ZERO_ERROR;
+    const SharedMeasureData *shared = nullptr;
+    cache->get(key, shared, localStatus);
+    // Keep any warning, such as U_USING_DEFAULT_WARNING from ures_open().
+    if (U_FAILURE(localStatus) || status == U_ZERO_ERROR) {
+        status = localStatus;
+    }
+    if (U_FAILURE(status)) {
+        return;
+    }
+    for (int32_t i = 0; i < ARRAY_LENGTH; i++) {
+        outArray[i] = shared->patterns[i];
+    }
+    shared->removeRef();
+}
+
 // NOTE: outArray MUST have a length of at least ARRAY_LENGTH.
 void getCurrencyLongNameData(const Locale &locale, const CurrencyUnit &currency, UnicodeString *outArray,
                              UErrorCode &status) {
@@ -1459,6 +1617,12 @@ UnicodeString LongNameHandler::getUnitDisplayName(
     return simpleFormats[DNAM_INDEX];
 }
 
+void LongNameHandler::getMeasureDataCacheStats(int32_t &hits, int32_t &misses, int32_t &bytes) {
+    misses = gMeasureDataMisses.load(std::memory_order_relaxed);
+    hits = gMeasureDataLookups.load(std::memory_order_relaxed) - misses;
+    bytes = gMeasureDataBytes.load(std::memory_order_relaxed);
+}
+
 UnicodeString LongNameHandler::getUnitPattern(
         const Locale& loc,
         const MeasureUnit& unit,
@@ -1713,53 +1877,104 @@ LongNameMultiplexer *LongNameMultiplexer::forMeasureUnits(const Locale &loc,
                                                           const PluralRules *rules,
                                                           const MicroPropsGenerator *parent,
                                                           UErrorCode &status) {
-    LocalPointer<LongNameMultiplexer> result(new LongNameMultiplexer(parent), status);
+    LocalPointer<LongNameMultiplexer> result(new LongNameMultiplexer(loc, width, rules, parent),
+                                             status);
     if (U_FAILURE(status)) {
         return nullptr;
     }
     U_ASSERT(units.length() > 0);
-    if (result->fHandlers.resize(units.length()) == nullptr) {
+    int32_t length = units.length();
+    if (result->fHandlers.resize(length) == nullptr) {
         status = U_MEMORY_ALLOCATION_ERROR;
         return nullptr;
     }
-    result->fMeasureUnits.adoptInstead(new MeasureUnit[units.length()]);
-    for (int32_t i = 0, length = units.length(); i < length; i++) {
-        const MeasureUnit &unit = *units[i];
-        result->fMeasureUnits[i] = unit;
-        if (unit.getComplexity(status) == UMEASURE_UNIT_MIXED) {
-            MixedUnitLongNameHandler *mlnh = result->fMixedUnitHandlers.createAndCheckErrorCode(status);
-            MixedUnitLongNameHandler::forMeasureUnit(loc, unit, width, unitDisplayCase, rules, NULL,
-                                                     mlnh, status);
-            result->fHandlers[i] = mlnh;
-        } else {
-            LongNameHandler *lnh = result->fLongNameHandlers.createAndCheckErrorCode(status);
-            LongNameHandler::forMeasureUnit(loc, unit, width, unitDisplayCase, rules, NULL, lnh, status);
-            result->fHandlers[i] = lnh;
-        }
-        if (U_FAILURE(status)) {
-            return nullptr;
-        }
+    result->fMeasureUnits.adoptInstead(new MeasureUnit[length]);
+    result->fHandlerStates.adoptInstead(new HandlerState[length]);
+    if (result->fMeasureUnits.isNull() || result->fHandlerStates.isNull()) {
+        status = U_MEMORY_ALLOCATION_ERROR;
+        return nullptr;
+    }
+    result->fUnitDisplayCase.append(unitDisplayCase, status);
+    for (int32_t i = 0; i < length; i++) {
+        result->fMeasureUnits[i] = *units[i];
+        result->fHandlers[i] = nullptr;
+        umtx_storeRelease(result->fHandlerStates[i].fState, 0);
+    }
+    result->fLength = length;
+    if (U_FAILURE(status)) {
+        return nullptr;
     }
     return result.orphan();
 }
 
+LongNameMultiplexer::~LongNameMultiplexer() {
+    for (int32_t i = 0; i < fLength; i++) {
+        delete fHandlers[i];
+    }
+}
+
+// Serializes the building of LongNameMultiplexer handlers. Building is rare:
+// at most once per output unit of each multiplexer.
+static UMutex gLongNameMultiplexerMutex;
+
+const MicroPropsGenerator *LongNameMultiplexer::getHandler(int32_t i, UErrorCode &status) const {
+    // As in LocalizedNumberFormatter::computeCompiled(), a negative state
+    // means that the handler is built and published (fast path). Unlike there,
+    // a thread that does not build the handler cannot fall back to a temporary
+    // one, since the MicroProps keep pointers into it: it waits for the
+    // building thread instead.
+    if (umtx_loadAcquire(fHandlerStates[i].fState) < 0) {
+        return fHandlers[i];
+    }
+    Mutex lock(&gLongNameMultiplexerMutex);
+    if (umtx_loadAcquire(fHandlerStates[i].fState) < 0) {
+        // Another thread built it while we waited.
+        return fHandlers[i];
+    }
+    const MeasureUnit &unit = fMeasureUnits[i];
+    LocalPointer<MicroPropsGenerator> handler;
+    if (unit.getComplexity(status) == UMEASURE_UNIT_MIXED) {
+        LocalPointer<MixedUnitLongNameHandler> mlnh(new MixedUnitLongNameHandler(), status);
+        MixedUnitLongNameHandler::forMeasureUnit(fLocale, unit, fWidth, fUnitDisplayCase.data(),
+                                                 fRules, NULL, mlnh.getAlias(), status);
+        handler.adoptInstead(mlnh.orphan());
+    } else {
+        LocalPointer<LongNameHandler> lnh(new LongNameHandler(), status);
+        LongNameHandler::forMeasureUnit(fLocale, unit, fWidth, fUnitDisplayCase.data(), fRules,
+                                        NULL, lnh.getAlias(), status);
+        handler.adoptInstead(lnh.orphan());
+    }
+    if (U_FAILURE(status)) {
+        // Leave the handler unbuilt: a later call tries again.
+        return nullptr;
+    }
+    LongNameMultiplexer *nonConstThis = const_cast<LongNameMultiplexer *>(this);
+    nonConstThis->fHandlers[i] = handler.orphan();
+    umtx_storeRelease(fHandlerStates[i].fState, INT32_MIN);
+    return fHandlers[i];
+}
+
 void LongNameMultiplexer::processQuantity(DecimalQuantity &quantity, MicroProps &micros,
                                           UErrorCode &status) const {
     // We call parent->processQuantity() from the Multiplexer, instead of
     // letting LongNameHandler handle it: we don't know which LongNameHandler to
     // call until we've called the parent!
     fParent->processQuantity(quantity, micros, status);
+    if (U_FAILURE(status)) {
+        return;
+    }
 
     // Call the correct LongNameHandler based on outputUnit
-    for (int i = 0; i < fHandlers.getCapacity(); i++) {
+    for (int32_t i = 0; i < fLength; i++) {
         if (fMeasureUnits[i] == micros.outputUnit) {
-            fHandlers[i]->processQuantity(quantity, micros, status);
+            const MicroPropsGenerator *handler = getHandler(i, status);
+            if (U_FAILURE(status)) {
+                return;
+            }
+            handler->processQuantity(quantity, micros, status);
             return;
         }
     }
-    if (U_FAILURE(status)) {
-        return;
-    }
     // We shouldn't receive any outputUnit for which we haven't already got a
     // LongNameHandler:
     status = U_INTERNAL_PROGRAM_ERROR;
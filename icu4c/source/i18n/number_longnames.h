@@ -7,11 +7,13 @@
 #ifndef __NUMBER_LONGNAMES_H__
 #define __NUMBER_LONGNAMES_H__
 
+#include "charstr.h"
 #include "cmemory.h"
 #include "unicode/listformatter.h"
 #include "unicode/uversion.h"
 #include "number_utils.h"
 #include "number_modifiers.h"
+#include "umutex.h"
 
 U_NAMESPACE_BEGIN namespace number {
 namespace impl {
@@ -35,6 +37,18 @@ class LongNameHandler : public MicroPropsGenerator, public ModifierStore, public
         StandardPlural::Form pluralForm,
         UErrorCode& status);
 
+    /**
+     * Returns how many lookups of unit display data found it in the cache, how
+     * many had to load it from the resource bundles, and how many bytes the
+     * cached data currently uses. The lookup counters wrap around on overflow.
+     *
+     * The cache holds the raw pattern strings of each unit, per locale, width
+     * and case. It saves reading the resource bundles again; compiling the
+     * patterns into SimpleFormatters still happens each time a LongNameHandler
+     * is constructed.
+     */
+    static void getMeasureDataCacheStats(int32_t &hits, int32_t &misses, int32_t &bytes);
+
     static LongNameHandler*
     forCurrencyLongNames(const Locale &loc, const CurrencyUnit &currency, const PluralRules *rules,
                          const MicroPropsGenerator *parent, UErrorCode &status);
@@ -93,9 +107,8 @@ class LongNameHandler : public MicroPropsGenerator, public ModifierStore, public
     LongNameHandler() : rules(nullptr), parent(nullptr) {
     }
 
-    // Enables MemoryPool<LongNameHandler>::emplaceBack(): requires access to
-    // the private constructors.
-    friend class MemoryPool<LongNameHandler>;
+    // Allow LongNameMultiplexer to build its handlers on first use.
+    friend class LongNameMultiplexer;
 
     // Allow macrosToMicroGenerator to call the private default constructor.
     friend class NumberFormatterImpl;
@@ -208,9 +221,8 @@ class MixedUnitLongNameHandler : public MicroPropsGenerator, public ModifierStor
     // Allow macrosToMicroGenerator to call the private default constructor.
     friend class NumberFormatterImpl;
 
-    // Enables MemoryPool<LongNameHandler>::emplaceBack(): requires access to
-    // the private constructors.
-    friend class MemoryPool<MixedUnitLongNameHandler>;
+    // Allow LongNameMultiplexer to build its handlers on first use.
+    friend class LongNameMultiplexer;
 
     // For a mixed unit, returns a Modifier that takes only one parameter: the
     // smallest and final unit of the set. The bigger units' values and labels
@@ -230,6 +242,10 @@ class LongNameMultiplexer : public MicroPropsGenerator, public UMemory {
   public:
     // Produces a multiplexer for LongNameHandlers, one for each unit in
     // `units`. An individual unit might be a mixed unit.
+    //
+    // The handlers are built lazily, the first time their unit is routed to:
+    // the long name data of units that are never used is not loaded. `rules`
+    // must outlive the multiplexer.
     static LongNameMultiplexer *forMeasureUnits(const Locale &loc,
                                                 const MaybeStackVector<MeasureUnit> &units,
                                                 const UNumberUnitWidth &width,
@@ -238,29 +254,49 @@ class LongNameMultiplexer : public MicroPropsGenerator, public UMemory {
                                                 const MicroPropsGenerator *parent,
                                                 UErrorCode &status);
 
+    ~LongNameMultiplexer() U_OVERRIDE;
+
     // The output unit must be provided via `micros.outputUnit`, it must match
     // one of the units provided to the factory function.
     void processQuantity(DecimalQuantity &quantity, MicroProps &micros,
                          UErrorCode &status) const U_OVERRIDE;
 
   private:
-    /**
-     * Because we only know which LongNameHandler we wish to call after calling
-     * earlier MicroPropsGenerators in the chain, LongNameMultiplexer keeps the
-     * parent link, while the LongNameHandlers are given no parents.
-     */
-    MemoryPool<LongNameHandler> fLongNameHandlers;
-    MemoryPool<MixedUnitLongNameHandler> fMixedUnitHandlers;
-    // Unowned pointers to instances owned by MaybeStackVectors.
+    // Owned LongNameHandlers and MixedUnitLongNameHandlers, or nullptr for
+    // those not built yet. fHandlers[i] may only be read once fHandlerStates[i]
+    // is negative.
     MaybeStackArray<MicroPropsGenerator *, 8> fHandlers;
+    // Zero until the same-index handler is built, then INT32_MIN. Wrapped in a
+    // UMemory so that the array is allocated with ICU's allocator.
+    struct HandlerState : public UMemory {
+        mutable u_atomic_int32_t fState;
+    };
+    LocalArray<HandlerState> fHandlerStates;
     // Each MeasureUnit corresponds to the same-index MicroPropsGenerator
     // pointed to in fHandlers.
     LocalArray<MeasureUnit> fMeasureUnits;
+    int32_t fLength = 0;
+
+    // The arguments for building the handlers.
+    Locale fLocale;
+    UNumberUnitWidth fWidth;
+    CharString fUnitDisplayCase;
+    const PluralRules *fRules;
 
+    /**
+     * Because we only know which LongNameHandler we wish to call after calling
+     * earlier MicroPropsGenerators in the chain, LongNameMultiplexer keeps the
+     * parent link, while the LongNameHandlers are given no parents.
+     */
     const MicroPropsGenerator *fParent;
 
-    LongNameMultiplexer(const MicroPropsGenerator *parent) : fParent(parent) {
+    LongNameMultiplexer(const Locale &loc, UNumberUnitWidth width, const PluralRules *rules,
+                        const MicroPropsGenerator *parent)
+        : fLocale(loc), fWidth(width), fRules(rules), fParent(parent) {
     }
+
+    // Returns the handler for fMeasureUnits[i], building it if needed.
+    const MicroPropsGenerator *getHandler(int32_t i, UErrorCode &status) const;
 };
 
 }  // namespace impl
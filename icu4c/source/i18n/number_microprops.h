@@ -81,6 +81,8 @@ struct MicroProps : public MicroPropsGenerator {
     UNumberSignDisplay sign;
     UNumberDecimalSeparatorDisplay decimal;
     bool useCurrency;
+    // Whether writeIntegerDigits() may write the digits in one go; see NumberFormatterImpl.
+    bool fastIntegerDigits = false;
     char nsName[9];
 
     // No ownership: must point at a string which will outlive MicroProps
@@ -28,6 +28,11 @@ void FormattedNumber::toDecimalNumber(ByteSink& sink, UErrorCode& status) const
     decnum.toString(sink, status);
 }
 
+void FormattedNumber::appendToUTF8(ByteSink& sink, UErrorCode& status) const {
+    UPRV_FORMATTED_VALUE_METHOD_GUARD(UPRV_NOARG)
+    fData->getStringRef().appendToUTF8(sink);
+}
+
 void FormattedNumber::getAllFieldPositionsImpl(FieldPositionIteratorHandler& fpih,
                                                UErrorCode& status) const {
     UPRV_FORMATTED_VALUE_METHOD_GUARD(UPRV_NOARG)
@@ -470,6 +470,9 @@ UnlocalizedNumberFormatter skeleton::create(
     int32_t errOffset;
     MacroProps macros = parseSkeleton(skeletonString, errOffset, status);
     if (U_SUCCESS(status)) {
+        // The compiled formatter is usually shared through the cache, so there is no
+        // point in running the slow path first.
+        macros.threshold = 1;
         return NumberFormatter::with().macros(macros);
     }
 
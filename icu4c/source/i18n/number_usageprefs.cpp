@@ -108,9 +108,9 @@ void StringProp::set(StringPiece value) {
 
 // Populates micros.mixedMeasures and modifies quantity, based on the values in
 // measures.
-void mixedMeasuresToMicros(const MaybeStackVector<Measure> &measures, DecimalQuantity *quantity,
-                           MicroProps *micros, UErrorCode status) {
-    micros->mixedMeasuresCount = measures.length();
+void mixedMeasuresToMicros(const units::ConvertedMeasures &measures, DecimalQuantity *quantity,
+                           MicroProps *micros, UErrorCode &status) {
+    micros->mixedMeasuresCount = measures.count;
 
     if (micros->mixedMeasures.getCapacity() < micros->mixedMeasuresCount) {
         if (micros->mixedMeasures.resize(micros->mixedMeasuresCount) == nullptr) {
@@ -120,25 +120,12 @@ void mixedMeasuresToMicros(const MaybeStackVector<Measure> &measures, DecimalQua
     }
 
     for (int32_t i = 0; i < micros->mixedMeasuresCount; i++) {
-        switch (measures[i]->getNumber().getType()) {
-        case Formattable::kInt64:
-            micros->mixedMeasures[i] = measures[i]->getNumber().getInt64();
-            break;
-
-        case Formattable::kDouble:
+        if (i == measures.indexOfQuantity) {
             U_ASSERT(micros->indexOfQuantity < 0);
-            quantity->setToDouble(measures[i]->getNumber().getDouble());
+            quantity->setToDouble(measures.quantity);
             micros->indexOfQuantity = i;
-            break;
-
-        default:
-            U_ASSERT(0 == "Found a Measure Number which is neither a double nor an int");
-            UPRV_UNREACHABLE;
-            break;
-        }
-
-        if (U_FAILURE(status)) {
-            return;
+        } else {
+            micros->mixedMeasures[i] = measures.intValues[i];
         }
     }
 
@@ -153,8 +140,13 @@ UsagePrefsHandler::UsagePrefsHandler(const Locale &locale,
                                      const StringPiece usage,
                                      const MicroPropsGenerator *parent,
                                      UErrorCode &status)
-    : fUnitsRouter(inputUnit, StringPiece(locale.getCountry()), usage, status),
-      fParent(parent) {
+    : fParent(parent) {
+    fUnitsRouter =
+        SharedUnitsRouter::getInstance(inputUnit, StringPiece(locale.getCountry()), usage, status);
+}
+
+UsagePrefsHandler::~UsagePrefsHandler() {
+    SharedObject::clearPtr(fUnitsRouter);
 }
 
 void UsagePrefsHandler::processQuantity(DecimalQuantity &quantity, MicroProps &micros,
@@ -165,17 +157,15 @@ void UsagePrefsHandler::processQuantity(DecimalQuantity &quantity, MicroProps &m
     }
 
     quantity.roundToInfinity(); // Enables toDouble
-    const units::RouteResult routed = fUnitsRouter.route(quantity.toDouble(), &micros.rounder, status);
-    if (U_FAILURE(status)) {
-        return;
-    }
-    const MaybeStackVector<Measure>& routedMeasures = routed.measures;
-    micros.outputUnit = routed.outputUnit.copy(status).build(status);
+    units::ConvertedMeasures routed;
+    const MeasureUnit &outputUnit =
+        fUnitsRouter->get().route(quantity.toDouble(), &micros.rounder, routed, status);
     if (U_FAILURE(status)) {
         return;
     }
+    micros.outputUnit = outputUnit;
 
-    mixedMeasuresToMicros(routedMeasures, &quantity, &micros, status);
+    mixedMeasuresToMicros(routed, &quantity, &micros, status);
 }
 
 UnitConversionHandler::UnitConversionHandler(const MeasureUnit &targetUnit,
@@ -183,7 +173,7 @@ UnitConversionHandler::UnitConversionHandler(const MeasureUnit &targetUnit,
     : fOutputUnit(targetUnit), fParent(parent) {
     MeasureUnitImpl tempInput, tempOutput;
 
-    ConversionRates conversionRates(status);
+    const ConversionRates *conversionRates = ConversionRates::getInstance(status);
     if (U_FAILURE(status)) {
         return;
     }
@@ -191,7 +181,7 @@ UnitConversionHandler::UnitConversionHandler(const MeasureUnit &targetUnit,
     const MeasureUnitImpl &targetUnitImpl =
         MeasureUnitImpl::forMeasureUnit(targetUnit, tempOutput, status);
     fUnitConverter.adoptInsteadAndCheckErrorCode(
-        new ComplexUnitsConverter(targetUnitImpl, conversionRates, status), status);
+        new ComplexUnitsConverter(targetUnitImpl, *conversionRates, status), status);
 }
 
 void UnitConversionHandler::processQuantity(DecimalQuantity &quantity, MicroProps &micros,
@@ -201,8 +191,8 @@ void UnitConversionHandler::processQuantity(DecimalQuantity &quantity, MicroProp
         return;
     }
     quantity.roundToInfinity(); // Enables toDouble
-    MaybeStackVector<Measure> measures =
-        fUnitConverter->convert(quantity.toDouble(), &micros.rounder, status);
+    units::ConvertedMeasures measures;
+    fUnitConverter->convert(quantity.toDouble(), &micros.rounder, measures, status);
     micros.outputUnit = fOutputUnit;
     if (U_FAILURE(status)) {
         return;
@@ -21,6 +21,7 @@
 U_NAMESPACE_BEGIN
 
 using ::icu::units::ComplexUnitsConverter;
+using ::icu::units::SharedUnitsRouter;
 using ::icu::units::UnitsRouter;
 
 namespace number {
@@ -36,6 +37,8 @@ class U_I18N_API UsagePrefsHandler : public MicroPropsGenerator, public UMemory
     UsagePrefsHandler(const Locale &locale, const MeasureUnit &inputUnit, const StringPiece usage,
                       const MicroPropsGenerator *parent, UErrorCode &status);
 
+    ~UsagePrefsHandler();
+
     /**
      * Obtains the appropriate output value, MeasureUnit and
      * rounding/precision behaviour from the UnitsRouter.
@@ -54,11 +57,13 @@ class U_I18N_API UsagePrefsHandler : public MicroPropsGenerator, public UMemory
      * UsagePrefsHandler instance.
      */
     const MaybeStackVector<MeasureUnit> *getOutputUnits() const {
-        return fUnitsRouter.getOutputUnits();
+        return fUnitsRouter->get().getOutputUnits();
     }
 
   private:
-    UnitsRouter fUnitsRouter;
+    // Shared with every other UsagePrefsHandler for the same input unit,
+    // region and usage: see SharedUnitsRouter::getInstance().
+    const SharedUnitsRouter *fUnitsRouter = nullptr;
     const MicroPropsGenerator *fParent;
 };
 
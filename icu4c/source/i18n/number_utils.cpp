@@ -244,6 +244,34 @@ void DecNum::divideBy(const DecNum& rhs, UErrorCode& status) {
     }
 }
 
+void DecNum::add(const DecNum& rhs, UErrorCode& status) {
+    uprv_decNumberAdd(fData, fData, rhs.fData, &fContext);
+    if ((fContext.status & DEC_Inexact) != 0) {
+        // Ignore.
+    } else if (fContext.status != 0) {
+        status = U_INTERNAL_PROGRAM_ERROR;
+    }
+}
+
+void DecNum::ensureCapacity(int32_t digits, UErrorCode& status) {
+    if (U_FAILURE(status) || digits <= fContext.digits) {
+        return;
+    }
+    // "digits is of type int32_t, and must have a value in the range 1 through 999,999,999."
+    if (digits > 999999999) {
+        status = U_UNSUPPORTED_ERROR;
+        return;
+    }
+    if (digits > fData.getCapacity()) {
+        // Keep the current coefficient.
+        if (fData.resize(digits, fData.getCapacity()) == nullptr) {
+            status = U_MEMORY_ALLOCATION_ERROR;
+            return;
+        }
+    }
+    fContext.digits = digits;
+}
+
 bool DecNum::isNegative() const {
     return decNumberIsNegative(fData.getAlias());
 }
@@ -444,6 +444,18 @@ class U_I18N_API MeasureUnit: public UObject {
         return !(*this == other);
     }
 
+#ifndef U_HIDE_DRAFT_API
+    /**
+     * Returns a hash code for this unit, consistent with operator==: equal
+     * units have equal hash codes. Computing it does not look at the unit
+     * identifier, so it is cheap even for compound and mixed units.
+     *
+     * @return A hash code.
+     * @draft ICU 70
+     */
+    int32_t hashCode() const;
+#endif /* U_HIDE_DRAFT_API */
+
     /**
      * Get the type.
      *
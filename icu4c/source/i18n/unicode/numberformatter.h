@@ -2484,6 +2484,65 @@ class U_I18N_API LocalizedNumberFormatter
      */
     FormattedNumber formatDecimal(StringPiece value, UErrorCode& status) const;
 
+#ifndef U_HIDE_DRAFT_API
+    /**
+     * Format an array of floats or doubles into a single buffer using the settings specified in the
+     * NumberFormatter fluent setting chain. This is faster than calling formatDouble() for each value
+     * because the intermediate objects are reused across the whole batch.
+     *
+     * The formatted numbers are written one after the other without separators: the i-th number
+     * occupies dest[offsets[i]] up to but not including dest[offsets[i + 1]]. Field positions are
+     * not available; use formatDouble() if they are needed.
+     *
+     * This function follows the usual ICU preflighting convention: if destCapacity is greater than
+     * the returned length, a terminating NUL is written; if it is less, U_BUFFER_OVERFLOW_ERROR is
+     * set, but offsets are still filled in and the full length is returned.
+     *
+     * @param values
+     *            The numbers to format.
+     * @param count
+     *            The number of values.
+     * @param dest
+     *            The buffer to receive the formatted numbers. May be nullptr if destCapacity is 0.
+     * @param destCapacity
+     *            The capacity of dest, in char16_t units.
+     * @param offsets
+     *            Receives count + 1 offsets into dest; offsets[count] is the total length.
+     * @param status
+     *            Set to an ErrorCode if one occurred in the setter chain or during formatting.
+     * @return The total length of the formatted numbers, not counting a terminating NUL.
+     * @draft ICU 70
+     */
+    int32_t formatDoubleArray(const double* values, int32_t count, char16_t* dest,
+                              int32_t destCapacity, int32_t* offsets, UErrorCode& status) const;
+
+    /**
+     * Format an array of floats or doubles into a single buffer as UTF-8, like formatDoubleArray()
+     * does into UTF-16. Each formatted number is converted to UTF-8 straight from the formatter's
+     * internal buffer, without an intermediate UnicodeString.
+     *
+     * The i-th number occupies dest[offsets[i]] up to but not including dest[offsets[i + 1]]. The
+     * preflighting convention is the same as for formatDoubleArray().
+     *
+     * @param values
+     *            The numbers to format.
+     * @param count
+     *            The number of values.
+     * @param dest
+     *            The buffer to receive the formatted numbers. May be nullptr if destCapacity is 0.
+     * @param destCapacity
+     *            The capacity of dest, in chars.
+     * @param offsets
+     *            Receives count + 1 offsets into dest; offsets[count] is the total length.
+     * @param status
+     *            Set to an ErrorCode if one occurred in the setter chain or during formatting.
+     * @return The total length of the formatted numbers in chars, not counting a terminating NUL.
+     * @draft ICU 70
+     */
+    int32_t formatDoubleArrayToUTF8(const double* values, int32_t count, char* dest,
+                                    int32_t destCapacity, int32_t* offsets, UErrorCode& status) const;
+#endif // U_HIDE_DRAFT_API
+
 #ifndef U_HIDE_INTERNAL_API
 
     /** Internal method.
@@ -2611,6 +2670,13 @@ class U_I18N_API LocalizedNumberFormatter
      */
     bool computeCompiled(UErrorCode& status) const;
 
+    /**
+     * @return The compiled formatter for formatting count values in a batch, or nullptr for the
+     *         slow path. tempCompiled is set to a temporary one that the caller must release.
+     */
+    const impl::NumberFormatterImpl* getCompiledForArray(
+        int32_t count, const impl::NumberFormatterImpl*& tempCompiled, UErrorCode& status) const;
+
     // To give the fluent setters access to this class's constructor:
     friend class NumberFormatterSettings<UnlocalizedNumberFormatter>;
     friend class NumberFormatterSettings<LocalizedNumberFormatter>;
@@ -2716,6 +2782,25 @@ class U_I18N_API FormattedNumber : public UMemory, public FormattedValue {
     inline StringClass toDecimalNumber(UErrorCode& status) const;
 
 #ifndef U_HIDE_DRAFT_API
+    /**
+     * Appends the formatted number to a ByteSink as UTF-8.
+     *
+     * The UTF-8 bytes are written directly from the internal buffer, without
+     * creating an intermediate UnicodeString as toString() followed by
+     * UnicodeString::toUTF8() would.
+     *
+     * Example call site:
+     *
+     *     std::string s;
+     *     StringByteSink<std::string> sink(&s);
+     *     fn.appendToUTF8(sink, status);
+     *
+     * @param sink The ByteSink to receive the UTF-8 string.
+     * @param status Set if an error occurs.
+     * @draft ICU 70
+     */
+    void appendToUTF8(ByteSink& sink, UErrorCode& status) const;
+
 	/**
      * Gets the resolved output unit.
      *
@@ -2822,6 +2907,9 @@ class U_I18N_API NumberFormatter final {
      * It is possible for an error to occur while parsing. See the overload of this method if you are
      * interested in the location of a possible parse error.
      *
+     * Formatters created from a skeleton build their internal data structures on the first call to a
+     * format method, and share them with all formatters that have the same settings and locale.
+     *
      * For more information on number skeleton strings, see:
      * https://unicode-org.github.io/icu/userguide/format_parse/numbers/skeletons.html
      *
@@ -2841,6 +2929,9 @@ class U_I18N_API NumberFormatter final {
      * If an error occurs while parsing the skeleton string, the offset into the skeleton string at
      * which the error occurred will be saved into the UParseError, if provided.
      *
+     * Formatters created from a skeleton build their internal data structures on the first call to a
+     * format method, and share them with all formatters that have the same settings and locale.
+     *
      * For more information on number skeleton strings, see:
      * https://unicode-org.github.io/icu/userguide/format_parse/numbers/skeletons.html
      *
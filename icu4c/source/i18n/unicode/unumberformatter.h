@@ -667,6 +667,61 @@ U_CAPI void U_EXPORT2
 unumf_formatDecimal(const UNumberFormatter* uformatter, const char* value, int32_t valueLen,
                     UFormattedNumber* uresult, UErrorCode* ec);
 
+#ifndef U_HIDE_DRAFT_API
+/**
+ * Uses a UNumberFormatter to format an array of doubles into a single UChar buffer. This is faster
+ * than calling unumf_formatDouble and unumf_resultToString for each value.
+ *
+ * The formatted numbers are written one after the other without separators: the i-th number
+ * occupies buffer[offsets[i]] up to but not including buffer[offsets[i + 1]].
+ * If bufferCapacity is greater than the required length, a terminating NUL is written.
+ * If bufferCapacity is less than the required length, an error code is set, but offsets are still
+ * filled in and the required length is returned.
+ *
+ * NOTE: This is a C-compatible API; C++ users should build against numberformatter.h instead.
+ *
+ * @param uformatter A formatter object created by unumf_openForSkeletonAndLocale or similar.
+ * @param values The numbers to be formatted.
+ * @param count The number of values.
+ * @param buffer Where to save the formatted numbers. May be NULL if bufferCapacity is 0.
+ * @param bufferCapacity The size of buffer, in UChars.
+ * @param offsets Receives count + 1 offsets into buffer; offsets[count] is the total length.
+ * @param ec Set if an error occurs.
+ * @return The total length of the formatted numbers, not counting a terminating NUL.
+ * @draft ICU 70
+ */
+U_CAPI int32_t U_EXPORT2
+unumf_formatDoubleArray(const UNumberFormatter* uformatter, const double* values, int32_t count,
+                        UChar* buffer, int32_t bufferCapacity, int32_t* offsets, UErrorCode* ec);
+
+/**
+ * Uses a UNumberFormatter to format an array of doubles into a single char buffer as UTF-8, like
+ * unumf_formatDoubleArray does into UTF-16. This is faster than calling unumf_formatDouble and
+ * unumf_resultToUTF8 for each value.
+ *
+ * The i-th number occupies buffer[offsets[i]] up to but not including buffer[offsets[i + 1]].
+ * If bufferCapacity is greater than the required length, a terminating NUL is written.
+ * If bufferCapacity is less than the required length, an error code is set, but offsets are still
+ * filled in and the required length is returned.
+ *
+ * NOTE: This is a C-compatible API; C++ users should build against numberformatter.h instead.
+ *
+ * @param uformatter A formatter object created by unumf_openForSkeletonAndLocale or similar.
+ * @param values The numbers to be formatted.
+ * @param count The number of values.
+ * @param buffer Where to save the formatted numbers. May be NULL if bufferCapacity is 0.
+ * @param bufferCapacity The size of buffer, in chars.
+ * @param offsets Receives count + 1 offsets into buffer; offsets[count] is the total length.
+ * @param ec Set if an error occurs.
+ * @return The total length of the formatted numbers in chars, not counting a terminating NUL.
+ * @draft ICU 70
+ */
+U_CAPI int32_t U_EXPORT2
+unumf_formatDoubleArrayToUTF8(const UNumberFormatter* uformatter, const double* values,
+                              int32_t count, char* buffer, int32_t bufferCapacity, int32_t* offsets,
+                              UErrorCode* ec);
+#endif  // U_HIDE_DRAFT_API
+
 /**
  * Returns a representation of a UFormattedNumber as a UFormattedValue,
  * which can be subsequently passed to any API requiring that type.
@@ -708,6 +763,27 @@ U_CAPI int32_t U_EXPORT2
 unumf_resultToString(const UFormattedNumber* uresult, UChar* buffer, int32_t bufferCapacity,
                      UErrorCode* ec);
 
+#ifndef U_HIDE_DRAFT_API
+/**
+ * Extracts the result number string out of a UFormattedNumber to a char buffer as UTF-8 if possible,
+ * without an intermediate UTF-16 copy.
+ * If bufferCapacity is greater than the required length, a terminating NUL is written.
+ * If bufferCapacity is less than the required length, an error code is set.
+ *
+ * NOTE: This is a C-compatible API; C++ users should build against numberformatter.h instead.
+ *
+ * @param uresult The object containing the formatted number.
+ * @param buffer Where to save the UTF-8 string output.
+ * @param bufferCapacity The number of chars available in the buffer.
+ * @param ec Set if an error occurs.
+ * @return The required length in chars.
+ * @draft ICU 70
+ */
+U_CAPI int32_t U_EXPORT2
+unumf_resultToUTF8(const UFormattedNumber* uresult, char* buffer, int32_t bufferCapacity,
+                   UErrorCode* ec);
+#endif  // U_HIDE_DRAFT_API
+
 
 /**
  * Determines the start and end indices of the next occurrence of the given <em>field</em> in the
@@ -0,0 +1,235 @@
+// © 2021 and later: Unicode, Inc. and others.
+// License & terms of use: http://www.unicode.org/copyright.html
+
+#ifndef __UUNITS_H__
+#define __UUNITS_H__
+
+#include "unicode/utypes.h"
+
+#if !UCONFIG_NO_FORMATTING
+
+#if U_SHOW_CPLUSPLUS_API
+#include "unicode/localpointer.h"
+#endif   // U_SHOW_CPLUSPLUS_API
+
+/**
+ * \file
+ * \brief C API: Numeric conversion between units, and usage-based unit routing.
+ *
+ * These functions convert numbers from one unit to another without formatting
+ * them. Unit identifiers are those accepted by MeasureUnit::forIdentifier(),
+ * such as "meter", "mile-per-hour" or "foot-and-inch".
+ *
+ * A UUnitsConverter converts between two single or compound units of the same
+ * quantity:
+ * <pre>
+ * UErrorCode ec = U_ZERO_ERROR;
+ * UUnitsConverter* uconv = uunitconv_open("meter", "foot", &ec);
+ * double feet = uunitconv_convert(uconv, 2.5, &ec);
+ * uunitconv_close(uconv);
+ * </pre>
+ *
+ * A UUnitsRouter picks the output unit that the conventions of a region
+ * prefer for a usage and a value, like NumberFormatter's usage() does:
+ * <pre>
+ * UErrorCode ec = U_ZERO_ERROR;
+ * UUnitsRouter* urouter = uunitrouter_open("meter", "US", "person-height", &ec);
+ * double values[4];
+ * int32_t unitIndex;
+ * int32_t count = uunitrouter_route(urouter, 1.8, values, 4, &unitIndex, &ec);
+ * // count == 2, values == {5, 11}, and
+ * // uunitrouter_getOutputUnit(urouter, unitIndex, &ec) is "foot-and-inch"
+ * uunitrouter_close(urouter);
+ * </pre>
+ *
+ * Converting does not allocate memory. Routing rounds its result the way
+ * NumberFormatter does, which may allocate memory for values with more than
+ * 16 significant digits. Converters and routers are immutable: they can be
+ * used concurrently from several threads.
+ */
+
+#ifndef U_HIDE_DRAFT_API
+
+struct UUnitsConverter;
+/**
+ * Opaque converter between two units, for use in C.
+ * @draft ICU 70
+ */
+typedef struct UUnitsConverter UUnitsConverter;
+
+struct UUnitsRouter;
+/**
+ * Opaque router of values to the preferred unit for a usage and region, for
+ * use in C.
+ * @draft ICU 70
+ */
+typedef struct UUnitsRouter UUnitsRouter;
+
+/**
+ * Opens a converter from `sourceUnit` to `targetUnit`.
+ *
+ * Both units must be single or compound units of the same quantity, or
+ * reciprocal units such as "liter-per-100-kilometer" and "mile-per-gallon".
+ * Mixed units are not supported: use a UUnitsRouter instead.
+ *
+ * @param sourceUnit The identifier of the unit to convert from, NUL-terminated.
+ * @param targetUnit The identifier of the unit to convert to, NUL-terminated.
+ * @param ec Set if an error occurs. U_ILLEGAL_ARGUMENT_ERROR if an identifier
+ *           is invalid or the units cannot be converted into each other.
+ * @return The converter, to be closed with uunitconv_close().
+ * @draft ICU 70
+ */
+U_CAPI UUnitsConverter* U_EXPORT2
+uunitconv_open(const char* sourceUnit, const char* targetUnit, UErrorCode* ec);
+
+/**
+ * Converts a value from the source unit to the target unit.
+ *
+ * @param uconv The converter.
+ * @param value The value, in the source unit.
+ * @param ec Set if an error occurs.
+ * @return The value in the target unit.
+ * @draft ICU 70
+ */
+U_CAPI double U_EXPORT2
+uunitconv_convert(const UUnitsConverter* uconv, double value, UErrorCode* ec);
+
+/**
+ * Converts `length` values from the source unit to the target unit. This is
+ * much faster than calling uunitconv_convert() for each value.
+ *
+ * @param uconv The converter.
+ * @param input The values, in the source unit.
+ * @param output Receives the values in the target unit. May be the same as
+ *               `input`, but must not otherwise overlap it.
+ * @param length The number of values in `input` and `output`.
+ * @param ec Set if an error occurs.
+ * @draft ICU 70
+ */
+U_CAPI void U_EXPORT2
+uunitconv_convertArray(const UUnitsConverter* uconv, const double* input, double* output,
+                       int32_t length, UErrorCode* ec);
+
+/**
+ * Closes a converter. Does nothing if `uconv` is NULL.
+ *
+ * @param uconv The converter.
+ * @draft ICU 70
+ */
+U_CAPI void U_EXPORT2
+uunitconv_close(UUnitsConverter* uconv);
+
+/**
+ * Opens a router for values of `inputUnit`, for the units preferred in
+ * `region` for `usage`.
+ *
+ * @param inputUnit The identifier of the unit of the routed values,
+ *                  NUL-terminated.
+ * @param region A region code, such as "US" or "001", NUL-terminated.
+ * @param usage A usage, such as "person-height" or "road", or "default",
+ *              NUL-terminated.
+ * @param ec Set if an error occurs. U_ILLEGAL_ARGUMENT_ERROR if the input unit
+ *           identifier is invalid.
+ * @return The router, to be closed with uunitrouter_close().
+ * @draft ICU 70
+ */
+U_CAPI UUnitsRouter* U_EXPORT2
+uunitrouter_open(const char* inputUnit, const char* region, const char* usage, UErrorCode* ec);
+
+/**
+ * Returns the number of output units that the router can route to.
+ *
+ * @param urouter The router.
+ * @param ec Set if an error occurs.
+ * @return The number of output units.
+ * @draft ICU 70
+ */
+U_CAPI int32_t U_EXPORT2
+uunitrouter_countOutputUnits(const UUnitsRouter* urouter, UErrorCode* ec);
+
+/**
+ * Returns the identifier of one of the output units of the router, such as
+ * "foot-and-inch".
+ *
+ * @param urouter The router.
+ * @param unitIndex An index from 0 to uunitrouter_countOutputUnits() - 1, as
+ *                  returned by uunitrouter_route().
+ * @param ec Set if an error occurs. U_ILLEGAL_ARGUMENT_ERROR if `unitIndex`
+ *           is out of range.
+ * @return The NUL-terminated identifier, valid until the router is closed.
+ * @draft ICU 70
+ */
+U_CAPI const char* U_EXPORT2
+uunitrouter_getOutputUnit(const UUnitsRouter* urouter, int32_t unitIndex, UErrorCode* ec);
+
+/**
+ * Converts a value to the output unit preferred for it.
+ *
+ * The converted value has a component for each single unit of the output
+ * unit, in the order of the output unit identifier: for "foot-and-inch", the
+ * feet come first and then the inches. All components but the one of the
+ * smallest unit are integers. Negative values have negative components.
+ *
+ * Like NumberFormatter's usage() without a precision, the value is rounded to
+ * the precision of the preference that was picked for it, or else to an
+ * integer with at least two significant digits. Rounding the smallest unit
+ * carries into the larger ones: 1.8237 meters of "person-height" in the US
+ * are 6 feet 0 inches, not 5 feet 12 inches.
+ *
+ * @param urouter The router.
+ * @param value The value, in the input unit.
+ * @param components Receives the components of the converted value.
+ * @param capacity The capacity of `components`. An output unit has at most as
+ *                 many components as it has single units.
+ * @param unitIndex If not NULL, receives the index of the output unit, for
+ *                  uunitrouter_getOutputUnit().
+ * @param ec Set if an error occurs. U_BUFFER_OVERFLOW_ERROR if the components
+ *           do not fit into `capacity`.
+ * @return The number of components, even if they do not fit into `capacity`.
+ * @draft ICU 70
+ */
+U_CAPI int32_t U_EXPORT2
+uunitrouter_route(const UUnitsRouter* urouter, double value, double* components, int32_t capacity,
+                  int32_t* unitIndex, UErrorCode* ec);
+
+/**
+ * Closes a router. Does nothing if `urouter` is NULL.
+ *
+ * @param urouter The router.
+ * @draft ICU 70
+ */
+U_CAPI void U_EXPORT2
+uunitrouter_close(UUnitsRouter* urouter);
+
+#if U_SHOW_CPLUSPLUS_API
+U_NAMESPACE_BEGIN
+
+/**
+ * \class LocalUUnitsConverterPointer
+ * "Smart pointer" class; closes a UUnitsConverter via uunitconv_close().
+ * For most methods see the LocalPointerBase base class.
+ *
+ * @see LocalPointerBase
+ * @see LocalPointer
+ * @draft ICU 70
+ */
+U_DEFINE_LOCAL_OPEN_POINTER(LocalUUnitsConverterPointer, UUnitsConverter, uunitconv_close);
+
+/**
+ * \class LocalUUnitsRouterPointer
+ * "Smart pointer" class; closes a UUnitsRouter via uunitrouter_close().
+ * For most methods see the LocalPointerBase base class.
+ *
+ * @see LocalPointerBase
+ * @see LocalPointer
+ * @draft ICU 70
+ */
+U_DEFINE_LOCAL_OPEN_POINTER(LocalUUnitsRouterPointer, UUnitsRouter, uunitrouter_close);
+
+U_NAMESPACE_END
+#endif // U_SHOW_CPLUSPLUS_API
+
+#endif /* U_HIDE_DRAFT_API */
+
+#endif /* #if !UCONFIG_NO_FORMATTING */
+#endif //__UUNITS_H__
@@ -6,8 +6,11 @@
 #if !UCONFIG_NO_FORMATTING
 
 #include <cmath>
+#include <float.h>
+#include <limits>
 
 #include "cmemory.h"
+#include "double-conversion-ieee.h"
 #include "number_decimalquantity.h"
 #include "number_roundingutils.h"
 #include "putilimp.h"
@@ -22,6 +25,7 @@
 
 U_NAMESPACE_BEGIN
 namespace units {
+
 ComplexUnitsConverter::ComplexUnitsConverter(const MeasureUnitImpl &targetUnit,
                                              const ConversionRates &ratesInfo, UErrorCode &status)
     : units_(targetUnit.extractIndividualUnitsWithIndices(status)) {
@@ -57,7 +61,11 @@ ComplexUnitsConverter::ComplexUnitsConverter(StringPiece inputUnitIdentifier,
     this->units_ = outputUnits.extractIndividualUnitsWithIndices(status);
     U_ASSERT(units_.length() != 0);
 
-    this->init(inputUnit, ConversionRates(status), status);
+    const ConversionRates *ratesInfo = ConversionRates::getInstance(status);
+    if (U_FAILURE(status)) {
+        return;
+    }
+    this->init(inputUnit, *ratesInfo, status);
 }
 
 ComplexUnitsConverter::ComplexUnitsConverter(const MeasureUnitImpl &inputUnit,
@@ -76,6 +84,20 @@ ComplexUnitsConverter::ComplexUnitsConverter(const MeasureUnitImpl &inputUnit,
 void ComplexUnitsConverter::init(const MeasureUnitImpl &inputUnit,
                                  const ConversionRates &ratesInfo,
                                  UErrorCode &status) {
+    if (U_FAILURE(status)) {
+        return;
+    }
+
+    // Build the output MeasureUnits up front, while units_ is still in the
+    // requested output order, so that convert() does not need to.
+    for (int32_t i = 0, n = units_.length(); i < n; i++) {
+        U_ASSERT(units_[i]->index == i);
+        outputUnits_.emplaceBackAndCheckErrorCode(status, units_[i]->unitImpl.copy(status).build(status));
+        if (U_FAILURE(status)) {
+            return;
+        }
+    }
+
     // Sorts units in descending order. Therefore, we return -1 if
     // the left is bigger than right and so on.
     auto descendingCompareUnits = [](const void *context, const void *left, const void *right) {
@@ -114,34 +136,123 @@ void ComplexUnitsConverter::init(const MeasureUnitImpl &inputUnit,
     //              2. convert the residual of 6.56168 feet (0.56168) to inches, which will be (6.74016
     //              inches)
     //              3. then, the final result will be (6 feet and 6.74016 inches)
-    for (int i = 0, n = units_.length(); i < n; i++) {
-        if (i == 0) { // first element
-            unitsConverters_.emplaceBackAndCheckErrorCode(status, inputUnit, units_[i]->unitImpl,
-                                                          ratesInfo, status);
-        } else {
-            unitsConverters_.emplaceBackAndCheckErrorCode(status, units_[i - 1]->unitImpl,
-                                                          units_[i]->unitImpl, ratesInfo, status);
-        }
-
+    int32_t n = units_.length();
+    if (n > conversions_.getCapacity() && conversions_.resize(n) == nullptr) {
+        status = U_MEMORY_ALLOCATION_ERROR;
+        return;
+    }
+    for (int32_t i = 0; i < n; i++) {
+        const MeasureUnitImpl &source = i == 0 ? inputUnit : units_[i - 1]->unitImpl;
+        UnitsConverter converter(source, units_[i]->unitImpl, ratesInfo, status);
         if (U_FAILURE(status)) {
             return;
         }
+        conversions_[i] = converter.getLinearConversion();
     }
 }
 
 UBool ComplexUnitsConverter::greaterThanOrEqual(double quantity, double limit) const {
-    U_ASSERT(unitsConverters_.length() > 0);
+    U_ASSERT(units_.length() > 0);
 
     // First converter converts to the biggest quantity.
-    double newQuantity = unitsConverters_[0]->convert(quantity);
+    double newQuantity = conversions_[0].convert(quantity);
     return newQuantity >= limit;
 }
 
+void ComplexUnitsConverter::getLimitsInInputUnit(double limit, double &low, double &high) const {
+    U_ASSERT(units_.length() > 0);
+
+    const LinearConversion &conversion = conversions_[0];
+    if (limit == std::numeric_limits<double>::lowest()) {
+        // No limit: every quantity but NaN is greater than or equal to it.
+        low = -uprv_getInfinity();
+        high = -uprv_getInfinity();
+        return;
+    }
+    if (conversion.kind == KIND_RECIPROCAL) {
+        // Nothing compares less than -inf or greater than or equal to NaN.
+        low = -uprv_getInfinity();
+        high = uprv_getNaN();
+        return;
+    }
+    // The conversion adds, multiplies by a positive multiplier and subtracts,
+    // with each result correctly rounded, so it is monotonic: the quantities
+    // for which greaterThanOrEqual() is true are those greater than or equal
+    // to a threshold. That threshold is usually the inverse conversion of
+    // `limit`, or the double just above it: check both with one ulp steps.
+    double inputLimit = conversion.convertInverse(limit);
+    if (!(conversion.multiplier > 0) || uprv_isNaN(inputLimit)) {
+        // Always convert.
+        low = -uprv_getInfinity();
+        high = uprv_getNaN();
+        return;
+    }
+    if (greaterThanOrEqual(inputLimit, limit)) {
+        if (!greaterThanOrEqual(double_conversion::Double(inputLimit).PreviousDouble(), limit)) {
+            low = inputLimit;
+            high = inputLimit;
+            return;
+        }
+    } else {
+        double next = double_conversion::Double(inputLimit).NextDouble();
+        if (greaterThanOrEqual(next, limit)) {
+            low = next;
+            high = next;
+            return;
+        }
+    }
+    // The threshold is further away, as when subtracting an offset loses
+    // precision near zero, or when the inverse conversion rounds differently.
+    // Bracket it with a band wide enough for those rounding errors, and call
+    // greaterThanOrEqual() within the band. If the band does not bracket the
+    // threshold after all, always convert.
+    double tolerance =
+        16 * DBL_EPSILON * (std::abs(inputLimit) + std::abs(conversion.convertInverse(0)));
+    low = inputLimit - tolerance;
+    high = inputLimit + tolerance;
+    if (greaterThanOrEqual(low, limit) || !greaterThanOrEqual(high, limit)) {
+        low = -uprv_getInfinity();
+        high = uprv_getNaN();
+    }
+}
+
 MaybeStackVector<Measure> ComplexUnitsConverter::convert(double quantity,
                                                          icu::number::impl::RoundingImpl *rounder,
                                                          UErrorCode &status) const {
-    // TODO: return an error for "foot-and-foot"?
     MaybeStackVector<Measure> result;
+    ConvertedMeasures converted;
+    convert(quantity, rounder, converted, status);
+    if (U_FAILURE(status)) {
+        return result;
+    }
+
+    // Package values into Measure instances, in the requested output order.
+    for (int32_t i = 0; i < converted.count; ++i) {
+        Formattable formattableQuantity = (i == converted.indexOfQuantity)
+                                              ? Formattable(converted.quantity)
+                                              : Formattable(converted.intValues[i]);
+        // Measure takes ownership of the MeasureUnit*
+        MeasureUnit *type = new MeasureUnit(*outputUnits_[i]);
+        if (type == nullptr) {
+            status = U_MEMORY_ALLOCATION_ERROR;
+            return result;
+        }
+        result.emplaceBackAndCheckErrorCode(status, formattableQuantity, type, status);
+        if (U_FAILURE(status)) {
+            return result;
+        }
+    }
+
+    return result;
+}
+
+void ComplexUnitsConverter::convert(double quantity, icu::number::impl::RoundingImpl *rounder,
+                                    ConvertedMeasures &result, UErrorCode &status) const {
+    if (U_FAILURE(status)) {
+        return;
+    }
+
+    // TODO: return an error for "foot-and-foot"?
     int sign = 1;
     if (quantity < 0) {
         quantity *= -1;
@@ -153,14 +264,15 @@ MaybeStackVector<Measure> ComplexUnitsConverter::convert(double quantity,
     // - the following N-2 converters convert to bigger units for which we want integers,
     // - the Nth converter (index N-1) converts to the smallest unit, for which
     //   we keep a double.
-    MaybeStackArray<int64_t, 5> intValues(unitsConverters_.length() - 1, status);
+    int32_t n = units_.length();
+    MaybeStackArray<int64_t, 5> intValues(n - 1, status);
     if (U_FAILURE(status)) {
-        return result;
+        return;
     }
-    uprv_memset(intValues.getAlias(), 0, (unitsConverters_.length() - 1) * sizeof(int64_t));
+    uprv_memset(intValues.getAlias(), 0, (n - 1) * sizeof(int64_t));
 
-    for (int i = 0, n = unitsConverters_.length(); i < n; ++i) {
-        quantity = (*unitsConverters_[i]).convert(quantity);
+    for (int32_t i = 0; i < n; ++i) {
+        quantity = conversions_[i].convert(quantity);
         if (i < n - 1) {
             // If quantity is at the limits of double's precision from an
             // integer value, we take that integer value.
@@ -183,42 +295,25 @@ MaybeStackVector<Measure> ComplexUnitsConverter::convert(double quantity,
             } else {
                 quantity = remainder;
             }
-        }   
+        }
     }
 
     applyRounder(intValues, quantity, rounder, status);
-
-    // Initialize empty result. We use a MaybeStackArray directly so we can
-    // assign pointers - for this privilege we have to take care of cleanup.
-    MaybeStackArray<Measure *, 4> tmpResult(unitsConverters_.length(), status);
     if (U_FAILURE(status)) {
-        return result;
+        return;
     }
 
-    // Package values into temporary Measure instances in tmpResult:
-    for (int i = 0, n = unitsConverters_.length(); i < n; ++i) {
-        if (i < n - 1) {
-            Formattable formattableQuantity(intValues[i] * sign);
-            // Measure takes ownership of the MeasureUnit*
-            MeasureUnit *type = new MeasureUnit(units_[i]->unitImpl.copy(status).build(status));
-            tmpResult[units_[i]->index] = new Measure(formattableQuantity, type, status);
-        } else { // LAST ELEMENT
-            Formattable formattableQuantity(quantity * sign);
-            // Measure takes ownership of the MeasureUnit*
-            MeasureUnit *type = new MeasureUnit(units_[i]->unitImpl.copy(status).build(status));
-            tmpResult[units_[i]->index] = new Measure(formattableQuantity, type, status);
-        }
+    // Transfer the values into result, in the requested output order.
+    if (result.intValues.getCapacity() < n && result.intValues.resize(n) == nullptr) {
+        status = U_MEMORY_ALLOCATION_ERROR;
+        return;
     }
-
-
-    // Transfer values into result and return:
-    for(int32_t i = 0, n = unitsConverters_.length(); i < n; ++i) {
-        U_ASSERT(tmpResult[i] != nullptr);
-        result.emplaceBackAndCheckErrorCode(status, *tmpResult[i]);
-        delete tmpResult[i];
+    for (int32_t i = 0; i < n - 1; ++i) {
+        result.intValues[units_[i]->index] = intValues[i] * sign;
     }
-
-    return result;
+    result.quantity = quantity * sign;
+    result.indexOfQuantity = units_[n - 1]->index;
+    result.count = n;
 }
 
 void ComplexUnitsConverter::applyRounder(MaybeStackArray<int64_t, 5> &intValues, double &quantity,
@@ -237,27 +332,27 @@ void ComplexUnitsConverter::applyRounder(MaybeStackArray<int64_t, 5> &intValues,
     }
     quantity = decimalQuantity.toDouble();
 
-    int32_t lastIndex = unitsConverters_.length() - 1;
+    int32_t lastIndex = units_.length() - 1;
     if (lastIndex == 0) {
         // Only one element, no need to bubble up the carry
         return;
     }
 
     // Check if there's a carry, and bubble it back up the resulting intValues.
-    int64_t carry = floor(unitsConverters_[lastIndex]->convertInverse(quantity) * (1 + DBL_EPSILON));
+    int64_t carry = floor(conversions_[lastIndex].convertInverse(quantity) * (1 + DBL_EPSILON));
     if (carry <= 0) {
         return;
     }
-    quantity -= unitsConverters_[lastIndex]->convert(carry);
+    quantity -= conversions_[lastIndex].convert(carry);
     intValues[lastIndex - 1] += carry;
 
     // We don't use the first converter: that one is for the input unit
     for (int32_t j = lastIndex - 1; j > 0; j--) {
-        carry = floor(unitsConverters_[j]->convertInverse(intValues[j]) * (1 + DBL_EPSILON));
+        carry = floor(conversions_[j].convertInverse(intValues[j]) * (1 + DBL_EPSILON));
         if (carry <= 0) {
             return;
         }
-        intValues[j] -= round(unitsConverters_[j]->convert(carry));
+        intValues[j] -= round(conversions_[j].convert(carry));
         intValues[j - 1] += carry;
     }
 }
@@ -24,9 +24,7 @@ U_NAMESPACE_BEGIN
 // Note: These need to be outside of the units namespace, or Clang will generate
 // a compile error.
 #if U_PF_WINDOWS <= U_PLATFORM && U_PLATFORM <= U_PF_CYGWIN
-template class U_I18N_API MaybeStackArray<units::UnitsConverter*, 8>;
-template class U_I18N_API MemoryPool<units::UnitsConverter, 8>;
-template class U_I18N_API MaybeStackVector<units::UnitsConverter, 8>;
+template class U_I18N_API MaybeStackArray<units::LinearConversion, 5>;
 template class U_I18N_API MaybeStackArray<MeasureUnitImpl*, 8>;
 template class U_I18N_API MemoryPool<MeasureUnitImpl, 8>;
 template class U_I18N_API MaybeStackVector<MeasureUnitImpl, 8>;
@@ -37,14 +35,42 @@ template class U_I18N_API MaybeStackVector<MeasureUnit, 8>;
 
 namespace units {
 
+/**
+ * Caller-provided storage for the result of a ComplexUnitsConverter
+ * conversion, allowing a value to be converted without heap allocation.
+ *
+ * Values are stored in the order of the units in the requested output unit:
+ * for "foot-and-inch", position 0 refers to feet and position 1 to inches. All
+ * values are integers except for the value of the smallest unit, which is
+ * stored in `quantity` rather than in `intValues`: its position is given by
+ * `indexOfQuantity`.
+ */
+struct U_I18N_API ConvertedMeasures : public UMemory {
+    // The integer values, indexed by position in the output unit. The element
+    // at `indexOfQuantity` is left unset. Only mixed units consisting of more
+    // than five units require heap allocation.
+    MaybeStackArray<int64_t, 5> intValues;
+
+    // The (possibly fractional) value of the smallest unit.
+    double quantity = 0;
+
+    // The position of the smallest unit in the output unit.
+    int32_t indexOfQuantity = -1;
+
+    // The number of units in the output unit: one more than the number of
+    // populated `intValues`.
+    int32_t count = 0;
+};
+
 /**
  *  Converts from single or compound unit to single, compound or mixed units.
  * For example, from `meter` to `foot+inch`.
  *
  *  DESIGN:
  *    This class uses `UnitsConverter` in order to perform the single converter (i.e. converters from a
- *    single unit to another single unit). Therefore, `ComplexUnitsConverter` class contains multiple
- *    instances of the `UnitsConverter` to perform the conversion.
+ *    single unit to another single unit). Therefore, `ComplexUnitsConverter` performs a chain of
+ *    conversions, one per output unit. Only the `LinearConversion` of each `UnitsConverter` is kept,
+ *    inline for up to five output units: converting a value takes a multiplication per output unit.
  */
 class U_I18N_API ComplexUnitsConverter : public UMemory {
   public:
@@ -99,6 +125,17 @@ class U_I18N_API ComplexUnitsConverter : public UMemory {
     //    `foot` with the `limit`.
     UBool greaterThanOrEqual(double quantity, double limit) const;
 
+    // Expresses `limit`, which is in terms of the biggest unit in `outputUnit`, in terms of the
+    // `inputUnit`, allowing `greaterThanOrEqual()` to be answered without a conversion: it is false for
+    // quantities below `low`, and true for quantities greater than or equal to `high`. In between, call
+    // `greaterThanOrEqual()`.
+    //    For monotonic conversions, `low` and `high` are usually both the smallest quantity for
+    //    which `greaterThanOrEqual()` is true, so nothing is in between. Finding it takes two or
+    //    three conversions. When it is not within one ulp of the inverse conversion of `limit`, as
+    //    for some conversions with an offset, `low` and `high` bracket it instead. Reciprocal
+    //    conversions are not monotonic, so for those every quantity falls in between.
+    void getLimitsInInputUnit(double limit, double &low, double &high) const;
+
     // Returns outputMeasures which is an array with the corresponding values.
     //    - E.g. converting meters to feet and inches.
     //                  1 meter --> 3 feet, 3.3701 inches
@@ -108,15 +145,36 @@ class U_I18N_API ComplexUnitsConverter : public UMemory {
     MaybeStackVector<Measure>
     convert(double quantity, icu::number::impl::RoundingImpl *rounder, UErrorCode &status) const;
 
+    /**
+     * Converts `quantity` like the convert() overload above, but writes the
+     * result into caller-provided storage rather than allocating Measure
+     * instances. This is the conversion hot path for number formatting.
+     *
+     * @param quantity The quantity to convert, expressed in the input unit.
+     * @param rounder If not null, used to round the value of the smallest unit.
+     * @param result Receives the converted values.
+     * @param status Receives status.
+     */
+    void convert(double quantity, icu::number::impl::RoundingImpl *rounder, ConvertedMeasures &result,
+                 UErrorCode &status) const;
+
   private:
-    MaybeStackVector<UnitsConverter> unitsConverters_;
+    // The chain of conversions: from the input unit to the biggest unit of
+    // units_, then from each unit of units_ to the next. There is one per
+    // element of units_.
+    MaybeStackArray<LinearConversion, 5> conversions_;
 
     // Individual units of mixed units, sorted big to small, with indices
     // indicating the requested output mixed unit order.
     MaybeStackVector<MeasureUnitImplWithIndex> units_;
 
+    // A MeasureUnit for each of the individual units in units_, built once at
+    // construction. Unlike units_, this is in the requested output mixed unit
+    // order.
+    MaybeStackVector<MeasureUnit> outputUnits_;
+
     // Sorts units_, which must be populated before calling this, and populates
-    // unitsConverters_.
+    // conversions_.
     void init(const MeasureUnitImpl &inputUnit, const ConversionRates &ratesInfo, UErrorCode &status);
 
     // Applies the rounder to the quantity (last element) and bubble up any carried value to all the
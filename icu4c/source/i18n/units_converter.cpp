@@ -9,6 +9,8 @@
 #include "cmemory.h"
 #include "double-conversion-string-to-double.h"
 #include "measunit_impl.h"
+#include "number_decimalquantity.h"
+#include "number_decnum.h"
 #include "uassert.h"
 #include "unicode/errorcode.h"
 #include "unicode/localpointer.h"
@@ -22,6 +24,78 @@
 U_NAMESPACE_BEGIN
 namespace units {
 
+namespace {
+
+// A symbolic constant of CLDR's units.xml: its name, and its value
+// numerator / denominator, both as decimal strings for the exact conversions,
+// and as a double.
+struct UnitConstant {
+    const char *name;
+    const char *numerator;
+    const char *denominator;
+    double value;
+};
+
+#define UNIT_CONSTANT(name, numerator, denominator) \
+    { name, #numerator, #denominator, numerator / denominator }
+
+// Indexed by Constants. These values are a hard-coded subset of
+// unitConstants in the units resources file. A unit test checks that all
+// constants in the resource file are at least recognised by the code.
+// Derived constants' values or hard-coded derivations are not checked.
+// In ICU4J, these constants live in UnitConverter.Factor.getConversionRate().
+const UnitConstant kUnitConstants[CONSTANTS_COUNT] = {
+    UNIT_CONSTANT("ft_to_m", 0.3048, 1),                   // CONSTANT_FT2M
+    UNIT_CONSTANT("PI", 411557987.0, 131002976.0),         // CONSTANT_PI
+    UNIT_CONSTANT("gravity", 9.80665, 1),                  // CONSTANT_GRAVITY
+    UNIT_CONSTANT("G", 6.67408E-11, 1),                    // CONSTANT_G
+    UNIT_CONSTANT("gal_imp_to_m3", 0.00454609, 1),         // CONSTANT_GAL_IMP2M3
+    UNIT_CONSTANT("lb_to_kg", 0.45359237, 1),              // CONSTANT_LB2KG
+    UNIT_CONSTANT("glucose_molar_mass", 180.1557, 1),      // CONSTANT_GLUCOSE_MOLAR_MASS
+    UNIT_CONSTANT("item_per_mole", 6.02214076E+23, 1),     // CONSTANT_ITEM_PER_MOLE
+};
+
+#undef UNIT_CONSTANT
+
+// A symbolic constant as a term of kUnitConstants:
+// kUnitConstants[base]^power * numerator / denominator.
+struct ConstantTerm {
+    Constants base;
+    int32_t power;
+    int32_t numerator;
+    int32_t denominator;
+};
+
+// The constants that units.xml derives from those in kUnitConstants.
+const struct DerivedConstant {
+    const char *name;
+    ConstantTerm term;
+} kDerivedConstants[] = {
+    {"ft2_to_m2", {CONSTANT_FT2M, 2, 1, 1}},
+    {"ft3_to_m3", {CONSTANT_FT2M, 3, 1, 1}},
+    {"in3_to_m3", {CONSTANT_FT2M, 3, 1, 12 * 12 * 12}},
+    {"gal_to_m3", {CONSTANT_FT2M, 3, 231, 12 * 12 * 12}},
+};
+
+// Looks up the symbolic constant `name`. Returns false if it is not one.
+bool findConstant(StringPiece name, ConstantTerm &term) {
+    for (int32_t i = 0; i < CONSTANTS_COUNT; i++) {
+        if (name == kUnitConstants[i].name) {
+            term = {static_cast<Constants>(i), 1, 1, 1};
+            return true;
+        }
+    }
+    for (const auto &derived : kDerivedConstants) {
+        if (name == derived.name) {
+            term = derived.term;
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
 void U_I18N_API Factor::multiplyBy(const Factor &rhs) {
     factorNum *= rhs.factorNum;
     factorDen *= rhs.factorDen;
@@ -89,7 +163,7 @@ void U_I18N_API Factor::substituteConstants() {
 
         auto absPower = std::abs(this->constantExponents[i]);
         Signum powerSig = this->constantExponents[i] < 0 ? Signum::NEGATIVE : Signum::POSITIVE;
-        double absConstantValue = std::pow(constantsValues[i], absPower);
+        double absConstantValue = std::pow(kUnitConstants[i].value, absPower);
 
         if (powerSig == Signum::NEGATIVE) {
             this->factorDen *= absConstantValue;
@@ -201,17 +275,14 @@ Factor extractFactorConversions(StringPiece stringFactor, UErrorCode &status) {
 
 // Load factor for a single source
 Factor loadSingleFactor(StringPiece source, const ConversionRates &ratesInfo, UErrorCode &status) {
-    const auto conversionUnit = ratesInfo.extractConversionInfo(source, status);
+    const Factor *factor = ratesInfo.extractFactor(source, status);
     if (U_FAILURE(status)) return Factor();
-    if (conversionUnit == nullptr) {
+    if (factor == nullptr) {
         status = U_INTERNAL_PROGRAM_ERROR;
         return Factor();
     }
 
-    Factor result = extractFactorConversions(conversionUnit->factor.toStringPiece(), status);
-    result.offset = strHasDivideSignToDouble(conversionUnit->offset.toStringPiece(), status);
-
-    return result;
+    return *factor;
 }
 
 // Load Factor of a compound source unit.
@@ -314,47 +385,6 @@ void loadConversionRate(ConversionRate &conversionRate, const MeasureUnitImpl &s
     conversionRate.reciprocal = unitsState == Convertibility::RECIPROCAL;
 }
 
-struct UnitIndexAndDimension : UMemory {
-    int32_t index = 0;
-    int32_t dimensionality = 0;
-
-    UnitIndexAndDimension(const SingleUnitImpl &singleUnit, int32_t multiplier) {
-        index = singleUnit.index;
-        dimensionality = singleUnit.dimensionality * multiplier;
-    }
-};
-
-void mergeSingleUnitWithDimension(MaybeStackVector<UnitIndexAndDimension> &unitIndicesWithDimension,
-                                  const SingleUnitImpl &shouldBeMerged, int32_t multiplier) {
-    for (int32_t i = 0; i < unitIndicesWithDimension.length(); i++) {
-        auto &unitWithIndex = *unitIndicesWithDimension[i];
-        if (unitWithIndex.index == shouldBeMerged.index) {
-            unitWithIndex.dimensionality += shouldBeMerged.dimensionality * multiplier;
-            return;
-        }
-    }
-
-    unitIndicesWithDimension.emplaceBack(shouldBeMerged, multiplier);
-}
-
-void mergeUnitsAndDimensions(MaybeStackVector<UnitIndexAndDimension> &unitIndicesWithDimension,
-                             const MeasureUnitImpl &shouldBeMerged, int32_t multiplier) {
-    for (int32_t unit_i = 0; unit_i < shouldBeMerged.singleUnits.length(); unit_i++) {
-        auto singleUnit = *shouldBeMerged.singleUnits[unit_i];
-        mergeSingleUnitWithDimension(unitIndicesWithDimension, singleUnit, multiplier);
-    }
-}
-
-UBool checkAllDimensionsAreZeros(const MaybeStackVector<UnitIndexAndDimension> &dimensionVector) {
-    for (int32_t i = 0; i < dimensionVector.length(); i++) {
-        if (dimensionVector[i]->dimensionality != 0) {
-            return false;
-        }
-    }
-
-    return true;
-}
-
 } // namespace
 
 // Conceptually, this modifies factor: factor *= baseStr^(signum*power).
@@ -363,33 +393,16 @@ UBool checkAllDimensionsAreZeros(const MaybeStackVector<UnitIndexAndDimension> &
 // parse.
 void U_I18N_API addSingleFactorConstant(StringPiece baseStr, int32_t power, Signum signum,
                                         Factor &factor, UErrorCode &status) {
-    if (baseStr == "ft_to_m") {
-        factor.constantExponents[CONSTANT_FT2M] += power * signum;
-    } else if (baseStr == "ft2_to_m2") {
-        factor.constantExponents[CONSTANT_FT2M] += 2 * power * signum;
-    } else if (baseStr == "ft3_to_m3") {
-        factor.constantExponents[CONSTANT_FT2M] += 3 * power * signum;
-    } else if (baseStr == "in3_to_m3") {
-        factor.constantExponents[CONSTANT_FT2M] += 3 * power * signum;
-        factor.factorDen *= 12 * 12 * 12;
-    } else if (baseStr == "gal_to_m3") {
-        factor.factorNum *= 231;
-        factor.constantExponents[CONSTANT_FT2M] += 3 * power * signum;
-        factor.factorDen *= 12 * 12 * 12;
-    } else if (baseStr == "gal_imp_to_m3") {
-        factor.constantExponents[CONSTANT_GAL_IMP2M3] += power * signum;
-    } else if (baseStr == "G") {
-        factor.constantExponents[CONSTANT_G] += power * signum;
-    } else if (baseStr == "gravity") {
-        factor.constantExponents[CONSTANT_GRAVITY] += power * signum;
-    } else if (baseStr == "lb_to_kg") {
-        factor.constantExponents[CONSTANT_LB2KG] += power * signum;
-    } else if (baseStr == "glucose_molar_mass") {
-        factor.constantExponents[CONSTANT_GLUCOSE_MOLAR_MASS] += power * signum;
-    } else if (baseStr == "item_per_mole") {
-        factor.constantExponents[CONSTANT_ITEM_PER_MOLE] += power * signum;
-    } else if (baseStr == "PI") {
-        factor.constantExponents[CONSTANT_PI] += power * signum;
+    ConstantTerm term;
+    if (findConstant(baseStr, term)) {
+        factor.constantExponents[term.base] += term.power * power * signum;
+        double numerator = std::pow(term.numerator, power);
+        double denominator = std::pow(term.denominator, power);
+        if (signum == Signum::NEGATIVE) {
+            std::swap(numerator, denominator);
+        }
+        factor.factorNum *= numerator;
+        factor.factorDen *= denominator;
     } else {
         if (signum == Signum::NEGATIVE) {
             factor.factorDen *= std::pow(strToDouble(baseStr, status), power);
@@ -399,6 +412,13 @@ void U_I18N_API addSingleFactorConstant(StringPiece baseStr, int32_t power, Sign
     }
 }
 
+Factor U_I18N_API loadFactor(const ConversionRateInfo &rateInfo, UErrorCode &status) {
+    Factor result = extractFactorConversions(rateInfo.factor.toStringPiece(), status);
+    result.offset = strHasDivideSignToDouble(rateInfo.offset.toStringPiece(), status);
+
+    return result;
+}
+
 /**
  * Extracts the compound base unit of a compound unit (`source`). For example, if the source unit is
  * `square-mile-per-hour`, the compound base unit will be `square-meter-per-second`
@@ -415,20 +435,16 @@ MeasureUnitImpl U_I18N_API extractCompoundBaseUnit(const MeasureUnitImpl &source
         const auto &singleUnit = *singleUnits[i];
         // Extract `ConversionRateInfo` using the absolute unit. For example: in case of `square-meter`,
         // we will use `meter`
-        const auto rateInfo =
+        ConversionRateView rateInfo =
             conversionRates.extractConversionInfo(singleUnit.getSimpleUnitID(), status);
         if (U_FAILURE(status)) {
             return result;
         }
-        if (rateInfo == nullptr) {
-            status = U_INTERNAL_PROGRAM_ERROR;
-            return result;
-        }
 
         // Multiply the power of the singleUnit by the power of the baseUnit. For example, square-hectare
         // must be pow4-meter. (NOTE: hectare --> square-meter)
         auto baseUnits =
-            MeasureUnitImpl::forIdentifier(rateInfo->baseUnit.toStringPiece(), status).singleUnits;
+            MeasureUnitImpl::forIdentifier(rateInfo.baseUnit, status).singleUnits;
         for (int32_t i = 0, baseUnitsCount = baseUnits.length(); i < baseUnitsCount; i++) {
             baseUnits[i]->dimensionality *= singleUnit.dimensionality;
             // TODO: Deal with SI-prefix
@@ -456,7 +472,6 @@ MeasureUnitImpl U_I18N_API extractCompoundBaseUnit(const MeasureUnitImpl &source
  */
 Convertibility U_I18N_API extractConvertibility(const MeasureUnitImpl &source,
                                                 const MeasureUnitImpl &target,
-                                                const ConversionRates &conversionRates,
                                                 UErrorCode &status) {
 
     if (source.complexity == UMeasureUnitComplexity::UMEASURE_UNIT_MIXED ||
@@ -465,28 +480,9 @@ Convertibility U_I18N_API extractConvertibility(const MeasureUnitImpl &source,
         return UNCONVERTIBLE;
     }
 
-    MeasureUnitImpl sourceBaseUnit = extractCompoundBaseUnit(source, conversionRates, status);
-    MeasureUnitImpl targetBaseUnit = extractCompoundBaseUnit(target, conversionRates, status);
+    const UnitCategories *categories = UnitCategories::getInstance(status);
     if (U_FAILURE(status)) return UNCONVERTIBLE;
-
-    MaybeStackVector<UnitIndexAndDimension> convertible;
-    MaybeStackVector<UnitIndexAndDimension> reciprocal;
-
-    mergeUnitsAndDimensions(convertible, sourceBaseUnit, 1);
-    mergeUnitsAndDimensions(reciprocal, sourceBaseUnit, 1);
-
-    mergeUnitsAndDimensions(convertible, targetBaseUnit, -1);
-    mergeUnitsAndDimensions(reciprocal, targetBaseUnit, 1);
-
-    if (checkAllDimensionsAreZeros(convertible)) {
-        return CONVERTIBLE;
-    }
-
-    if (checkAllDimensionsAreZeros(reciprocal)) {
-        return RECIPROCAL;
-    }
-
-    return UNCONVERTIBLE;
+    return categories->getConvertibility(source, target, status);
 }
 
 UnitsConverter::UnitsConverter(const MeasureUnitImpl &source, const MeasureUnitImpl &target,
@@ -503,8 +499,11 @@ UnitsConverter::UnitsConverter(StringPiece sourceIdentifier, StringPiece targetI
         return;
     }
 
-    ConversionRates ratesInfo(status);
-    this->init(ratesInfo, status);
+    const ConversionRates *ratesInfo = ConversionRates::getInstance(status);
+    if (U_FAILURE(status)) {
+        return;
+    }
+    this->init(*ratesInfo, status);
 }
 
 void UnitsConverter::init(const ConversionRates &ratesInfo, UErrorCode &status) {
@@ -518,8 +517,8 @@ void UnitsConverter::init(const ConversionRates &ratesInfo, UErrorCode &status)
         return;
     }
 
-    Convertibility unitsState = extractConvertibility(this->conversionRate_.source,
-                                                      this->conversionRate_.target, ratesInfo, status);
+    Convertibility unitsState =
+        extractConvertibility(this->conversionRate_.source, this->conversionRate_.target, status);
     if (U_FAILURE(status)) return;
     if (unitsState == Convertibility::UNCONVERTIBLE) {
         status = U_INTERNAL_PROGRAM_ERROR;
@@ -528,7 +527,21 @@ void UnitsConverter::init(const ConversionRates &ratesInfo, UErrorCode &status)
 
     loadConversionRate(conversionRate_, conversionRate_.source, conversionRate_.target, unitsState,
                        ratesInfo, status);
-                          
+    if (U_FAILURE(status)) {
+        return;
+    }
+
+    linear_.multiplier = conversionRate_.factorNum / conversionRate_.factorDen;
+    linear_.inverseMultiplier = conversionRate_.factorDen / conversionRate_.factorNum;
+    linear_.sourceOffset = conversionRate_.sourceOffset;
+    linear_.targetOffset = conversionRate_.targetOffset;
+    if (conversionRate_.reciprocal) {
+        linear_.kind = KIND_RECIPROCAL;
+    } else if (conversionRate_.sourceOffset == 0 && conversionRate_.targetOffset == 0) {
+        linear_.kind = KIND_SCALE;
+    } else {
+        linear_.kind = KIND_SCALE_OFFSET;
+    }
 }
 
 int32_t UnitsConverter::compareTwoUnits(const MeasureUnitImpl &firstUnit,
@@ -544,7 +557,7 @@ int32_t UnitsConverter::compareTwoUnits(const MeasureUnitImpl &firstUnit,
         return 0;
     }
 
-    Convertibility unitsState = extractConvertibility(firstUnit, secondUnit, ratesInfo, status);
+    Convertibility unitsState = extractConvertibility(firstUnit, secondUnit, status);
     if (U_FAILURE(status)) {
         return 0;
     }
@@ -579,41 +592,88 @@ int32_t UnitsConverter::compareTwoUnits(const MeasureUnitImpl &firstUnit,
 }
 
 double UnitsConverter::convert(double inputValue) const {
-    double result =
-        inputValue + conversionRate_.sourceOffset; // Reset the input to the target zero index.
-    // Convert the quantity to from the source scale to the target scale.
-    result *= conversionRate_.factorNum / conversionRate_.factorDen;
+    return linear_.convert(inputValue);
+}
 
-    result -= conversionRate_.targetOffset; // Set the result to its index.
+double UnitsConverter::convertInverse(double inputValue) const {
+    return linear_.convertInverse(inputValue);
+}
 
-    if (conversionRate_.reciprocal) {
-        if (result == 0) {
-            // TODO: demonstrate the resulting behaviour in tests... and figure
-            // out desired behaviour. (Theoretical result should be infinity,
-            // not 0.)
-            return 0.0;
-        }
-        result = 1.0 / result;
+namespace {
+
+// The loops below compute exactly what UnitsConverter::convert() and
+// UnitsConverter::convertInverse() compute for each element. Each
+// ConverterKind is handled by a separate loop rather than by a branch in the
+// loop body, and the reciprocal zero check is written as selects, so that
+// compilers can vectorize all loops.
+
+void applyScale(const double *input, double *output, int32_t length, double multiplier) {
+    for (int32_t i = 0; i < length; i++) {
+        output[i] = (input[i] + 0.0) * multiplier;
     }
+}
 
-    return result;
+void applyLinear(const double *input, double *output, int32_t length, double addBefore,
+                 double multiplier, double subtractAfter) {
+    for (int32_t i = 0; i < length; i++) {
+        output[i] = (input[i] + addBefore) * multiplier - subtractAfter;
+    }
 }
 
-double UnitsConverter::convertInverse(double inputValue) const {
-    double result = inputValue;
-    if (conversionRate_.reciprocal) {
-        if (result == 0) {
-            // TODO: demonstrate the resulting behaviour in tests... and figure
-            // out desired behaviour. (Theoretical result should be infinity,
-            // not 0.)
-            return 0.0;
-        }
-        result = 1.0 / result;
+void applyLinearReciprocal(const double *input, double *output, int32_t length, double addBefore,
+                           double multiplier, double subtractAfter) {
+    for (int32_t i = 0; i < length; i++) {
+        double result = (input[i] + addBefore) * multiplier - subtractAfter;
+        // The conversion of zero is defined as zero, see convert().
+        double divisor = result == 0 ? 1.0 : result;
+        double reciprocal = 1.0 / divisor;
+        output[i] = result == 0 ? 0.0 : reciprocal;
+    }
+}
+
+void applyReciprocalLinear(const double *input, double *output, int32_t length, double addBefore,
+                           double multiplier, double subtractAfter) {
+    for (int32_t i = 0; i < length; i++) {
+        double value = input[i];
+        double divisor = value == 0 ? 1.0 : value;
+        double result = (1.0 / divisor + addBefore) * multiplier - subtractAfter;
+        // The conversion of zero is defined as zero, see convertInverse().
+        output[i] = value == 0 ? 0.0 : result;
+    }
+}
+
+} // namespace
+
+void UnitsConverter::convertArray(const double *input, double *output, int32_t length) const {
+    switch (linear_.kind) {
+    case KIND_SCALE:
+        applyScale(input, output, length, linear_.multiplier);
+        break;
+    case KIND_SCALE_OFFSET:
+        applyLinear(input, output, length, linear_.sourceOffset, linear_.multiplier,
+                    linear_.targetOffset);
+        break;
+    case KIND_RECIPROCAL:
+        applyLinearReciprocal(input, output, length, linear_.sourceOffset, linear_.multiplier,
+                              linear_.targetOffset);
+        break;
+    }
+}
+
+void UnitsConverter::convertInverseArray(const double *input, double *output, int32_t length) const {
+    switch (linear_.kind) {
+    case KIND_SCALE:
+        applyScale(input, output, length, linear_.inverseMultiplier);
+        break;
+    case KIND_SCALE_OFFSET:
+        applyLinear(input, output, length, linear_.targetOffset, linear_.inverseMultiplier,
+                    linear_.sourceOffset);
+        break;
+    case KIND_RECIPROCAL:
+        applyReciprocalLinear(input, output, length, linear_.targetOffset, linear_.inverseMultiplier,
+                              linear_.sourceOffset);
+        break;
     }
-    result += conversionRate_.targetOffset;
-    result *= conversionRate_.factorDen / conversionRate_.factorNum;
-    result -= conversionRate_.sourceOffset;
-    return result;
 }
 
 ConversionInfo UnitsConverter::getConversionInfo() const {
@@ -627,6 +687,336 @@ ConversionInfo UnitsConverter::getConversionInfo() const {
     return result;
 }
 
+namespace {
+
+using number::impl::DecimalQuantity;
+using number::impl::DecNum;
+
+// Beyond this, additions may round.
+constexpr int32_t kMaxExactAdditionDigits = 1000;
+
+// Multiplies without rounding.
+void multiplyExactly(DecNum &lhs, const DecNum &rhs, UErrorCode &status) {
+    if (U_FAILURE(status)) { return; }
+    lhs.ensureCapacity(lhs.getRawDecNumber()->digits + rhs.getRawDecNumber()->digits, status);
+    lhs.multiplyBy(rhs, status);
+}
+
+// Adds without rounding, unless the result would need more than
+// kMaxExactAdditionDigits digits.
+void addExactly(DecNum &lhs, const DecNum &rhs, UErrorCode &status) {
+    if (U_FAILURE(status)) { return; }
+    const decNumber *a = lhs.getRawDecNumber();
+    const decNumber *b = rhs.getRawDecNumber();
+    int64_t top = std::max((int64_t)a->exponent + a->digits, (int64_t)b->exponent + b->digits);
+    int64_t bottom = std::min(a->exponent, b->exponent);
+    lhs.ensureCapacity((int32_t)std::min(top - bottom + 1, (int64_t)kMaxExactAdditionDigits), status);
+    lhs.add(rhs, status);
+}
+
+/* Represents an exact conversion factor, numerator / denominator */
+struct ExactFactor {
+    DecNum numerator;
+    DecNum denominator;
+
+    ExactFactor(UErrorCode &status) {
+        numerator.setTo("1", status);
+        denominator.setTo("1", status);
+    }
+
+    // Multiplies by (num / den)^power.
+    void multiplyByPower(const DecNum &num, const DecNum &den, int32_t power, UErrorCode &status) {
+        DecNum &thisNum = power < 0 ? denominator : numerator;
+        DecNum &thisDen = power < 0 ? numerator : denominator;
+        for (int32_t i = 0, n = std::abs(power); i < n; i++) {
+            multiplyExactly(thisNum, num, status);
+            multiplyExactly(thisDen, den, status);
+        }
+    }
+
+    void multiplyByPower(const ExactFactor &rhs, int32_t power, UErrorCode &status) {
+        multiplyByPower(rhs.numerator, rhs.denominator, power, status);
+    }
+};
+
+// Sets `numerator` and `denominator` from a number that may have a division
+// sign, e.g. "2E+2/3".
+void parseExactRational(StringPiece str, DecNum &numerator, DecNum &denominator,
+                        UErrorCode &status) {
+    int32_t divisionSignInd = -1;
+    for (int32_t i = 0, n = str.length(); i < n; ++i) {
+        if (str.data()[i] == '/') {
+            divisionSignInd = i;
+            break;
+        }
+    }
+    if (divisionSignInd >= 0) {
+        numerator.setTo(str.substr(0, divisionSignInd), status);
+        denominator.setTo(str.substr(divisionSignInd + 1), status);
+    } else {
+        numerator.setTo(str, status);
+        denominator.setTo("1", status);
+    }
+}
+
+// The exact counterpart of addFactorElement(): factor *= elementStr^signum.
+void addExactFactorElement(ExactFactor &factor, StringPiece elementStr, Signum signum,
+                           UErrorCode &status) {
+    StringPiece baseStr = elementStr;
+    int32_t power = 1;
+    for (int32_t i = 0, n = elementStr.length(); i < n; ++i) {
+        if (elementStr.data()[i] == '^') {
+            baseStr = elementStr.substr(0, i);
+            power = static_cast<int32_t>(strToDouble(elementStr.substr(i + 1), status));
+            break;
+        }
+    }
+
+    DecNum num;
+    DecNum den;
+    ConstantTerm term;
+    if (findConstant(baseStr, term)) {
+        const UnitConstant &constant = kUnitConstants[term.base];
+        num.setTo(constant.numerator, status);
+        den.setTo(constant.denominator, status);
+        factor.multiplyByPower(num, den, term.power * power * signum, status);
+        num.setTo(static_cast<double>(term.numerator), status);
+        den.setTo(static_cast<double>(term.denominator), status);
+    } else {
+        num.setTo(baseStr, status);
+        den.setTo("1", status);
+    }
+    factor.multiplyByPower(num, den, power * signum, status);
+}
+
+// The exact counterpart of extractFactorConversions(). As there, everything
+// after the first '/' is part of the denominator.
+void extractExactFactor(StringPiece stringFactor, ExactFactor &factor, UErrorCode &status) {
+    Signum signum = Signum::POSITIVE;
+    int32_t start = 0;
+    for (int32_t i = 0, n = stringFactor.length(); i <= n; i++) {
+        if (i == n || stringFactor.data()[i] == '*' || stringFactor.data()[i] == '/') {
+            addExactFactorElement(factor, stringFactor.substr(start, i - start), signum, status);
+            start = i + 1;
+            if (i < n && stringFactor.data()[i] == '/') {
+                signum = Signum::NEGATIVE;
+            }
+        }
+    }
+}
+
+// The exact counterpart of loadCompoundFactor(). If `unit` is a simple unit,
+// also sets `offsetNum` / `offsetDen` to its offset.
+void loadExactCompoundFactor(const MeasureUnitImpl &unit, const ConversionRates &ratesInfo,
+                             ExactFactor &factor, DecNum &offsetNum, DecNum &offsetDen,
+                             UErrorCode &status) {
+    offsetNum.setTo("0", status);
+    offsetDen.setTo("1", status);
+    for (int32_t i = 0, n = unit.singleUnits.length(); i < n; i++) {
+        const SingleUnitImpl &singleUnit = *unit.singleUnits[i];
+        ConversionRateView rateInfo =
+            ratesInfo.extractConversionInfo(singleUnit.getSimpleUnitID(), status);
+        if (U_FAILURE(status)) { return; }
+
+        ExactFactor singleFactor(status);
+        extractExactFactor(rateInfo.factor, singleFactor, status);
+
+        // Prefix before power, see loadCompoundFactor().
+        int32_t prefixPower = umeas_getPrefixPower(singleUnit.unitPrefix);
+        if (prefixPower != 0) {
+            DecNum prefixBase;
+            DecNum one;
+            one.setTo("1", status);
+            if (umeas_getPrefixBase(singleUnit.unitPrefix) == 10) {
+                // Exactly 10^prefixPower, without repeated multiplication.
+                CharString prefixStr;
+                prefixStr.append("1E", status).appendNumber(prefixPower, status);
+                prefixBase.setTo(prefixStr.toStringPiece(), status);
+                singleFactor.multiplyByPower(prefixBase, one, 1, status);
+            } else {
+                CharString prefixStr;
+                prefixStr.appendNumber(umeas_getPrefixBase(singleUnit.unitPrefix), status);
+                prefixBase.setTo(prefixStr.toStringPiece(), status);
+                singleFactor.multiplyByPower(prefixBase, one, prefixPower, status);
+            }
+        }
+
+        factor.multiplyByPower(singleFactor, singleUnit.dimensionality, status);
+
+        if (n == 1 && !rateInfo.offset.empty()) {
+            parseExactRational(rateInfo.offset, offsetNum, offsetDen, status);
+        }
+    }
+}
+
+// Sets `value` to the value of `quantity`, which must not be zero.
+void toExactDecNum(DecimalQuantity &quantity, DecNum &value, UErrorCode &status) {
+    // Use the shortest representation of the value, rather than all the
+    // digits of the double it may have been set from.
+    quantity.roundToInfinity();
+    quantity.toDecNum(value, status);
+}
+
+} // namespace
+
+ExactUnitsConverter::ExactUnitsConverter(StringPiece sourceIdentifier,
+                                         StringPiece targetIdentifier, UErrorCode &status) {
+    MeasureUnitImpl source = MeasureUnitImpl::forIdentifier(sourceIdentifier, status);
+    MeasureUnitImpl target = MeasureUnitImpl::forIdentifier(targetIdentifier, status);
+    const ConversionRates *ratesInfo = ConversionRates::getInstance(status);
+    if (U_FAILURE(status)) {
+        return;
+    }
+    init(source, target, *ratesInfo, status);
+}
+
+ExactUnitsConverter::ExactUnitsConverter(const MeasureUnitImpl &source,
+                                         const MeasureUnitImpl &target,
+                                         const ConversionRates &ratesInfo, UErrorCode &status) {
+    init(source, target, ratesInfo, status);
+}
+
+void ExactUnitsConverter::init(const MeasureUnitImpl &source, const MeasureUnitImpl &target,
+                               const ConversionRates &ratesInfo, UErrorCode &status) {
+    if (U_FAILURE(status)) {
+        return;
+    }
+
+    if (source.complexity == UMeasureUnitComplexity::UMEASURE_UNIT_MIXED ||
+        target.complexity == UMeasureUnitComplexity::UMEASURE_UNIT_MIXED) {
+        status = U_INTERNAL_PROGRAM_ERROR;
+        return;
+    }
+
+    Convertibility unitsState = extractConvertibility(source, target, status);
+    if (U_FAILURE(status)) return;
+    if (unitsState == Convertibility::UNCONVERTIBLE) {
+        status = U_INTERNAL_PROGRAM_ERROR;
+        return;
+    }
+
+    ExactFactor sourceToBase(status);
+    ExactFactor targetToBase(status);
+    DecNum sourceOffsetNum, sourceOffsetDen, targetOffsetNum, targetOffsetDen;
+    loadExactCompoundFactor(source, ratesInfo, sourceToBase, sourceOffsetNum, sourceOffsetDen,
+                            status);
+    loadExactCompoundFactor(target, ratesInfo, targetToBase, targetOffsetNum, targetOffsetDen,
+                            status);
+    offset_.setTo("0", status);
+    negatedOffset_.setTo("0", status);
+    if (U_FAILURE(status)) {
+        return;
+    }
+
+    reciprocal_ = unitsState == Convertibility::RECIPROCAL;
+    if (reciprocal_) {
+        // target = 1 / (source * sourceToBase * targetToBase)
+        numerator_.setTo("1", status);
+        multiplyExactly(numerator_, sourceToBase.numerator, status);
+        multiplyExactly(numerator_, targetToBase.numerator, status);
+        denominator_.setTo("1", status);
+        multiplyExactly(denominator_, sourceToBase.denominator, status);
+        multiplyExactly(denominator_, targetToBase.denominator, status);
+        return;
+    }
+
+    // base = source * sourceToBase + sourceOffset
+    //      = target * targetToBase + targetOffset
+    // Hence, with sN/sD = sourceToBase, tN/tD = targetToBase, sON/sOD =
+    // sourceOffset and tON/tOD = targetOffset:
+    // target = (source * sN*tD*sOD*tOD + (sON*tOD - tON*sOD)*sD*tD) / (sD*tN*sOD*tOD)
+    numerator_.setTo("1", status);
+    multiplyExactly(numerator_, sourceToBase.numerator, status);
+    multiplyExactly(numerator_, targetToBase.denominator, status);
+    denominator_.setTo("1", status);
+    multiplyExactly(denominator_, sourceToBase.denominator, status);
+    multiplyExactly(denominator_, targetToBase.numerator, status);
+
+    // Offsets are only considered between simple units, see loadConversionRate().
+    if (checkSimpleUnit(source, status) && checkSimpleUnit(target, status)) {
+        multiplyExactly(numerator_, sourceOffsetDen, status);
+        multiplyExactly(numerator_, targetOffsetDen, status);
+        multiplyExactly(denominator_, sourceOffsetDen, status);
+        multiplyExactly(denominator_, targetOffsetDen, status);
+
+        DecNum minusOne;
+        minusOne.setTo("-1", status);
+        DecNum targetTerm(targetOffsetNum, status);
+        multiplyExactly(targetTerm, sourceOffsetDen, status);
+        multiplyExactly(targetTerm, minusOne, status);
+        offset_.setTo("0", status);
+        addExactly(offset_, sourceOffsetNum, status);
+        multiplyExactly(offset_, targetOffsetDen, status);
+        addExactly(offset_, targetTerm, status);
+        multiplyExactly(offset_, sourceToBase.denominator, status);
+        multiplyExactly(offset_, targetToBase.denominator, status);
+
+        negatedOffset_.setTo("0", status);
+        addExactly(negatedOffset_, offset_, status);
+        multiplyExactly(negatedOffset_, minusOne, status);
+        hasOffset_ = !offset_.isZero();
+    }
+}
+
+void ExactUnitsConverter::convert(DecimalQuantity &quantity, UErrorCode &status) const {
+    if (U_FAILURE(status)) {
+        return;
+    }
+    DecNum value;
+    if (quantity.isZeroish()) {
+        if (reciprocal_) {
+            // See UnitsConverter::convert().
+            return;
+        }
+        value.setTo("0", status);
+    } else {
+        toExactDecNum(quantity, value, status);
+    }
+    multiplyExactly(value, numerator_, status);
+    if (hasOffset_) {
+        addExactly(value, offset_, status);
+    }
+    if (reciprocal_) {
+        DecNum result(denominator_, status);
+        result.divideBy(value, status);
+        quantity.setToDecNum(result, status);
+    } else {
+        value.divideBy(denominator_, status);
+        quantity.setToDecNum(value, status);
+    }
+}
+
+void ExactUnitsConverter::convertInverse(DecimalQuantity &quantity, UErrorCode &status) const {
+    if (U_FAILURE(status)) {
+        return;
+    }
+    DecNum value;
+    if (quantity.isZeroish()) {
+        if (reciprocal_) {
+            // See UnitsConverter::convertInverse().
+            return;
+        }
+        value.setTo("0", status);
+    } else {
+        toExactDecNum(quantity, value, status);
+    }
+    if (reciprocal_) {
+        // source = 1 / (target * numerator_ / denominator_)
+        multiplyExactly(value, numerator_, status);
+        DecNum result(denominator_, status);
+        result.divideBy(value, status);
+        quantity.setToDecNum(result, status);
+    } else {
+        // source = (target * denominator_ - offset_) / numerator_
+        multiplyExactly(value, denominator_, status);
+        if (hasOffset_) {
+            addExactly(value, negatedOffset_, status);
+        }
+        value.divideBy(numerator_, status);
+        quantity.setToDecNum(value, status);
+    }
+}
+
 } // namespace units
 U_NAMESPACE_END
 
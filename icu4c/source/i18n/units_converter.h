@@ -9,6 +9,7 @@
 
 #include "cmemory.h"
 #include "measunit_impl.h"
+#include "number_decnum.h"
 #include "unicode/errorcode.h"
 #include "unicode/stringpiece.h"
 #include "unicode/uobject.h"
@@ -16,11 +17,20 @@
 #include "units_data.h"
 
 U_NAMESPACE_BEGIN
+
+namespace number {
+namespace impl {
+class DecimalQuantity;
+} // namespace impl
+} // namespace number
+
 namespace units {
 
 /* Internal Structure */
 
-// Constants corresponding to unitConstants in CLDR's units.xml.
+// Constants corresponding to unitConstants in CLDR's units.xml. Their names
+// and values are defined in units_converter.cpp, in a table indexed by this
+// enum.
 enum Constants {
     CONSTANT_FT2M,       // ft_to_m
     CONSTANT_PI,         // PI
@@ -35,29 +45,13 @@ enum Constants {
     CONSTANTS_COUNT
 };
 
-// These values are a hard-coded subset of unitConstants in the units
-// resources file. A unit test checks that all constants in the resource
-// file are at least recognised by the code. Derived constants' values or
-// hard-coded derivations are not checked.
-// In ICU4J, these constants live in UnitConverter.Factor.getConversionRate().
-static const double constantsValues[CONSTANTS_COUNT] = {
-    0.3048,                    // CONSTANT_FT2M
-    411557987.0 / 131002976.0, // CONSTANT_PI
-    9.80665,                   // CONSTANT_GRAVITY
-    6.67408E-11,               // CONSTANT_G
-    0.00454609,                // CONSTANT_GAL_IMP2M3
-    0.45359237,                // CONSTANT_LB2KG
-    180.1557,                  // CONSTANT_GLUCOSE_MOLAR_MASS
-    6.02214076E+23,            // CONSTANT_ITEM_PER_MOLE
-};
-
 typedef enum Signum {
     NEGATIVE = -1,
     POSITIVE = 1,
 } Signum;
 
 /* Represents a conversion factor */
-struct U_I18N_API Factor {
+struct U_I18N_API Factor : public UMemory {
     double factorNum = 1;
     double factorDen = 1;
     double offset = 0;
@@ -94,6 +88,15 @@ struct U_I18N_API ConversionInfo {
 void U_I18N_API addSingleFactorConstant(StringPiece baseStr, int32_t power, Signum sigNum,
                                         Factor &factor, UErrorCode &status);
 
+/**
+ * Parses the factor and offset strings of `rateInfo` into a `Factor`. Symbolic
+ * constants are kept as exponents: see `Factor::substituteConstants()`.
+ *
+ * ConversionRates does this once per unit when loading the data: prefer
+ * `ConversionRates::extractFactor()` over calling this function.
+ */
+Factor U_I18N_API loadFactor(const ConversionRateInfo &rateInfo, UErrorCode &status);
+
 /**
  * Represents the conversion rate between `source` and `target`.
  */
@@ -110,10 +113,68 @@ struct U_I18N_API ConversionRate : public UMemory {
         : source(std::move(source)), target(std::move(target)) {}
 };
 
-enum Convertibility {
-    RECIPROCAL,
-    CONVERTIBLE,
-    UNCONVERTIBLE,
+/**
+ * The kind of a conversion between two units, decided once when the converter
+ * is constructed, so that converting a value needs no tests of the conversion
+ * rate.
+ */
+enum ConverterKind {
+    // x * multiplier: most conversions, e.g. meter to foot.
+    KIND_SCALE,
+    // (x + sourceOffset) * multiplier - targetOffset, e.g. celsius to fahrenheit.
+    KIND_SCALE_OFFSET,
+    // The reciprocal of KIND_SCALE_OFFSET, e.g. liter-per-100-kilometer to
+    // mile-per-gallon.
+    KIND_RECIPROCAL,
+};
+
+/**
+ * A `ConversionRate` reduced to what converting a value needs: the kind of the
+ * conversion and its precomputed factors. Small enough to be held by value.
+ */
+struct U_I18N_API LinearConversion {
+    ConverterKind kind = KIND_SCALE;
+    double multiplier = 1;
+    double inverseMultiplier = 1;
+    double sourceOffset = 0;
+    double targetOffset = 0;
+
+    // See UnitsConverter::convert().
+    inline double convert(double inputValue) const {
+        switch (kind) {
+        case KIND_SCALE:
+            // Adding zero turns -0 into 0, as adding a zero offset does.
+            return (inputValue + 0.0) * multiplier;
+        case KIND_SCALE_OFFSET:
+            return (inputValue + sourceOffset) * multiplier - targetOffset;
+        default: {
+            double result = (inputValue + sourceOffset) * multiplier - targetOffset;
+            if (result == 0) {
+                // TODO: demonstrate the resulting behaviour in tests... and
+                // figure out desired behaviour. (Theoretical result should be
+                // infinity, not 0.)
+                return 0.0;
+            }
+            return 1.0 / result;
+        }
+        }
+    }
+
+    // See UnitsConverter::convertInverse().
+    inline double convertInverse(double inputValue) const {
+        switch (kind) {
+        case KIND_SCALE:
+            return (inputValue + 0.0) * inverseMultiplier;
+        case KIND_SCALE_OFFSET:
+            return (inputValue + targetOffset) * inverseMultiplier - sourceOffset;
+        default:
+            if (inputValue == 0) {
+                // See convert().
+                return 0.0;
+            }
+            return (1.0 / inputValue + targetOffset) * inverseMultiplier - sourceOffset;
+        }
+    }
 };
 
 MeasureUnitImpl U_I18N_API extractCompoundBaseUnit(const MeasureUnitImpl &source,
@@ -127,13 +188,14 @@ MeasureUnitImpl U_I18N_API extractCompoundBaseUnit(const MeasureUnitImpl &source
  *    `meter-per-second` and `second-per-meter` are `RECIPROCAL`.
  *    `meter` and `pound` are `UNCONVERTIBLE`.
  *
+ * This compares the dimensions of the units, see UnitCategories::getConvertibility().
+ *
  * NOTE:
  *    Only works with SINGLE and COMPOUND units. If one of the units is a
  *    MIXED unit, an error will occur. For more information, see UMeasureUnitComplexity.
  */
 Convertibility U_I18N_API extractConvertibility(const MeasureUnitImpl &source,
                                                 const MeasureUnitImpl &target,
-                                                const ConversionRates &conversionRates,
                                                 UErrorCode &status);
 
 /**
@@ -151,7 +213,8 @@ class U_I18N_API UnitsConverter : public UMemory {
      *   - source and target must be under the same category
      *      - e.g. meter to mile --> both of them are length units.
      * NOTE:
-     *    This constructor creates an instance of `ConversionRates` internally.
+     *    This constructor uses the shared instance of `ConversionRates`, see
+     *    `ConversionRates::getInstance()`.
      *
      * @param sourceIdentifier represents the source unit identifier.
      * @param targetIdentifier represents the target unit identifier.
@@ -201,17 +264,119 @@ class U_I18N_API UnitsConverter : public UMemory {
      */
     double convertInverse(double inputValue) const;
 
+    /**
+     * Converts `length` measurements expressed in the source unit to the
+     * target unit. Equivalent to calling convert() on each element, but
+     * without per-element branching, so that the loop can be vectorized.
+     *
+     * @param input the values to be converted.
+     * @param output receives the converted values. May be the same as
+     * `input`, but must not otherwise overlap it.
+     * @param length the number of values in `input` and `output`.
+     */
+    void convertArray(const double *input, double *output, int32_t length) const;
+
+    /**
+     * The inverse of convertArray(): equivalent to calling convertInverse()
+     * on each element.
+     *
+     * @param input the values to be converted.
+     * @param output receives the converted values. May be the same as
+     * `input`, but must not otherwise overlap it.
+     * @param length the number of values in `input` and `output`.
+     */
+    void convertInverseArray(const double *input, double *output, int32_t length) const;
+
     ConversionInfo getConversionInfo() const;
 
+    /**
+     * The kind and factors of this conversion, for converters that hold
+     * several conversions inline, such as `ComplexUnitsConverter`.
+     */
+    const LinearConversion &getLinearConversion() const { return linear_; }
+
   private:
     ConversionRate conversionRate_;
 
+    // Computed from conversionRate_ by init(): convert() only uses this.
+    LinearConversion linear_;
+
     /**
      * Initialises the object.
      */ 
     void init(const ConversionRates &ratesInfo, UErrorCode &status);
 };
 
+/**
+ * Converts `DecimalQuantity` values from a source `MeasureUnit` to a target
+ * `MeasureUnit` with decimal arithmetic.
+ *
+ * Unlike `UnitsConverter`, which collapses the conversion rate into doubles,
+ * this class keeps the numerator and denominator of the conversion rate as
+ * exact decimal numbers, with the symbolic constants replaced by their exact
+ * decimal values. Conversions such as foot to inch or gallon to liter are thus
+ * exact: only the final division rounds, to at least 34 significant digits.
+ *
+ * Converting is much slower than `UnitsConverter::convert()`: see
+ * TestConvertExact in the unitsperf performance test.
+ *
+ * NOTE:
+ *    Only works with SINGLE and COMPOUND units, like `UnitsConverter`.
+ */
+class U_I18N_API ExactUnitsConverter : public UMemory {
+  public:
+    /**
+     * Constructor of `ExactUnitsConverter`.
+     * NOTE:
+     *    This constructor uses the shared instance of `ConversionRates`, see
+     *    `ConversionRates::getInstance()`.
+     *
+     * @param sourceIdentifier represents the source unit identifier.
+     * @param targetIdentifier represents the target unit identifier.
+     * @param status
+     */
+    ExactUnitsConverter(StringPiece sourceIdentifier, StringPiece targetIdentifier,
+                        UErrorCode &status);
+
+    /**
+     * Constructor of `ExactUnitsConverter`.
+     *
+     * @param source represents the source unit.
+     * @param target represents the target unit.
+     * @param ratesInfo Contains all the needed conversion rates.
+     * @param status
+     */
+    ExactUnitsConverter(const MeasureUnitImpl &source, const MeasureUnitImpl &target,
+                        const ConversionRates &ratesInfo, UErrorCode &status);
+
+    /**
+     * Converts `quantity`, expressed in the source unit, in place to the
+     * target unit.
+     */
+    void convert(number::impl::DecimalQuantity &quantity, UErrorCode &status) const;
+
+    /**
+     * The inverse of convert(): converts `quantity`, expressed in the target
+     * unit, in place to the source unit.
+     */
+    void convertInverse(number::impl::DecimalQuantity &quantity, UErrorCode &status) const;
+
+  private:
+    // The conversion computes (value * numerator_ + offset_) / denominator_,
+    // and takes the reciprocal of that if reciprocal_ is set. offset_ is zero
+    // for reciprocal conversions.
+    number::impl::DecNum numerator_;
+    number::impl::DecNum denominator_;
+    number::impl::DecNum offset_;
+    // -offset_, for convertInverse().
+    number::impl::DecNum negatedOffset_;
+    bool hasOffset_ = false;
+    bool reciprocal_ = false;
+
+    void init(const MeasureUnitImpl &source, const MeasureUnitImpl &target,
+              const ConversionRates &ratesInfo, UErrorCode &status);
+};
+
 } // namespace units
 U_NAMESPACE_END
 
@@ -6,12 +6,22 @@
 #if !UCONFIG_NO_FORMATTING
 
 #include "cstring.h"
+#include "measunit_impl.h"
 #include "number_decimalquantity.h"
 #include "resource.h"
+#include "uarrsort.h"
 #include "uassert.h"
+#include "ucln_in.h"
+#include "umutex.h"
+#include "unicode/bytestrie.h"
+#include "unicode/bytestriebuilder.h"
+#include "unicode/localpointer.h"
 #include "unicode/unistr.h"
 #include "unicode/ures.h"
+#include "unicode/ustringtrie.h"
+#include "units_converter.h"
 #include "units_data.h"
+#include "units_prebuilt.h"
 #include "uresimp.h"
 #include "util.h"
 #include <utility>
@@ -228,100 +238,147 @@ class UnitPreferencesSink : public ResourceSink {
     MaybeStackVector<UnitPreferenceMetadata> *metadata;
 };
 
-int32_t binarySearch(const MaybeStackVector<UnitPreferenceMetadata> *metadata,
-                     const UnitPreferenceMetadata &desired, bool *foundCategory, bool *foundUsage,
-                     bool *foundRegion, UErrorCode &status) {
-    if (U_FAILURE(status)) { return -1; }
-    int32_t start = 0;
-    int32_t end = metadata->length();
-    *foundCategory = false;
-    *foundUsage = false;
-    *foundRegion = false;
-    while (start < end) {
-        int32_t mid = (start + end) / 2;
-        int32_t cmp = (*metadata)[mid]->compareTo(desired, foundCategory, foundUsage, foundRegion);
-        if (cmp < 0) {
-            start = mid + 1;
-        } else if (cmp > 0) {
-            end = mid;
-        } else {
-            return mid;
-        }
+/**
+ * Loads all conversion rates from the "units" resource bundle, parses their
+ * factors, and adds each source unit to `builder`, with the index of its
+ * conversion rate as value.
+ *
+ * @return The serialized index trie, owned by `builder`.
+ */
+StringPiece buildConversionRates(MaybeStackVector<ConversionRateInfo> &conversionInfo,
+                                 MaybeStackVector<Factor> &factors, BytesTrieBuilder &builder,
+                                 UErrorCode &status) {
+    getAllConversionRates(conversionInfo, status);
+    if (U_FAILURE(status)) { return StringPiece(); }
+
+    for (int32_t i = 0, n = conversionInfo.length(); i < n; ++i) {
+        const ConversionRateInfo &info = *conversionInfo[i];
+        builder.add(info.sourceUnit.toStringPiece(), i, status);
+        factors.emplaceBackAndCheckErrorCode(status, loadFactor(info, status));
+        if (U_FAILURE(status)) { return StringPiece(); }
     }
-    return -1;
+    return builder.buildStringPiece(USTRINGTRIE_BUILD_FAST, status);
 }
 
 /**
- * Finds the UnitPreferenceMetadata instance that matches the given category,
- * usage and region: if missing, region falls back to "001", and usage
- * repeatedly drops tailing components, eventually trying "default"
- * ("land-agriculture-grain" -> "land-agriculture" -> "land" -> "default").
- *
- * @param metadata The full list of UnitPreferenceMetadata instances.
- * @param category The category to search for. See getUnitCategory().
- * @param usage The usage for which formatting preferences is needed. If the
- * given usage is not known, automatic fallback occurs, see function description
- * above.
- * @param region The region for which preferences are needed. If there are no
- * region-specific preferences, this function automatically falls back to the
- * "001" region (global).
- * @param status The standard ICU error code output parameter.
- *   * If an invalid category is given, status will be U_ILLEGAL_ARGUMENT_ERROR.
- *   * If fallback to "default" or "001" didn't resolve, status will be
- *     U_MISSING_RESOURCE.
- * @return The index into the metadata vector which represents the appropriate
- * preferences. If appropriate preferences are not found, -1 is returned.
+ * Loads the parsed factors of all conversion rates from units.icu. The strings
+ * of the conversion rates are not copied: see extractConversionInfo().
  */
-int32_t getPreferenceMetadataIndex(const MaybeStackVector<UnitPreferenceMetadata> *metadata,
-                                   StringPiece category, StringPiece usage, StringPiece region,
-                                   UErrorCode &status) {
-    if (U_FAILURE(status)) { return -1; }
-    bool foundCategory, foundUsage, foundRegion;
-    UnitPreferenceMetadata desired(category, usage, region, -1, -1, status);
-    int32_t idx = binarySearch(metadata, desired, &foundCategory, &foundUsage, &foundRegion, status);
-    if (U_FAILURE(status)) { return -1; }
-    if (idx >= 0) { return idx; }
-    if (!foundCategory) {
-        // TODO: failures can happen if units::getUnitCategory returns a category
-        // that does not appear in unitPreferenceData. Do we want a unit test that
-        // checks unitPreferenceData has full coverage of categories? Or just trust
-        // CLDR?
-        status = U_ILLEGAL_ARGUMENT_ERROR;
-        return -1;
+void loadPrebuiltFactors(const PrebuiltUnitsData &data, MaybeStackVector<Factor> &factors,
+                         UErrorCode &status) {
+    for (int32_t i = 0, n = data.getConversionRatesCount(); i < n; ++i) {
+        Factor *factor = factors.emplaceBackAndCheckErrorCode(status);
+        if (U_FAILURE(status)) { return; }
+        const double *values = data.getFactorValues(i);
+        factor->factorNum = values[0];
+        factor->factorDen = values[1];
+        factor->offset = values[2];
+        const int32_t *exponents = data.getFactorExponents(i);
+        factor->reciprocal = exponents[0] != 0;
+        for (int32_t j = 0; j < CONSTANTS_COUNT; ++j) {
+            factor->constantExponents[j] = exponents[1 + j];
+        }
     }
-    U_ASSERT(foundCategory);
-    while (!foundUsage) {
-        int32_t lastDashIdx = desired.usage.lastIndexOf('-');
-        if (lastDashIdx > 0) {
-            desired.usage.truncate(lastDashIdx);
-        } else if (uprv_strcmp(desired.usage.data(), "default") != 0) {
-            desired.usage.truncate(0).append("default", status);
-        } else {
-            // "default" is not supposed to be missing for any valid category.
-            status = U_MISSING_RESOURCE_ERROR;
-            return -1;
+}
+
+/**
+ * Assigns indexes into UnitDimensions to the base units, in the order in which
+ * they are first seen.
+ */
+class BaseUnits {
+  public:
+    // Multiplies `result` by the base unit `identifier`, such as
+    // "kilogram-meter-per-square-second".
+    void multiplyDimensions(StringPiece identifier, UnitDimensions &result, UErrorCode &status) {
+        MeasureUnitImpl impl = MeasureUnitImpl::forIdentifier(identifier, status);
+        if (U_FAILURE(status)) { return; }
+        for (int32_t i = 0; i < impl.singleUnits.length(); i++) {
+            const SingleUnitImpl &singleUnit = *impl.singleUnits[i];
+            int32_t baseUnit = indexOf(singleUnit, status);
+            if (U_FAILURE(status)) { return; }
+            if (singleUnit.dimensionality > 0) {
+                result.numerator[baseUnit] += singleUnit.dimensionality;
+            } else {
+                result.denominator[baseUnit] -= singleUnit.dimensionality;
+            }
         }
-        idx = binarySearch(metadata, desired, &foundCategory, &foundUsage, &foundRegion, status);
-        if (U_FAILURE(status)) { return -1; }
-    }
-    U_ASSERT(foundCategory);
-    U_ASSERT(foundUsage);
-    if (!foundRegion) {
-        if (uprv_strcmp(desired.region.data(), "001") != 0) {
-            desired.region.truncate(0).append("001", status);
-            idx = binarySearch(metadata, desired, &foundCategory, &foundUsage, &foundRegion, status);
+    }
+
+  private:
+    // The simple unit and prefix of each base unit: base units are coalesced
+    // like in MeasureUnitImpl::appendSingleUnit(), apart from the sign of the
+    // dimensionality.
+    int32_t indexes_[kMaxBaseUnits];
+    UMeasurePrefix prefixes_[kMaxBaseUnits];
+    int32_t count_ = 0;
+
+    int32_t indexOf(const SingleUnitImpl &singleUnit, UErrorCode &status) {
+        for (int32_t i = 0; i < count_; i++) {
+            if (indexes_[i] == singleUnit.index && prefixes_[i] == singleUnit.unitPrefix) {
+                return i;
+            }
         }
-        if (!foundRegion) {
-            // "001" is not supposed to be missing for any valid usage.
-            status = U_MISSING_RESOURCE_ERROR;
+        if (count_ == kMaxBaseUnits) {
+            // The units data has more base units than kMaxBaseUnits.
+            status = U_INTERNAL_PROGRAM_ERROR;
             return -1;
         }
+        indexes_[count_] = singleUnit.index;
+        prefixes_[count_] = singleUnit.unitPrefix;
+        return count_++;
     }
-    U_ASSERT(foundCategory);
-    U_ASSERT(foundUsage);
-    U_ASSERT(foundRegion);
-    U_ASSERT(idx >= 0);
-    return idx;
+};
+
+int32_t U_CALLCONV compareDimensions(const void *context, const void *left, const void *right) {
+    const UnitDimensions *dimensions = static_cast<const UnitDimensions *>(context);
+    return dimensions[*static_cast<const int32_t *>(left)].compareTo(
+        dimensions[*static_cast<const int32_t *>(right)]);
+}
+
+icu::UInitOnce gConversionRatesInitOnce = U_INITONCE_INITIALIZER;
+icu::UInitOnce gUnitPreferencesInitOnce = U_INITONCE_INITIALIZER;
+icu::UInitOnce gUnitCategoriesInitOnce = U_INITONCE_INITIALIZER;
+
+// Shared instances, see ConversionRates::getInstance(),
+// UnitPreferences::getInstance() and UnitCategories::getInstance().
+const ConversionRates *gConversionRates = nullptr;
+const UnitPreferences *gUnitPreferences = nullptr;
+const UnitCategories *gUnitCategories = nullptr;
+
+UBool U_CALLCONV cleanupUnitsData() {
+    delete gConversionRates;
+    gConversionRates = nullptr;
+    gConversionRatesInitOnce.reset();
+    delete gUnitPreferences;
+    gUnitPreferences = nullptr;
+    gUnitPreferencesInitOnce.reset();
+    delete gUnitCategories;
+    gUnitCategories = nullptr;
+    gUnitCategoriesInitOnce.reset();
+    return TRUE;
+}
+
+void U_CALLCONV initConversionRates(UErrorCode &status) {
+    ucln_i18n_registerCleanup(UCLN_I18N_UNITS_DATA, cleanupUnitsData);
+    LocalPointer<ConversionRates> rates(new ConversionRates(status), status);
+    if (U_FAILURE(status)) { return; }
+    gConversionRates = rates.orphan();
+}
+
+void U_CALLCONV initUnitPreferences(UErrorCode &status) {
+    ucln_i18n_registerCleanup(UCLN_I18N_UNITS_DATA, cleanupUnitsData);
+    LocalPointer<UnitPreferences> prefs(new UnitPreferences(status), status);
+    if (U_FAILURE(status)) { return; }
+    gUnitPreferences = prefs.orphan();
+}
+
+void U_CALLCONV initUnitCategories(UErrorCode &status) {
+    ucln_i18n_registerCleanup(UCLN_I18N_UNITS_DATA, cleanupUnitsData);
+    const ConversionRates *rates = ConversionRates::getInstance(status);
+    if (U_FAILURE(status)) { return; }
+    LocalPointer<UnitCategories> categories(new UnitCategories(*rates, status), status);
+    if (U_FAILURE(status)) { return; }
+    gUnitCategories = categories.orphan();
 }
 
 } // namespace
@@ -347,23 +404,6 @@ int32_t UnitPreferenceMetadata::compareTo(const UnitPreferenceMetadata &other) c
     return cmp;
 }
 
-int32_t UnitPreferenceMetadata::compareTo(const UnitPreferenceMetadata &other, bool *foundCategory,
-                                          bool *foundUsage, bool *foundRegion) const {
-    int32_t cmp = uprv_strcmp(category.data(), other.category.data());
-    if (cmp == 0) {
-        *foundCategory = true;
-        cmp = uprv_strcmp(usage.data(), other.usage.data());
-    }
-    if (cmp == 0) {
-        *foundUsage = true;
-        cmp = uprv_strcmp(region.data(), other.region.data());
-    }
-    if (cmp == 0) {
-        *foundRegion = true;
-    }
-    return cmp;
-}
-
 // TODO: this may be unnecessary. Fold into ConversionRates class? Or move to anonymous namespace?
 void U_I18N_API getAllConversionRates(MaybeStackVector<ConversionRateInfo> &result, UErrorCode &status) {
     LocalUResourceBundlePointer unitsBundle(ures_openDirect(NULL, "units", &status));
@@ -371,20 +411,392 @@ void U_I18N_API getAllConversionRates(MaybeStackVector<ConversionRateInfo> &resu
     ures_getAllItemsWithFallback(unitsBundle.getAlias(), "convertUnits", sink, status);
 }
 
-const ConversionRateInfo *ConversionRates::extractConversionInfo(StringPiece source,
-                                                                 UErrorCode &status) const {
-    for (size_t i = 0, n = conversionInfo_.length(); i < n; ++i) {
-        if (conversionInfo_[i]->sourceUnit.toStringPiece() == source) return conversionInfo_[i];
+void U_I18N_API buildPrebuiltUnitsData(CharString &out, UErrorCode &status) {
+    PrebuiltUnitsDataBuilder builder(CONSTANTS_COUNT);
+    addUnitExtrasToPrebuiltData(builder, status);
+
+    MaybeStackVector<ConversionRateInfo> conversionInfo;
+    MaybeStackVector<Factor> factors;
+    BytesTrieBuilder trieBuilder(status);
+    StringPiece index = buildConversionRates(conversionInfo, factors, trieBuilder, status);
+    if (U_FAILURE(status)) { return; }
+    builder.setConversionRatesTrie(index, status);
+    for (int32_t i = 0, n = conversionInfo.length(); i < n; ++i) {
+        const ConversionRateInfo &info = *conversionInfo[i];
+        const Factor &factor = *factors[i];
+        StringPiece strings[UNITS_RATE_STRINGS_COUNT];
+        strings[UNITS_RATE_SOURCE_UNIT] = info.sourceUnit.toStringPiece();
+        strings[UNITS_RATE_BASE_UNIT] = info.baseUnit.toStringPiece();
+        strings[UNITS_RATE_FACTOR] = info.factor.toStringPiece();
+        strings[UNITS_RATE_OFFSET] = info.offset.toStringPiece();
+        double values[] = {factor.factorNum, factor.factorDen, factor.offset};
+        builder.addConversionRate(strings, values, factor.reciprocal, factor.constantExponents, status);
     }
+    builder.build(out, status);
+}
+
+ConversionRates::ConversionRates(UErrorCode &status) {
+    const PrebuiltUnitsData *prebuilt = PrebuiltUnitsData::getInstance(status);
+    if (U_FAILURE(status)) { return; }
 
-    status = U_INTERNAL_PROGRAM_ERROR;
-    return nullptr;
+    if (prebuilt != nullptr && prebuilt->getConstantsCount() == CONSTANTS_COUNT) {
+        // units.icu stays loaded until u_cleanup(): use its strings and trie
+        // in place.
+        loadPrebuiltFactors(*prebuilt, factors_, status);
+        if (U_FAILURE(status)) { return; }
+        prebuilt_ = prebuilt;
+        index_ = prebuilt->getConversionRatesTrie().data();
+        return;
+    }
+
+    BytesTrieBuilder builder(status);
+    StringPiece index = buildConversionRates(conversionInfo_, factors_, builder, status);
+    if (U_FAILURE(status)) { return; }
+
+    // Copy the trie, so that it does not depend on the lifetime of builder.
+    if (serializedIndex_.allocateInsteadAndReset(index.length()) == nullptr) {
+        status = U_MEMORY_ALLOCATION_ERROR;
+        return;
+    }
+    uprv_memcpy(serializedIndex_.getAlias(), index.data(), index.length());
+    index_ = serializedIndex_.getAlias();
+}
+
+ConversionRates::~ConversionRates() = default;
+
+int32_t ConversionRates::indexOf(StringPiece source) const {
+    if (index_ == nullptr) { return -1; }
+    BytesTrie trie(index_);
+    UStringTrieResult result = trie.next(source.data(), source.length());
+    if (!USTRINGTRIE_HAS_VALUE(result)) { return -1; }
+    return trie.getValue();
+}
+
+const ConversionRates *ConversionRates::getInstance(UErrorCode &status) {
+    umtx_initOnce(gConversionRatesInitOnce, &initConversionRates, status);
+    if (U_FAILURE(status)) { return nullptr; }
+    return gConversionRates;
+}
+
+ConversionRateView ConversionRates::extractConversionInfo(StringPiece source,
+                                                          UErrorCode &status) const {
+    ConversionRateView result;
+    if (U_FAILURE(status)) { return result; }
+    int32_t idx = indexOf(source);
+    if (idx < 0) {
+        status = U_INTERNAL_PROGRAM_ERROR;
+        return result;
+    }
+    if (prebuilt_ != nullptr) {
+        result.sourceUnit = prebuilt_->getRateString(idx, UNITS_RATE_SOURCE_UNIT);
+        result.baseUnit = prebuilt_->getRateString(idx, UNITS_RATE_BASE_UNIT);
+        result.factor = prebuilt_->getRateString(idx, UNITS_RATE_FACTOR);
+        result.offset = prebuilt_->getRateString(idx, UNITS_RATE_OFFSET);
+    } else {
+        const ConversionRateInfo &info = *conversionInfo_[idx];
+        result.sourceUnit = info.sourceUnit.toStringPiece();
+        result.baseUnit = info.baseUnit.toStringPiece();
+        result.factor = info.factor.toStringPiece();
+        result.offset = info.offset.toStringPiece();
+    }
+    return result;
+}
+
+const Factor *ConversionRates::extractFactor(StringPiece source, UErrorCode &status) const {
+    int32_t idx = indexOf(source);
+    if (idx < 0) {
+        status = U_INTERNAL_PROGRAM_ERROR;
+        return nullptr;
+    }
+    return factors_[idx];
+}
+
+void UnitDimensions::multiply(const UnitDimensions &other, int32_t power) {
+    const int32_t *otherNumerator = other.numerator;
+    const int32_t *otherDenominator = other.denominator;
+    if (power < 0) {
+        otherNumerator = other.denominator;
+        otherDenominator = other.numerator;
+        power = -power;
+    }
+    for (int32_t i = 0; i < kMaxBaseUnits; i++) {
+        numerator[i] += otherNumerator[i] * power;
+        denominator[i] += otherDenominator[i] * power;
+    }
+}
+
+void UnitDimensions::takeReciprocal() {
+    for (int32_t i = 0; i < kMaxBaseUnits; i++) {
+        int32_t temp = numerator[i];
+        numerator[i] = denominator[i];
+        denominator[i] = temp;
+    }
+}
+
+int32_t UnitDimensions::compareTo(const UnitDimensions &other) const {
+    for (int32_t i = 0; i < kMaxBaseUnits; i++) {
+        if (numerator[i] != other.numerator[i]) {
+            return numerator[i] < other.numerator[i] ? -1 : 1;
+        }
+        if (denominator[i] != other.denominator[i]) {
+            return denominator[i] < other.denominator[i] ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+Convertibility UnitDimensions::getConvertibility(const UnitDimensions &target) const {
+    bool convertible = true;
+    bool reciprocal = true;
+    for (int32_t i = 0; i < kMaxBaseUnits; i++) {
+        int32_t power = numerator[i] - denominator[i];
+        int32_t targetPower = target.numerator[i] - target.denominator[i];
+        convertible &= power == targetPower;
+        reciprocal &= power == -targetPower;
+    }
+    // Dimensionless units are convertible, rather than reciprocal.
+    return convertible ? CONVERTIBLE : reciprocal ? RECIPROCAL : UNCONVERTIBLE;
+}
+
+UnitCategories::UnitCategories(const ConversionRates &rates, UErrorCode &status) {
+    simpleUnitsCount_ = getSimpleUnitsCount(status);
+    MaybeStackVector<CharString> baseUnits;
+    getCategoryBaseUnits(baseUnits, status);
+    if (U_FAILURE(status)) { return; }
+    int32_t categoriesCount = baseUnits.length();
+    simpleUnitDimensions_.adoptInsteadAndCheckErrorCode(new UnitDimensions[simpleUnitsCount_], status);
+    LocalArray<UnitDimensions> dimensions(new UnitDimensions[categoriesCount], status);
+    MaybeStackArray<int32_t, 64> order;
+    if (U_FAILURE(status)) { return; }
+    if (order.resize(categoriesCount) == nullptr) {
+        status = U_MEMORY_ALLOCATION_ERROR;
+        return;
+    }
+
+    // The dimensions of a simple unit are those of the base unit it converts
+    // to.
+    BaseUnits indexer;
+    SingleUnitImpl singleUnit;
+    for (int32_t i = 0; i < simpleUnitsCount_; i++) {
+        singleUnit.index = i;
+        ConversionRateView rateInfo =
+            rates.extractConversionInfo(singleUnit.getSimpleUnitID(), status);
+        if (U_FAILURE(status)) { return; }
+        indexer.multiplyDimensions(rateInfo.baseUnit, simpleUnitDimensions_[i],
+                                   status);
+    }
+    for (int32_t i = 0; i < categoriesCount; i++) {
+        indexer.multiplyDimensions(baseUnits[i]->toStringPiece(), dimensions[i], status);
+        order[i] = i;
+    }
+    if (U_FAILURE(status)) { return; }
+
+    uprv_sortArray(order.getAlias(), categoriesCount, sizeof(int32_t), compareDimensions,
+                   dimensions.getAlias(), false, &status);
+    categoryDimensions_.adoptInsteadAndCheckErrorCode(new UnitDimensions[categoriesCount], status);
+    for (int32_t i = 0; i < categoriesCount && U_SUCCESS(status); i++) {
+        categoryDimensions_[i] = dimensions[order[i]];
+        CharString name = getUnitQuantity(baseUnits[order[i]]->toStringPiece(), status);
+        categoryNames_.emplaceBackAndCheckErrorCode(status, name.toStringPiece(), status);
+    }
+}
+
+const UnitCategories *UnitCategories::getInstance(UErrorCode &status) {
+    umtx_initOnce(gUnitCategoriesInitOnce, &initUnitCategories, status);
+    if (U_FAILURE(status)) { return nullptr; }
+    return gUnitCategories;
+}
+
+void UnitCategories::getDimensions(const MeasureUnitImpl &unit, UnitDimensions &result,
+                                   UErrorCode &status) const {
+    if (U_FAILURE(status)) { return; }
+    result = UnitDimensions();
+    for (int32_t i = 0; i < unit.singleUnits.length(); i++) {
+        const SingleUnitImpl &singleUnit = *unit.singleUnits[i];
+        if (singleUnit.index < 0 || singleUnit.index >= simpleUnitsCount_) {
+            status = U_INTERNAL_PROGRAM_ERROR;
+            return;
+        }
+        result.multiply(simpleUnitDimensions_[singleUnit.index], singleUnit.dimensionality);
+    }
+}
+
+StringPiece UnitCategories::getCategory(const MeasureUnitImpl &unit, UErrorCode &status) const {
+    UnitDimensions dimensions;
+    getDimensions(unit, dimensions, status);
+    if (U_FAILURE(status)) { return StringPiece(); }
+    int32_t index = findCategory(dimensions);
+    if (index < 0) {
+        // TODO(icu-units#130): support inverting any unit, with correct
+        // fallback logic: inversion and fallback may depend on presence or
+        // absence of a usage for that category. As in getUnitQuantity(), only
+        // consumption supports inverse units (mile-per-gallon).
+        dimensions.takeReciprocal();
+        index = findCategory(dimensions);
+        if (index >= 0 && categoryNames_[index]->toStringPiece() != "consumption") {
+            index = -1;
+        }
+    }
+    if (index < 0) {
+        status = U_INVALID_FORMAT_ERROR;
+        return StringPiece();
+    }
+    return categoryNames_[index]->toStringPiece();
+}
+
+Convertibility UnitCategories::getConvertibility(const MeasureUnitImpl &source,
+                                                 const MeasureUnitImpl &target,
+                                                 UErrorCode &status) const {
+    UnitDimensions sourceDimensions;
+    UnitDimensions targetDimensions;
+    getDimensions(source, sourceDimensions, status);
+    getDimensions(target, targetDimensions, status);
+    if (U_FAILURE(status)) { return UNCONVERTIBLE; }
+    return sourceDimensions.getConvertibility(targetDimensions);
+}
+
+int32_t UnitCategories::findCategory(const UnitDimensions &dimensions) const {
+    int32_t start = 0;
+    int32_t limit = categoryNames_.length();
+    while (start < limit) {
+        int32_t mid = (start + limit) / 2;
+        int32_t cmp = dimensions.compareTo(categoryDimensions_[mid]);
+        if (cmp == 0) {
+            return mid;
+        }
+        if (cmp < 0) {
+            limit = mid;
+        } else {
+            start = mid + 1;
+        }
+    }
+    return -1;
 }
 
 U_I18N_API UnitPreferences::UnitPreferences(UErrorCode &status) {
     LocalUResourceBundlePointer unitsBundle(ures_openDirect(NULL, "units", &status));
     UnitPreferencesSink sink(&unitPrefs_, &metadata_);
     ures_getAllItemsWithFallback(unitsBundle.getAlias(), "unitPreferenceData", sink, status);
+    if (U_FAILURE(status)) { return; }
+
+    // The sink verified that metadata_ is sorted, so the metadata of each
+    // category/usage pair is contiguous.
+    BytesTrieBuilder builder(status);
+    CharString key;
+    for (int32_t start = 0, limit; start < metadata_.length(); start = limit) {
+        const UnitPreferenceMetadata &first = *metadata_[start];
+        int32_t worldIndex = -1;
+        for (limit = start; limit < metadata_.length(); limit++) {
+            const UnitPreferenceMetadata &m = *metadata_[limit];
+            if (m.category != first.category.toStringPiece() ||
+                m.usage != first.usage.toStringPiece()) {
+                break;
+            }
+            if (m.region == "001") {
+                worldIndex = limit;
+            }
+        }
+        key.clear()
+            .append(first.category, status)
+            .append('/', status)
+            .append(first.usage, status)
+            .append('/', status);
+        builder.add(key.toStringPiece(), worldIndex, status);
+        int32_t usageKeyLength = key.length();
+        for (int32_t i = start; i < limit; i++) {
+            key.truncate(usageKeyLength).append(metadata_[i]->region, status);
+            builder.add(key.toStringPiece(), i, status);
+        }
+    }
+    StringPiece index = builder.buildStringPiece(USTRINGTRIE_BUILD_FAST, status);
+    if (U_FAILURE(status)) { return; }
+    if (serializedIndex_.allocateInsteadAndReset(index.length()) == nullptr) {
+        status = U_MEMORY_ALLOCATION_ERROR;
+        return;
+    }
+    uprv_memcpy(serializedIndex_.getAlias(), index.data(), index.length());
+}
+
+/**
+ * Finds the metadata that matches the given category, usage and region: if
+ * missing, region falls back to "001", and usage falls back to its longest
+ * known prefix of whole components, eventually "default"
+ * ("land-agriculture-grain" -> "land-agriculture" -> "land" -> "default").
+ *
+ * This is a single walk through serializedIndex_: the known usage prefixes are
+ * found while walking the usage, and the "001" fallback is the value of the
+ * "category/usage/" prefix.
+ *
+ * If an invalid category is given, status is set to U_ILLEGAL_ARGUMENT_ERROR.
+ * If fallback to "default" or "001" does not resolve, status is set to
+ * U_MISSING_RESOURCE_ERROR.
+ */
+int32_t UnitPreferences::getMetadataIndex(StringPiece category, StringPiece usage,
+                                          StringPiece region, UErrorCode &status) const {
+    if (U_FAILURE(status)) { return -1; }
+    if (serializedIndex_.isNull()) {
+        status = U_MISSING_RESOURCE_ERROR;
+        return -1;
+    }
+    BytesTrie trie(serializedIndex_.getAlias());
+    if (!USTRINGTRIE_HAS_NEXT(trie.next(category.data(), category.length())) ||
+        !USTRINGTRIE_HAS_NEXT(trie.next('/'))) {
+        // TODO: failures can happen if units::getUnitCategory returns a category
+        // that does not appear in unitPreferenceData. Do we want a unit test that
+        // checks unitPreferenceData has full coverage of categories? Or just trust
+        // CLDR?
+        status = U_ILLEGAL_ARGUMENT_ERROR;
+        return -1;
+    }
+    BytesTrie::State categoryState;
+    trie.saveState(categoryState);
+
+    // The state after "category/usage/" for the longest known usage prefix.
+    BytesTrie::State usageState;
+    bool foundUsage = false;
+    for (int32_t i = 0;; i++) {
+        if (i == usage.length() || usage.data()[i] == '-') {
+            // The usage prefix up to i is known if "category/prefix/" has a
+            // value.
+            BytesTrie::State prefixState;
+            trie.saveState(prefixState);
+            if (USTRINGTRIE_HAS_VALUE(trie.next('/'))) {
+                trie.saveState(usageState);
+                foundUsage = true;
+            }
+            trie.resetToState(prefixState);
+        }
+        if (i == usage.length() || !USTRINGTRIE_HAS_NEXT(trie.next(usage.data()[i]))) {
+            break;
+        }
+    }
+    if (foundUsage) {
+        trie.resetToState(usageState);
+    } else {
+        trie.resetToState(categoryState);
+        static const char kDefaultUsage[] = "default/";
+        if (!USTRINGTRIE_HAS_VALUE(trie.next(kDefaultUsage, UPRV_LENGTHOF(kDefaultUsage) - 1))) {
+            // "default" is not supposed to be missing for any valid category.
+            status = U_MISSING_RESOURCE_ERROR;
+            return -1;
+        }
+    }
+
+    int32_t idx = trie.getValue();
+    if (USTRINGTRIE_HAS_VALUE(trie.next(region.data(), region.length()))) {
+        idx = trie.getValue();
+    }
+    if (idx < 0) {
+        // "001" is not supposed to be missing for any valid usage.
+        status = U_MISSING_RESOURCE_ERROR;
+    }
+    return idx;
+}
+
+const UnitPreferences *UnitPreferences::getInstance(UErrorCode &status) {
+    umtx_initOnce(gUnitPreferencesInitOnce, &initUnitPreferences, status);
+    if (U_FAILURE(status)) { return nullptr; }
+    return gUnitPreferences;
 }
 
 // TODO: make outPreferences const?
@@ -395,7 +807,7 @@ void U_I18N_API UnitPreferences::getPreferencesFor(StringPiece category, StringP
                                                    StringPiece region,
                                                    const UnitPreference *const *&outPreferences,
                                                    int32_t &preferenceCount, UErrorCode &status) const {
-    int32_t idx = getPreferenceMetadataIndex(&metadata_, category, usage, region, status);
+    int32_t idx = getMetadataIndex(category, usage, region, status);
     if (U_FAILURE(status)) {
         outPreferences = nullptr;
         preferenceCount = 0;
@@ -11,10 +11,14 @@
 
 #include "charstr.h"
 #include "cmemory.h"
+#include "unicode/localpointer.h"
 #include "unicode/stringpiece.h"
 #include "unicode/uobject.h"
 
 U_NAMESPACE_BEGIN
+
+class MeasureUnitImpl;
+
 namespace units {
 
 /**
@@ -59,6 +63,24 @@ template class U_I18N_API MaybeStackVector<units::ConversionRateInfo, 8>;
 
 namespace units {
 
+// Forward declarations, see units_converter.h and units_prebuilt.h.
+struct Factor;
+class PrebuiltUnitsData;
+
+/**
+ * The strings of a conversion rate, as returned by
+ * ConversionRates::extractConversionInfo(). They point into units.icu, or into
+ * the ConversionRateInfo that the ConversionRates instance loaded from the
+ * "units" resource bundle: they are valid as long as that instance.
+ */
+struct U_I18N_API ConversionRateView {
+    StringPiece sourceUnit;
+    StringPiece baseUnit;
+    StringPiece factor;
+    // Empty if the conversion rate has no offset.
+    StringPiece offset;
+};
+
 /**
  * Returns ConversionRateInfo for all supported conversions.
  *
@@ -67,28 +89,224 @@ namespace units {
  */
 void U_I18N_API getAllConversionRates(MaybeStackVector<ConversionRateInfo> &result, UErrorCode &status);
 
+/**
+ * Builds the contents of units.icu (see units_prebuilt.h) from the "units"
+ * resource bundle: the tables for parsing unit identifiers, and all conversion
+ * rates with their parsed factors. Used by the genunits tool.
+ *
+ * @param out Receives the data, to be written after the units.icu data header.
+ * @param status Receives status.
+ */
+void U_I18N_API buildPrebuiltUnitsData(CharString &out, UErrorCode &status);
+
 /**
  * Contains all the supported conversion rates.
  */
-class U_I18N_API ConversionRates {
+class U_I18N_API ConversionRates : public UMemory {
   public:
     /**
-     * Constructor
+     * Constructor, loads all the conversion rates and indexes them by source
+     * unit. The rates, their parsed factors and the index are taken from
+     * units.icu if available, or else built from the "units" resource bundle.
+     * The strings and the index of units.icu are used in place, so the
+     * instance must not be used after u_cleanup().
+     *
+     * @param status Receives status.
+     */
+    ConversionRates(UErrorCode &status);
+
+    ~ConversionRates();
+
+    /**
+     * Returns a shared, immutable ConversionRates instance, loaded on first use.
+     *
+     * Prefer this over constructing a new instance: constructing
+     * ConversionRates loads all conversion rates.
+     *
+     * @param status Receives status.
+     * @return A pointer to the shared instance, owned by ICU and valid until
+     * u_cleanup() is called, or nullptr on failure.
+     */
+    static const ConversionRates *getInstance(UErrorCode &status);
+
+    /**
+     * Returns the strings of the conversion rate that matches the `source`,
+     * without copying them. Sets U_INTERNAL_PROGRAM_ERROR if there is none.
      *
+     * @param source Contains the source.
      * @param status Receives status.
      */
-    ConversionRates(UErrorCode &status) { getAllConversionRates(conversionInfo_, status); }
+    ConversionRateView extractConversionInfo(StringPiece source, UErrorCode &status) const;
 
     /**
-     * Returns a pointer to the conversion rate info that match the `source`.
+     * Returns a pointer to the parsed conversion factor (including the offset)
+     * from `source` to its base unit. Symbolic constants are not substituted.
+     *
+     * The factor strings of all ConversionRateInfo instances are parsed once,
+     * when the ConversionRates instance is constructed.
      *
      * @param source Contains the source.
      * @param status Receives status.
      */
-    const ConversionRateInfo *extractConversionInfo(StringPiece source, UErrorCode &status) const;
+    const Factor *extractFactor(StringPiece source, UErrorCode &status) const;
 
   private:
+    // If not null, the conversion rates are those of units.icu, and
+    // conversionInfo_ is empty.
+    const PrebuiltUnitsData *prebuilt_ = nullptr;
+
+    // Only used if prebuilt_ is null.
     MaybeStackVector<ConversionRateInfo> conversionInfo_;
+
+    // The parsed factor of each conversion rate, in the same order.
+    MaybeStackVector<Factor> factors_;
+
+    // Serialized BytesTrie mapping from source unit to the index of its
+    // conversion rate: in units.icu, or in serializedIndex_.
+    const char *index_ = nullptr;
+    LocalMemory<char> serializedIndex_;
+
+    // Returns the index of the `source` unit in the conversion rates and
+    // factors_, or -1 if it is not found.
+    int32_t indexOf(StringPiece source) const;
+};
+
+enum Convertibility {
+    RECIPROCAL,
+    CONVERTIBLE,
+    UNCONVERTIBLE,
+};
+
+/**
+ * The maximum number of distinct base units, such as "meter", "kilogram" and
+ * "second", that UnitDimensions can represent.
+ */
+constexpr int32_t kMaxBaseUnits = 16;
+
+/**
+ * The dimensions of a unit: the powers of the base units it is made of. For
+ * example, "newton" converts to kilogram-meter-per-square-second: kilogram and
+ * meter to the power of 1 in the numerator, second to the power of 2 in the
+ * denominator.
+ *
+ * As in base unit identifiers, numerator and denominator are kept apart:
+ * "cubic-meter-per-meter" (consumption) is not the same as "square-meter"
+ * (area).
+ */
+struct U_I18N_API UnitDimensions : public UMemory {
+    // Both indexed by base unit, in the order assigned by UnitCategories.
+    int32_t numerator[kMaxBaseUnits] = {};
+    int32_t denominator[kMaxBaseUnits] = {};
+
+    /**
+     * Multiplies these dimensions by `other` raised to `power`. A negative
+     * power swaps the numerator and the denominator of `other`.
+     */
+    void multiply(const UnitDimensions &other, int32_t power);
+
+    /** Swaps the numerator and the denominator. */
+    void takeReciprocal();
+
+    /** An arbitrary total order, for binary search. */
+    int32_t compareTo(const UnitDimensions &other) const;
+
+    /**
+     * Returns whether a unit of these dimensions converts to one of `target`:
+     * CONVERTIBLE if each base unit has the same power in both, numerator
+     * minus denominator, and RECIPROCAL if it has opposite powers, as for
+     * "meter-per-second" and "second-per-meter". This takes constant time.
+     */
+    Convertibility getConvertibility(const UnitDimensions &target) const;
+};
+
+} // namespace units
+
+// Export explicit template instantiations of LocalArray and MaybeStackVector.
+// This is required when building DLLs for Windows. (See datefmt.h,
+// collationiterator.h, erarules.h and others for similar examples.)
+#if U_PF_WINDOWS <= U_PLATFORM && U_PLATFORM <= U_PF_CYGWIN
+template class U_I18N_API LocalPointerBase<units::UnitDimensions>;
+template class U_I18N_API LocalArray<units::UnitDimensions>;
+template class U_I18N_API MaybeStackArray<CharString*, 8>;
+template class U_I18N_API MemoryPool<CharString, 8>;
+template class U_I18N_API MaybeStackVector<CharString, 8>;
+#endif
+
+namespace units {
+
+/**
+ * Looks up the category of a unit, such as "length" or "consumption", without
+ * building its base unit: the dimensions of each simple unit are computed once,
+ * when the shared instance is loaded, and the dimensions of a unit are the
+ * product of those of its single units. This does not allocate memory.
+ */
+class U_I18N_API UnitCategories : public UMemory {
+  public:
+    /**
+     * Constructor, computes the dimensions of all simple units and of the base
+     * units of all categories.
+     *
+     * @param rates The conversion rates, which give the base unit of each
+     * simple unit.
+     * @param status Receives status.
+     */
+    UnitCategories(const ConversionRates &rates, UErrorCode &status);
+
+    /**
+     * Returns a shared, immutable UnitCategories instance, loaded on first use.
+     *
+     * @param status Receives status.
+     * @return A pointer to the shared instance, owned by ICU and valid until
+     * u_cleanup() is called, or nullptr on failure.
+     */
+    static const UnitCategories *getInstance(UErrorCode &status);
+
+    /**
+     * Computes the dimensions of `unit`.
+     *
+     * @param unit A single or compound unit.
+     * @param result Receives the dimensions.
+     * @param status Receives status.
+     */
+    void getDimensions(const MeasureUnitImpl &unit, UnitDimensions &result,
+                       UErrorCode &status) const;
+
+    /**
+     * Returns the category of `unit`: the same as getUnitQuantity() for the
+     * identifier of its compound base unit, as built by
+     * extractCompoundBaseUnit().
+     *
+     * @param unit A single or compound unit.
+     * @param status Receives status. U_INVALID_FORMAT_ERROR if the unit has no
+     * category.
+     * @return The category, valid as long as this instance.
+     */
+    StringPiece getCategory(const MeasureUnitImpl &unit, UErrorCode &status) const;
+
+    /**
+     * Determines whether `source` converts to `target`, like
+     * extractConvertibility(), from the dimensions of their single units.
+     * This does not allocate memory.
+     *
+     * @param source A single or compound unit.
+     * @param target A single or compound unit.
+     * @param status Receives status.
+     */
+    Convertibility getConvertibility(const MeasureUnitImpl &source, const MeasureUnitImpl &target,
+                                     UErrorCode &status) const;
+
+  private:
+    // The dimensions of each simple unit, indexed by SingleUnitImpl::index.
+    LocalArray<UnitDimensions> simpleUnitDimensions_;
+    int32_t simpleUnitsCount_ = 0;
+
+    // The dimensions of the base units of all categories, in ascending order,
+    // and the names of these categories, in the same order.
+    LocalArray<UnitDimensions> categoryDimensions_;
+    MaybeStackVector<CharString> categoryNames_;
+
+    // Returns the index of the category with `dimensions`, or -1.
+    int32_t findCategory(const UnitDimensions &dimensions) const;
 };
 
 // Encapsulates unitPreferenceData information from units resources, specifying
@@ -132,8 +350,6 @@ class U_I18N_API UnitPreferenceMetadata : public UMemory {
     int32_t prefsCount;
 
     int32_t compareTo(const UnitPreferenceMetadata &other) const;
-    int32_t compareTo(const UnitPreferenceMetadata &other, bool *foundCategory, bool *foundUsage,
-                      bool *foundRegion) const;
 };
 
 } // namespace units
@@ -158,7 +374,7 @@ namespace units {
 /**
  * Unit Preferences information for various locales and usages.
  */
-class U_I18N_API UnitPreferences {
+class U_I18N_API UnitPreferences : public UMemory {
   public:
     /**
      * Constructor, loads all the preference data.
@@ -167,6 +383,19 @@ class U_I18N_API UnitPreferences {
      */
     UnitPreferences(UErrorCode &status);
 
+    /**
+     * Returns a shared, immutable UnitPreferences instance, loaded on first
+     * use.
+     *
+     * Prefer this over constructing a new instance: constructing
+     * UnitPreferences walks the whole "unitPreferenceData" resource table.
+     *
+     * @param status Receives status.
+     * @return A pointer to the shared instance, owned by ICU and valid until
+     * u_cleanup() is called, or nullptr on failure.
+     */
+    static const UnitPreferences *getInstance(UErrorCode &status);
+
     /**
      * Returns the set of unit preferences in the particular category that best
      * matches the specified usage and region.
@@ -203,6 +432,17 @@ class U_I18N_API UnitPreferences {
     // All the preferences as a flat list: which usage and region preferences
     // are associated with is stored in `metadata_`.
     MaybeStackVector<UnitPreference> unitPrefs_;
+
+  private:
+    // Serialized BytesTrie mapping from "category/usage/region" to the index
+    // of its metadata in metadata_. Each "category/usage/" prefix maps to the
+    // index of the "001" metadata of that usage, or to -1 if there is none, so
+    // that region fallback needs no second lookup.
+    LocalMemory<char> serializedIndex_;
+
+    // Returns the index in metadata_ that getPreferencesFor() resolves to.
+    int32_t getMetadataIndex(StringPiece category, StringPiece usage, StringPiece region,
+                             UErrorCode &status) const;
 };
 
 } // namespace units
@@ -0,0 +1,222 @@
+// © 2020 and later: Unicode, Inc. and others.
+// License & terms of use: http://www.unicode.org/copyright.html
+
+#include "unicode/utypes.h"
+
+#if !UCONFIG_NO_FORMATTING
+
+#include "cmemory.h"
+#include "ucln_in.h"
+#include "umutex.h"
+#include "units_prebuilt.h"
+
+U_NAMESPACE_BEGIN
+namespace units {
+
+namespace {
+
+icu::UInitOnce gPrebuiltUnitsDataInitOnce = U_INITONCE_INITIALIZER;
+PrebuiltUnitsData *gPrebuiltUnitsData = nullptr;
+
+UBool U_CALLCONV cleanupPrebuiltUnitsData() {
+    delete gPrebuiltUnitsData;
+    gPrebuiltUnitsData = nullptr;
+    gPrebuiltUnitsDataInitOnce.reset();
+    return TRUE;
+}
+
+UBool U_CALLCONV isAcceptable(void * /*context*/, const char * /*type*/, const char * /*name*/,
+                              const UDataInfo *pInfo) {
+    return pInfo->size >= 20 &&
+        pInfo->isBigEndian == U_IS_BIG_ENDIAN &&
+        pInfo->charsetFamily == U_CHARSET_FAMILY &&
+        pInfo->dataFormat[0] == UNITS_FMT_0 &&
+        pInfo->dataFormat[1] == UNITS_FMT_1 &&
+        pInfo->dataFormat[2] == UNITS_FMT_2 &&
+        pInfo->dataFormat[3] == UNITS_FMT_3 &&
+        pInfo->formatVersion[0] == 1;
+}
+
+void U_CALLCONV initPrebuiltUnitsData(UErrorCode &status) {
+    ucln_i18n_registerCleanup(UCLN_I18N_UNITS_PREBUILT, cleanupPrebuiltUnitsData);
+    // units.icu is optional: without it, the units data is built from the
+    // "units" resource bundle.
+    UErrorCode localStatus = U_ZERO_ERROR;
+    UDataMemory *memory =
+        udata_openChoice(nullptr, UNITS_DATA_TYPE, UNITS_DATA_NAME, isAcceptable, nullptr, &localStatus);
+    if (U_FAILURE(localStatus)) { return; }
+    const int32_t *indexes = static_cast<const int32_t *>(udata_getMemory(memory));
+    if (indexes[UNITS_IX_INDEXES_LENGTH] < UNITS_IX_COUNT) {
+        // Not enough indexes.
+        udata_close(memory);
+        return;
+    }
+    gPrebuiltUnitsData = new PrebuiltUnitsData(memory, indexes);
+    if (gPrebuiltUnitsData == nullptr) {
+        udata_close(memory);
+        status = U_MEMORY_ALLOCATION_ERROR;
+    }
+}
+
+// Appends the bytes of `value` to `out`.
+template <typename T>
+void appendRaw(CharString &out, const T &value, UErrorCode &status) {
+    out.append(reinterpret_cast<const char *>(&value), sizeof(T), status);
+}
+
+} // namespace
+
+const PrebuiltUnitsData *PrebuiltUnitsData::getInstance(UErrorCode &status) {
+    umtx_initOnce(gPrebuiltUnitsDataInitOnce, &initPrebuiltUnitsData, status);
+    if (U_FAILURE(status)) { return nullptr; }
+    return gPrebuiltUnitsData;
+}
+
+PrebuiltUnitsData::~PrebuiltUnitsData() {
+    udata_close(memory_);
+}
+
+const char *PrebuiltUnitsData::getSimpleUnit(int32_t index) const {
+    const int32_t *offsets =
+        reinterpret_cast<const int32_t *>(getSection(UNITS_IX_SIMPLE_UNITS_OFFSET));
+    return getSection(UNITS_IX_CHARS_OFFSET) + offsets[index];
+}
+
+const int32_t *PrebuiltUnitsData::getSimpleUnitCategories() const {
+    return reinterpret_cast<const int32_t *>(getSection(UNITS_IX_SIMPLE_UNIT_CATEGORIES_OFFSET));
+}
+
+const UChar *PrebuiltUnitsData::getCategory(int32_t index) const {
+    const int32_t *offsets = reinterpret_cast<const int32_t *>(getSection(UNITS_IX_CATEGORIES_OFFSET));
+    return reinterpret_cast<const UChar *>(getSection(UNITS_IX_UCHARS_OFFSET)) + offsets[index];
+}
+
+StringPiece PrebuiltUnitsData::getConversionRatesTrie() const {
+    return StringPiece(getSection(UNITS_IX_CONVERSION_RATES_TRIE_OFFSET),
+                       indexes_[UNITS_IX_CHARS_OFFSET] - indexes_[UNITS_IX_CONVERSION_RATES_TRIE_OFFSET]);
+}
+
+const char *PrebuiltUnitsData::getRateString(int32_t rate, int32_t which) const {
+    const int32_t *offsets =
+        reinterpret_cast<const int32_t *>(getSection(UNITS_IX_RATE_STRINGS_OFFSET));
+    return getSection(UNITS_IX_CHARS_OFFSET) + offsets[rate * UNITS_RATE_STRINGS_COUNT + which];
+}
+
+const double *PrebuiltUnitsData::getFactorValues(int32_t rate) const {
+    return reinterpret_cast<const double *>(getSection(UNITS_IX_FACTORS_OFFSET)) + rate * 3;
+}
+
+const int32_t *PrebuiltUnitsData::getFactorExponents(int32_t rate) const {
+    return reinterpret_cast<const int32_t *>(getSection(UNITS_IX_EXPONENTS_OFFSET)) +
+           rate * (1 + getConstantsCount());
+}
+
+void PrebuiltUnitsDataBuilder::setStemTrie(StringPiece trie, UErrorCode &status) {
+    stemTrie_.clear().append(trie, status);
+}
+
+void PrebuiltUnitsDataBuilder::setCategoriesTrie(StringPiece trie, UErrorCode &status) {
+    categoriesTrie_.clear().append(trie, status);
+}
+
+void PrebuiltUnitsDataBuilder::setConversionRatesTrie(StringPiece trie, UErrorCode &status) {
+    conversionRatesTrie_.clear().append(trie, status);
+}
+
+void PrebuiltUnitsDataBuilder::addString(CharString &offsets, StringPiece s, UErrorCode &status) {
+    appendRaw(offsets, chars_.length(), status);
+    chars_.append(s, status).append('\0', status);
+}
+
+void PrebuiltUnitsDataBuilder::addSimpleUnit(StringPiece simpleUnit, int32_t category,
+                                             UErrorCode &status) {
+    addString(simpleUnits_, simpleUnit, status);
+    appendRaw(simpleUnitCategories_, category, status);
+    simpleUnitsCount_++;
+}
+
+void PrebuiltUnitsDataBuilder::addCategory(const UChar *category, int32_t length, UErrorCode &status) {
+    appendRaw(categories_, uchars_.length(), status);
+    uchars_.append(category, length).append((UChar)0);
+    if (uchars_.isBogus()) {
+        status = U_MEMORY_ALLOCATION_ERROR;
+        return;
+    }
+    categoriesCount_++;
+}
+
+void PrebuiltUnitsDataBuilder::addConversionRate(const StringPiece strings[UNITS_RATE_STRINGS_COUNT],
+                                                 const double values[3], bool reciprocal,
+                                                 const int32_t *exponents, UErrorCode &status) {
+    for (int32_t i = 0; i < 3; i++) {
+        appendRaw(factors_, values[i], status);
+    }
+    appendRaw(exponents_, (int32_t)reciprocal, status);
+    for (int32_t i = 0; i < constantsCount_; i++) {
+        appendRaw(exponents_, exponents[i], status);
+    }
+    for (int32_t i = 0; i < UNITS_RATE_STRINGS_COUNT; i++) {
+        addString(rateStrings_, strings[i], status);
+    }
+    conversionRatesCount_++;
+}
+
+void PrebuiltUnitsDataBuilder::build(CharString &out, UErrorCode &status) const {
+    if (U_FAILURE(status)) { return; }
+    int32_t indexes[UNITS_IX_COUNT] = {};
+    indexes[UNITS_IX_INDEXES_LENGTH] = UNITS_IX_COUNT;
+    indexes[UNITS_IX_SIMPLE_UNITS_COUNT] = simpleUnitsCount_;
+    indexes[UNITS_IX_CATEGORIES_COUNT] = categoriesCount_;
+    indexes[UNITS_IX_CONVERSION_RATES_COUNT] = conversionRatesCount_;
+    indexes[UNITS_IX_CONSTANTS_COUNT] = constantsCount_;
+
+    int32_t offset = (int32_t)sizeof(indexes);
+    indexes[UNITS_IX_FACTORS_OFFSET] = offset;
+    offset += factors_.length();
+    indexes[UNITS_IX_EXPONENTS_OFFSET] = offset;
+    offset += exponents_.length();
+    indexes[UNITS_IX_RATE_STRINGS_OFFSET] = offset;
+    offset += rateStrings_.length();
+    indexes[UNITS_IX_SIMPLE_UNITS_OFFSET] = offset;
+    offset += simpleUnits_.length();
+    indexes[UNITS_IX_SIMPLE_UNIT_CATEGORIES_OFFSET] = offset;
+    offset += simpleUnitCategories_.length();
+    indexes[UNITS_IX_CATEGORIES_OFFSET] = offset;
+    offset += categories_.length();
+    indexes[UNITS_IX_UCHARS_OFFSET] = offset;
+    offset += uchars_.length() * U_SIZEOF_UCHAR;
+    indexes[UNITS_IX_STEM_TRIE_OFFSET] = offset;
+    offset += stemTrie_.length();
+    indexes[UNITS_IX_CATEGORIES_TRIE_OFFSET] = offset;
+    offset += categoriesTrie_.length();
+    indexes[UNITS_IX_CONVERSION_RATES_TRIE_OFFSET] = offset;
+    offset += conversionRatesTrie_.length();
+    indexes[UNITS_IX_CHARS_OFFSET] = offset;
+    offset += chars_.length();
+    // Pad to a multiple of 4 bytes.
+    int32_t padding = (4 - (offset & 3)) & 3;
+    offset += padding;
+    indexes[UNITS_IX_TOTAL_SIZE] = offset;
+
+    out.append(reinterpret_cast<const char *>(indexes), (int32_t)sizeof(indexes), status)
+        .append(factors_, status)
+        .append(exponents_, status)
+        .append(rateStrings_, status)
+        .append(simpleUnits_, status)
+        .append(simpleUnitCategories_, status)
+        .append(categories_, status)
+        .append(reinterpret_cast<const char *>(uchars_.getBuffer()), uchars_.length() * U_SIZEOF_UCHAR,
+                status)
+        .append(stemTrie_, status)
+        .append(categoriesTrie_, status)
+        .append(conversionRatesTrie_, status)
+        .append(chars_, status);
+    for (int32_t i = 0; i < padding; i++) {
+        out.append('\0', status);
+    }
+}
+
+} // namespace units
+U_NAMESPACE_END
+
+#endif /* #if !UCONFIG_NO_FORMATTING */
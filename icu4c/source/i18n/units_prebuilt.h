@@ -0,0 +1,257 @@
+// © 2020 and later: Unicode, Inc. and others.
+// License & terms of use: http://www.unicode.org/copyright.html
+
+#include "unicode/utypes.h"
+
+#if !UCONFIG_NO_FORMATTING
+#ifndef __UNITS_PREBUILT_H__
+#define __UNITS_PREBUILT_H__
+
+#include "charstr.h"
+#include "unicode/stringpiece.h"
+#include "unicode/udata.h"
+#include "unicode/unistr.h"
+#include "unicode/uobject.h"
+
+/*
+ * units.icu: the unit identifier tables, unit category tables and parsed
+ * conversion factors that would otherwise be built at runtime from the "units"
+ * resource bundle (data/misc/units.txt). It is generated at data build time by
+ * the genunits tool, and loaded without any parsing.
+ *
+ * Data format "Unit", format version 1:
+ *
+ *   int32_t indexes[UNITS_IX_COUNT];      // see UNITS_IX_* below
+ *   double factors[ratesCount][3];        // factorNum, factorDen, offset
+ *   int32_t exponents[ratesCount][1 + constantsCount];  // reciprocal, then
+ *                                         // the constant exponents
+ *   int32_t rateStrings[ratesCount][4];   // offsets into chars[]: source
+ *                                         // unit, base unit, factor, offset
+ *   int32_t simpleUnits[simpleUnitsCount];  // offsets into chars[]
+ *   int32_t simpleUnitCategories[simpleUnitsCount];  // indexes of categories
+ *   int32_t categories[categoriesCount];  // offsets into uchars[]
+ *   UChar uchars[];                       // NUL-terminated category names
+ *   uint8_t stemTrie[];                   // BytesTrie for parsing identifiers
+ *   uint8_t categoriesTrie[];             // BytesTrie: base unit -> category
+ *   uint8_t conversionRatesTrie[];        // BytesTrie: source unit -> rate
+ *   char chars[];                         // NUL-terminated invariant strings
+ *
+ * Each section starts at the byte offset (from the start of indexes[]) stored
+ * in the corresponding UNITS_IX_*_OFFSET and ends where the next one starts.
+ */
+
+// file definitions ------------------------------------------------------------
+
+#define UNITS_DATA_NAME "units"
+#define UNITS_DATA_TYPE "icu"
+
+// data format "Unit"
+#define UNITS_FMT_0 0x55
+#define UNITS_FMT_1 0x6e
+#define UNITS_FMT_2 0x69
+#define UNITS_FMT_3 0x74
+
+// indexes into indexes[]
+enum {
+    // Element 0 stores the length of the indexes[] array.
+    UNITS_IX_INDEXES_LENGTH,
+    // The number of simple units: the keys of "convertUnits", except for
+    // "kilogram".
+    UNITS_IX_SIMPLE_UNITS_COUNT,
+    // The number of unit categories in "unitQuantities".
+    UNITS_IX_CATEGORIES_COUNT,
+    // The number of conversion rates: all keys of "convertUnits".
+    UNITS_IX_CONVERSION_RATES_COUNT,
+    // The number of symbolic constants whose exponents are stored per factor.
+    UNITS_IX_CONSTANTS_COUNT,
+
+    UNITS_IX_FACTORS_OFFSET,
+    UNITS_IX_EXPONENTS_OFFSET,
+    UNITS_IX_RATE_STRINGS_OFFSET,
+    UNITS_IX_SIMPLE_UNITS_OFFSET,
+    UNITS_IX_SIMPLE_UNIT_CATEGORIES_OFFSET,
+    UNITS_IX_CATEGORIES_OFFSET,
+    UNITS_IX_UCHARS_OFFSET,
+    UNITS_IX_STEM_TRIE_OFFSET,
+    UNITS_IX_CATEGORIES_TRIE_OFFSET,
+    UNITS_IX_CONVERSION_RATES_TRIE_OFFSET,
+    UNITS_IX_CHARS_OFFSET,
+    UNITS_IX_TOTAL_SIZE,
+
+    // Length of indexes[]. Even, to 8-align the factors.
+    UNITS_IX_COUNT = 18
+};
+
+// The strings stored in rateStrings[] for each conversion rate.
+enum {
+    UNITS_RATE_SOURCE_UNIT,
+    UNITS_RATE_BASE_UNIT,
+    UNITS_RATE_FACTOR,
+    UNITS_RATE_OFFSET,
+    UNITS_RATE_STRINGS_COUNT
+};
+
+U_NAMESPACE_BEGIN
+namespace units {
+
+/**
+ * Read-only view of units.icu. All pointers returned point into the data
+ * memory, and remain valid until u_cleanup() is called.
+ */
+class U_I18N_API PrebuiltUnitsData : public UMemory {
+  public:
+    /**
+     * Returns the shared units.icu data, loaded on first use.
+     *
+     * @param status Receives status.
+     * @return A pointer to the shared instance, owned by ICU, or nullptr if
+     * units.icu is not available or not valid. Callers then fall back to
+     * building the data from the "units" resource bundle: a missing units.icu
+     * does not set an error.
+     */
+    static const PrebuiltUnitsData *getInstance(UErrorCode &status);
+
+    /**
+     * Constructor, takes ownership of `memory`, which must hold valid
+     * units.icu data starting at `indexes`.
+     */
+    PrebuiltUnitsData(UDataMemory *memory, const int32_t *indexes)
+        : memory_(memory), indexes_(indexes) {}
+
+    ~PrebuiltUnitsData();
+
+    int32_t getSimpleUnitsCount() const { return indexes_[UNITS_IX_SIMPLE_UNITS_COUNT]; }
+    const char *getSimpleUnit(int32_t index) const;
+    const int32_t *getSimpleUnitCategories() const;
+
+    int32_t getCategoriesCount() const { return indexes_[UNITS_IX_CATEGORIES_COUNT]; }
+    const UChar *getCategory(int32_t index) const;
+
+    const char *getStemTrie() const { return getSection(UNITS_IX_STEM_TRIE_OFFSET); }
+    const char *getCategoriesTrie() const { return getSection(UNITS_IX_CATEGORIES_TRIE_OFFSET); }
+    StringPiece getConversionRatesTrie() const;
+
+    int32_t getConversionRatesCount() const { return indexes_[UNITS_IX_CONVERSION_RATES_COUNT]; }
+    int32_t getConstantsCount() const { return indexes_[UNITS_IX_CONSTANTS_COUNT]; }
+
+    /**
+     * Returns one of the strings of a conversion rate.
+     *
+     * @param rate The index of the conversion rate.
+     * @param which One of UNITS_RATE_SOURCE_UNIT, UNITS_RATE_BASE_UNIT,
+     * UNITS_RATE_FACTOR and UNITS_RATE_OFFSET. The offset is an empty string if
+     * the conversion rate has none.
+     */
+    const char *getRateString(int32_t rate, int32_t which) const;
+
+    /**
+     * Returns the factor numerator, factor denominator and offset of a
+     * conversion rate.
+     */
+    const double *getFactorValues(int32_t rate) const;
+
+    /**
+     * Returns the reciprocal flag of a conversion rate, followed by the
+     * exponents of its getConstantsCount() symbolic constants.
+     */
+    const int32_t *getFactorExponents(int32_t rate) const;
+
+  private:
+    UDataMemory *memory_;
+    const int32_t *indexes_;
+
+    const char *getSection(int32_t offsetIndex) const {
+        return reinterpret_cast<const char *>(indexes_) + indexes_[offsetIndex];
+    }
+};
+
+/**
+ * Collects the contents of units.icu, and lays them out in the binary format
+ * read by PrebuiltUnitsData. Used by the genunits tool.
+ */
+class U_I18N_API PrebuiltUnitsDataBuilder : public UMemory {
+  public:
+    /**
+     * Constructor.
+     *
+     * @param constantsCount The number of symbolic constant exponents that
+     * every addConversionRate() call provides.
+     */
+    explicit PrebuiltUnitsDataBuilder(int32_t constantsCount) : constantsCount_(constantsCount) {}
+
+    /**
+     * Sets the serialized BytesTrie used for parsing unit identifiers, mapping
+     * identifier parts to token values (see measunit_extra.cpp).
+     */
+    void setStemTrie(StringPiece trie, UErrorCode &status);
+
+    /**
+     * Sets the serialized BytesTrie mapping from base units to the index of
+     * their category, as added with addCategory().
+     */
+    void setCategoriesTrie(StringPiece trie, UErrorCode &status);
+
+    /**
+     * Sets the serialized BytesTrie mapping from source units to the index of
+     * their conversion rate, as added with addConversionRate().
+     */
+    void setConversionRatesTrie(StringPiece trie, UErrorCode &status);
+
+    /**
+     * Appends a simple unit identifier and the index of its category.
+     */
+    void addSimpleUnit(StringPiece simpleUnit, int32_t category, UErrorCode &status);
+
+    /**
+     * Appends a unit category name.
+     */
+    void addCategory(const UChar *category, int32_t length, UErrorCode &status);
+
+    /**
+     * Appends a conversion rate.
+     *
+     * @param strings The source unit, base unit, factor and offset strings,
+     * indexed by UNITS_RATE_*.
+     * @param values The parsed factor numerator, factor denominator and offset.
+     * @param reciprocal Whether the factor is a reciprocal.
+     * @param exponents The exponents of the constantsCount symbolic constants.
+     */
+    void addConversionRate(const StringPiece strings[UNITS_RATE_STRINGS_COUNT], const double values[3],
+                           bool reciprocal, const int32_t *exponents, UErrorCode &status);
+
+    /**
+     * Writes indexes[] followed by all data sections to `out`: the contents of
+     * units.icu after its data header.
+     */
+    void build(CharString &out, UErrorCode &status) const;
+
+  private:
+    int32_t constantsCount_;
+    int32_t simpleUnitsCount_ = 0;
+    int32_t categoriesCount_ = 0;
+    int32_t conversionRatesCount_ = 0;
+
+    // The sections of the data, each as raw bytes.
+    CharString factors_;
+    CharString exponents_;
+    CharString rateStrings_;
+    CharString simpleUnits_;
+    CharString simpleUnitCategories_;
+    CharString categories_;
+    UnicodeString uchars_;
+    CharString stemTrie_;
+    CharString categoriesTrie_;
+    CharString conversionRatesTrie_;
+    CharString chars_;
+
+    // Appends `s` and a terminating NUL to chars_, and appends its offset into
+    // chars_ to `offsets`.
+    void addString(CharString &offsets, StringPiece s, UErrorCode &status);
+};
+
+} // namespace units
+U_NAMESPACE_END
+
+#endif //__UNITS_PREBUILT_H__
+
+#endif /* #if !UCONFIG_NO_FORMATTING */
@@ -13,8 +13,10 @@
 #include "number_roundingutils.h"
 #include "resource.h"
 #include "unicode/measure.h"
+#include "unifiedcache.h"
 #include "units_data.h"
 #include "units_router.h"
+#include "ustr_imp.h"
 #include <cmath>
 
 U_NAMESPACE_BEGIN
@@ -60,30 +62,32 @@ void UnitsRouter::init(const MeasureUnit &inputUnit, StringPiece region, StringP
         return;
     }
 
-    // TODO: do we want to pass in ConversionRates and UnitPreferences instead
-    // of loading in each UnitsRouter instance? (Or make global?)
-    ConversionRates conversionRates(status);
-    UnitPreferences prefs(status);
+    // Borrow the shared, immutable units data: it is loaded only once per
+    // process rather than once per UnitsRouter.
+    const ConversionRates *conversionRates = ConversionRates::getInstance(status);
+    const UnitPreferences *prefs = UnitPreferences::getInstance(status);
+    const UnitCategories *categories = UnitCategories::getInstance(status);
+    if (U_FAILURE(status)) {
+        return;
+    }
 
     MeasureUnitImpl inputUnitImpl = MeasureUnitImpl::forMeasureUnitMaybeCopy(inputUnit, status);
-    MeasureUnit baseUnit =
-        (extractCompoundBaseUnit(inputUnitImpl, conversionRates, status)).build(status);
-    CharString category = getUnitQuantity(baseUnit.getIdentifier(), status);
+    StringPiece category = categories->getCategory(inputUnitImpl, status);
     if (U_FAILURE(status)) {
         return;
     }
 
     const UnitPreference *const *unitPreferences;
     int32_t preferencesCount = 0;
-    prefs.getPreferencesFor(category.toStringPiece(), usage, region, unitPreferences, preferencesCount,
-                            status);
+    prefs->getPreferencesFor(category, usage, region, unitPreferences, preferencesCount, status);
 
     for (int i = 0; i < preferencesCount; ++i) {
         U_ASSERT(unitPreferences[i] != nullptr);
         const auto &preference = *unitPreferences[i];
 
+        // The same few preference units are parsed by every router.
         MeasureUnitImpl complexTargetUnitImpl =
-            MeasureUnitImpl::forIdentifier(preference.unit.data(), status);
+            MeasureUnitImpl::forIdentifierCached(preference.unit.data(), status);
         if (U_FAILURE(status)) {
             return;
         }
@@ -104,7 +108,7 @@ void UnitsRouter::init(const MeasureUnit &inputUnit, StringPiece region, StringP
                                                   complexTargetUnitImpl.copy(status).build(status));
         converterPreferences_.emplaceBackAndCheckErrorCode(status, inputUnitImpl, complexTargetUnitImpl,
                                                            preference.geq, std::move(precision),
-                                                           conversionRates, status);
+                                                           *conversionRates, status);
 
         if (U_FAILURE(status)) {
             return;
@@ -113,15 +117,46 @@ void UnitsRouter::init(const MeasureUnit &inputUnit, StringPiece region, StringP
 }
 
 RouteResult UnitsRouter::route(double quantity, icu::number::impl::RoundingImpl *rounder, UErrorCode &status) const {
+    const ConverterPreference *converterPreference =
+        converterPreferences_[selectPreference(quantity, rounder, status)];
+    return RouteResult(converterPreference->converter.convert(quantity, rounder, status),
+                       converterPreference->targetUnit.copy(status));
+}
+
+const MeasureUnit &UnitsRouter::route(double quantity, icu::number::impl::RoundingImpl *rounder,
+                                      ConvertedMeasures &result, UErrorCode &status) const {
+    int32_t idx = selectPreference(quantity, rounder, status);
+    converterPreferences_[idx]->converter.convert(quantity, rounder, result, status);
+    return *outputUnits_[idx];
+}
+
+const MeasureUnit &UnitsRouter::route(double quantity, ConvertedMeasures &result,
+                                      UErrorCode &status) const {
+    // A rounder without a precision, like the one of a usage formatter without
+    // a precision: selectPreference() sets the preference's precision.
+    number::impl::RoundingImpl rounder(Precision(), UNUM_ROUND_HALFEVEN, CurrencyUnit(), status);
+    return route(quantity, &rounder, result, status);
+}
+
+int32_t UnitsRouter::selectPreference(double quantity, icu::number::impl::RoundingImpl *rounder,
+                                      UErrorCode &status) const {
     // Find the matching preference
+    U_ASSERT(converterPreferences_.length() > 0);
+    // Preferences are few, and their input unit limits are precomputed: a
+    // linear scan costs one comparison per preference.
+    double inputQuantity = std::abs(quantity) * (1 + DBL_EPSILON);
+    int32_t idx = 0;
     const ConverterPreference *converterPreference = nullptr;
-    for (int32_t i = 0, n = converterPreferences_.length(); i < n; i++) {
-        converterPreference = converterPreferences_[i];
-        if (converterPreference->converter.greaterThanOrEqual(std::abs(quantity) * (1 + DBL_EPSILON),
-                                                              converterPreference->limit)) {
+    for (int32_t n = converterPreferences_.length(); idx < n; idx++) {
+        converterPreference = converterPreferences_[idx];
+        if (converterPreference->reachesLimit(inputQuantity)) {
             break;
         }
     }
+    if (idx == converterPreferences_.length()) {
+        // No limit was reached: use the last preference.
+        idx--;
+    }
     U_ASSERT(converterPreference != nullptr);
 
     // Set up the rounder for this preference's precision
@@ -136,8 +171,7 @@ RouteResult UnitsRouter::route(double quantity, icu::number::impl::RoundingImpl
         }
     }
 
-    return RouteResult(converterPreference->converter.convert(quantity, rounder, status),
-                       converterPreference->targetUnit.copy(status));
+    return idx;
 }
 
 const MaybeStackVector<MeasureUnit> *UnitsRouter::getOutputUnits() const {
@@ -146,6 +180,101 @@ const MaybeStackVector<MeasureUnit> *UnitsRouter::getOutputUnits() const {
     return &outputUnits_;
 }
 
+namespace {
+
+// Cache key for SharedUnitsRouter: the input unit identifier, region and usage.
+class UnitsRouterCacheKey : public CacheKey<SharedUnitsRouter> {
+  public:
+    UnitsRouterCacheKey(const MeasureUnit &inputUnit, StringPiece region, StringPiece usage,
+                        UErrorCode &status)
+        : fInputUnit(inputUnit) {
+        fRegion.append(region, status);
+        fUsage.append(usage, status);
+    }
+    UnitsRouterCacheKey(const UnitsRouterCacheKey &other)
+        : CacheKey<SharedUnitsRouter>(other), fInputUnit(other.fInputUnit) {
+        UErrorCode localStatus = U_ZERO_ERROR;
+        fRegion.append(other.fRegion, localStatus);
+        fUsage.append(other.fUsage, localStatus);
+    }
+    virtual ~UnitsRouterCacheKey();
+
+    virtual int32_t hashCode() const {
+        const char *unit = fInputUnit.getIdentifier();
+        uint32_t hash = (uint32_t)CacheKey<SharedUnitsRouter>::hashCode();
+        hash = 37u * hash + (uint32_t)ustr_hashCharsN(unit, (int32_t)uprv_strlen(unit));
+        hash = 37u * hash + (uint32_t)ustr_hashCharsN(fRegion.data(), fRegion.length());
+        hash = 37u * hash + (uint32_t)ustr_hashCharsN(fUsage.data(), fUsage.length());
+        return (int32_t)hash;
+    }
+    virtual UBool operator==(const CacheKeyBase &other) const {
+        if (this == &other) {
+            return TRUE;
+        }
+        if (!CacheKey<SharedUnitsRouter>::operator==(other)) {
+            return FALSE;
+        }
+        // We know that this and other are of same class if we get this far.
+        const UnitsRouterCacheKey &realOther = static_cast<const UnitsRouterCacheKey &>(other);
+        return realOther.fInputUnit == fInputUnit &&
+               realOther.fRegion.toStringPiece() == fRegion.toStringPiece() &&
+               realOther.fUsage.toStringPiece() == fUsage.toStringPiece();
+    }
+    virtual CacheKeyBase *clone() const {
+        return new UnitsRouterCacheKey(*this);
+    }
+    virtual const SharedUnitsRouter *createObject(const void * /*unused*/,
+                                                  UErrorCode &status) const {
+        LocalPointer<SharedUnitsRouter> result(
+            new SharedUnitsRouter(fInputUnit, fRegion.toStringPiece(), fUsage.toStringPiece(), status),
+            status);
+        if (U_FAILURE(status)) {
+            return nullptr;
+        }
+        result->addRef();
+        return result.orphan();
+    }
+    virtual char *writeDescription(char *buffer, int32_t bufLen) const {
+        CharString description;
+        UErrorCode localStatus = U_ZERO_ERROR;
+        description.append(fInputUnit.getIdentifier(), localStatus)
+            .append('@', localStatus)
+            .append(fRegion, localStatus)
+            .append(':', localStatus)
+            .append(fUsage, localStatus);
+        uprv_strncpy(buffer, description.data(), bufLen);
+        buffer[bufLen - 1] = 0;
+        return buffer;
+    }
+
+  private:
+    MeasureUnit fInputUnit;
+    CharString fRegion;
+    CharString fUsage;
+};
+
+UnitsRouterCacheKey::~UnitsRouterCacheKey() {}
+
+} // namespace
+
+SharedUnitsRouter::~SharedUnitsRouter() {}
+
+const SharedUnitsRouter *SharedUnitsRouter::getInstance(const MeasureUnit &inputUnit,
+                                                        StringPiece region, StringPiece usage,
+                                                        UErrorCode &status) {
+    const UnifiedCache *cache = UnifiedCache::getInstance(status);
+    UnitsRouterCacheKey key(inputUnit, region, usage, status);
+    if (U_FAILURE(status)) {
+        return nullptr;
+    }
+    const SharedUnitsRouter *result = nullptr;
+    cache->get(key, result, status);
+    if (U_FAILURE(status)) {
+        return nullptr;
+    }
+    return result;
+}
+
 } // namespace units
 U_NAMESPACE_END
 
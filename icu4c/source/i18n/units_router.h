@@ -11,6 +11,7 @@
 
 #include "cmemory.h"
 #include "measunit_impl.h"
+#include "sharedobject.h"
 #include "unicode/measunit.h"
 #include "unicode/stringpiece.h"
 #include "unicode/uobject.h"
@@ -57,6 +58,12 @@ struct ConverterPreference : UMemory {
     double limit;
     UnicodeString precision;
 
+    // `limit` expressed in terms of the input unit, precomputed so that most
+    // quantities can be routed without a conversion: see
+    // `ComplexUnitsConverter::getLimitsInInputUnit()`.
+    double inputLimitLow;
+    double inputLimitHigh;
+
     // The output unit for this ConverterPreference. This may be a MIXED unit -
     // for example: "yard-and-foot-and-inch".
     MeasureUnitImpl targetUnit;
@@ -71,7 +78,23 @@ struct ConverterPreference : UMemory {
                         double limit, UnicodeString precision, const ConversionRates &ratesInfo,
                         UErrorCode &status)
         : converter(source, complexTarget, ratesInfo, status), limit(limit),
-          precision(std::move(precision)), targetUnit(complexTarget.copy(status)) {}
+          precision(std::move(precision)), targetUnit(complexTarget.copy(status)) {
+        if (U_SUCCESS(status)) {
+            converter.getLimitsInInputUnit(limit, inputLimitLow, inputLimitHigh);
+        }
+    }
+
+    // Returns true if `quantity`, expressed in terms of the input unit, is
+    // greater than or equal to `limit`.
+    bool reachesLimit(double quantity) const {
+        if (quantity >= inputLimitHigh) {
+            return true;
+        }
+        if (quantity < inputLimitLow) {
+            return false;
+        }
+        return converter.greaterThanOrEqual(quantity, limit);
+    }
 };
 
 } // namespace units
@@ -135,6 +158,29 @@ class U_I18N_API UnitsRouter {
      */
     RouteResult route(double quantity, icu::number::impl::RoundingImpl *rounder, UErrorCode &status) const;
 
+    /**
+     * Performs locale and usage sensitive unit conversion like the route()
+     * overload above, but writes the converted values into caller-provided
+     * storage instead of allocating Measure and MeasureUnitImpl instances.
+     *
+     * @param quantity The quantity to convert, expressed in terms of inputUnit.
+     * @param rounder See route() above.
+     * @param result Receives the converted values.
+     * @param status Receives status.
+     * @return The output unit, owned by this UnitsRouter. This may be a MIXED
+     *     unit, in which case `result` holds a value for each of its units.
+     */
+    const MeasureUnit &route(double quantity, icu::number::impl::RoundingImpl *rounder,
+                             ConvertedMeasures &result, UErrorCode &status) const;
+
+    /**
+     * Like the route() overload above, with a rounder that rounds the last
+     * value of `result` to the precision of the matching preference, in the
+     * default rounding mode (half-even). This is the rounding that
+     * NumberFormatter::usage() applies when no precision is set.
+     */
+    const MeasureUnit &route(double quantity, ConvertedMeasures &result, UErrorCode &status) const;
+
     /**
      * Returns the list of possible output units, i.e. the full set of
      * preferences, for the localized, usage-specific unit preferences.
@@ -156,6 +202,40 @@ class U_I18N_API UnitsRouter {
                                                       UErrorCode &status);
 
     void init(const MeasureUnit &inputUnit, StringPiece locale, StringPiece usage, UErrorCode &status);
+
+    // Returns the index of the preference, in converterPreferences_ and
+    // outputUnits_, that should be used for the given quantity, and sets up
+    // rounder as described for route().
+    int32_t selectPreference(double quantity, icu::number::impl::RoundingImpl *rounder,
+                             UErrorCode &status) const;
+};
+
+/**
+ * A `UnitsRouter` shared through the UnifiedCache. Routers are immutable once
+ * built, so the formatters that need the router for a given input unit,
+ * region and usage can all share a single instance.
+ */
+class U_I18N_API SharedUnitsRouter : public SharedObject {
+  public:
+    /**
+     * Returns the shared router for `inputUnit`, `region` and `usage`,
+     * building it on first use.
+     *
+     * @return The shared router, or nullptr on failure. The caller must call
+     *     removeRef() on it when done with it.
+     */
+    static const SharedUnitsRouter *getInstance(const MeasureUnit &inputUnit, StringPiece region,
+                                                StringPiece usage, UErrorCode &status);
+
+    SharedUnitsRouter(const MeasureUnit &inputUnit, StringPiece region, StringPiece usage,
+                      UErrorCode &status)
+        : fRouter(inputUnit, region, usage, status) {}
+    virtual ~SharedUnitsRouter();
+
+    const UnitsRouter &get() const { return fRouter; }
+
+  private:
+    UnitsRouter fRouter;
 };
 
 } // namespace units
@@ -0,0 +1,200 @@
+// © 2021 and later: Unicode, Inc. and others.
+// License & terms of use: http://www.unicode.org/copyright.html
+
+#include "unicode/utypes.h"
+
+#if !UCONFIG_NO_FORMATTING
+
+#include "unicode/uunits.h"
+#include "capi_helper.h"
+#include "measunit_impl.h"
+#include "units_converter.h"
+#include "units_data.h"
+#include "units_router.h"
+
+using namespace icu;
+using namespace icu::units;
+
+U_NAMESPACE_BEGIN
+namespace units {
+
+/**
+ * Implementation class for UUnitsConverter. Wraps a UnitsConverter.
+ */
+struct UUnitsConverterData : public UMemory,
+        // Magic number as ASCII == "UCV" (Units ConVerter)
+        public IcuCApiHelper<UUnitsConverter, UUnitsConverterData, 0x55435600> {
+    UUnitsConverterData(const MeasureUnitImpl &source, const MeasureUnitImpl &target,
+                        const ConversionRates &rates, UErrorCode &status)
+        : fConverter(source, target, rates, status) {}
+
+    UnitsConverter fConverter;
+};
+
+/**
+ * Implementation class for UUnitsRouter. Holds a reference to a
+ * SharedUnitsRouter, so that routers opened with the same arguments share it.
+ */
+struct UUnitsRouterData : public UMemory,
+        // Magic number as ASCII == "URT" (Units RouTer)
+        public IcuCApiHelper<UUnitsRouter, UUnitsRouterData, 0x55525400> {
+    ~UUnitsRouterData() {
+        SharedObject::clearPtr(fRouter);
+    }
+
+    const SharedUnitsRouter *fRouter = nullptr;
+};
+
+} // namespace units
+U_NAMESPACE_END
+
+U_CAPI UUnitsConverter* U_EXPORT2
+uunitconv_open(const char* sourceUnit, const char* targetUnit, UErrorCode* ec) {
+    if (U_FAILURE(*ec)) {
+        return nullptr;
+    }
+    if (sourceUnit == nullptr || targetUnit == nullptr) {
+        *ec = U_ILLEGAL_ARGUMENT_ERROR;
+        return nullptr;
+    }
+    MeasureUnitImpl source = MeasureUnitImpl::forIdentifier(sourceUnit, *ec);
+    MeasureUnitImpl target = MeasureUnitImpl::forIdentifier(targetUnit, *ec);
+    const ConversionRates *rates = ConversionRates::getInstance(*ec);
+    if (U_FAILURE(*ec)) {
+        return nullptr;
+    }
+    // UnitsConverter reports these as internal errors: here they are the
+    // caller's.
+    if (source.complexity == UMEASURE_UNIT_MIXED || target.complexity == UMEASURE_UNIT_MIXED ||
+        extractConvertibility(source, target, *ec) == UNCONVERTIBLE) {
+        if (U_SUCCESS(*ec)) {
+            *ec = U_ILLEGAL_ARGUMENT_ERROR;
+        }
+        return nullptr;
+    }
+    LocalPointer<UUnitsConverterData> impl(new UUnitsConverterData(source, target, *rates, *ec), *ec);
+    if (U_FAILURE(*ec)) {
+        return nullptr;
+    }
+    return impl.orphan()->exportForC();
+}
+
+U_CAPI double U_EXPORT2
+uunitconv_convert(const UUnitsConverter* uconv, double value, UErrorCode* ec) {
+    const UUnitsConverterData* impl = UUnitsConverterData::validate(uconv, *ec);
+    if (U_FAILURE(*ec)) {
+        return 0;
+    }
+    return impl->fConverter.convert(value);
+}
+
+U_CAPI void U_EXPORT2
+uunitconv_convertArray(const UUnitsConverter* uconv, const double* input, double* output,
+                       int32_t length, UErrorCode* ec) {
+    const UUnitsConverterData* impl = UUnitsConverterData::validate(uconv, *ec);
+    if (U_FAILURE(*ec)) {
+        return;
+    }
+    if (length < 0 || (length > 0 && (input == nullptr || output == nullptr))) {
+        *ec = U_ILLEGAL_ARGUMENT_ERROR;
+        return;
+    }
+    impl->fConverter.convertArray(input, output, length);
+}
+
+U_CAPI void U_EXPORT2
+uunitconv_close(UUnitsConverter* uconv) {
+    UErrorCode localStatus = U_ZERO_ERROR;
+    const UUnitsConverterData* impl = UUnitsConverterData::validate(uconv, localStatus);
+    delete impl;
+}
+
+U_CAPI UUnitsRouter* U_EXPORT2
+uunitrouter_open(const char* inputUnit, const char* region, const char* usage, UErrorCode* ec) {
+    if (U_FAILURE(*ec)) {
+        return nullptr;
+    }
+    if (inputUnit == nullptr || region == nullptr || usage == nullptr) {
+        *ec = U_ILLEGAL_ARGUMENT_ERROR;
+        return nullptr;
+    }
+    MeasureUnit unit = MeasureUnit::forIdentifier(inputUnit, *ec);
+    LocalPointer<UUnitsRouterData> impl(new UUnitsRouterData(), *ec);
+    if (U_FAILURE(*ec)) {
+        return nullptr;
+    }
+    impl->fRouter = SharedUnitsRouter::getInstance(unit, region, usage, *ec);
+    if (U_FAILURE(*ec)) {
+        return nullptr;
+    }
+    return impl.orphan()->exportForC();
+}
+
+U_CAPI int32_t U_EXPORT2
+uunitrouter_countOutputUnits(const UUnitsRouter* urouter, UErrorCode* ec) {
+    const UUnitsRouterData* impl = UUnitsRouterData::validate(urouter, *ec);
+    if (U_FAILURE(*ec)) {
+        return 0;
+    }
+    return impl->fRouter->get().getOutputUnits()->length();
+}
+
+U_CAPI const char* U_EXPORT2
+uunitrouter_getOutputUnit(const UUnitsRouter* urouter, int32_t unitIndex, UErrorCode* ec) {
+    const UUnitsRouterData* impl = UUnitsRouterData::validate(urouter, *ec);
+    if (U_FAILURE(*ec)) {
+        return nullptr;
+    }
+    const MaybeStackVector<MeasureUnit> *outputUnits = impl->fRouter->get().getOutputUnits();
+    if (unitIndex < 0 || unitIndex >= outputUnits->length()) {
+        *ec = U_ILLEGAL_ARGUMENT_ERROR;
+        return nullptr;
+    }
+    return (*outputUnits)[unitIndex]->getIdentifier();
+}
+
+U_CAPI int32_t U_EXPORT2
+uunitrouter_route(const UUnitsRouter* urouter, double value, double* components, int32_t capacity,
+                  int32_t* unitIndex, UErrorCode* ec) {
+    const UUnitsRouterData* impl = UUnitsRouterData::validate(urouter, *ec);
+    if (U_FAILURE(*ec)) {
+        return 0;
+    }
+    if (capacity < 0 || (capacity > 0 && components == nullptr)) {
+        *ec = U_ILLEGAL_ARGUMENT_ERROR;
+        return 0;
+    }
+    const UnitsRouter &router = impl->fRouter->get();
+    ConvertedMeasures converted;
+    const MeasureUnit &outputUnit = router.route(value, converted, *ec);
+    if (U_FAILURE(*ec)) {
+        return 0;
+    }
+    if (unitIndex != nullptr) {
+        // The router returns one of its own output units.
+        const MaybeStackVector<MeasureUnit> *outputUnits = router.getOutputUnits();
+        int32_t index = 0;
+        while ((*outputUnits)[index] != &outputUnit) {
+            index++;
+        }
+        *unitIndex = index;
+    }
+    if (converted.count > capacity) {
+        *ec = U_BUFFER_OVERFLOW_ERROR;
+        return converted.count;
+    }
+    for (int32_t i = 0; i < converted.count; i++) {
+        components[i] = i == converted.indexOfQuantity ? converted.quantity
+                                                       : (double)converted.intValues[i];
+    }
+    return converted.count;
+}
+
+U_CAPI void U_EXPORT2
+uunitrouter_close(UUnitsRouter* urouter) {
+    UErrorCode localStatus = U_ZERO_ERROR;
+    const UUnitsRouterData* impl = UUnitsRouterData::validate(urouter, localStatus);
+    delete impl;
+}
+
+#endif /* #if !UCONFIG_NO_FORMATTING */
@@ -0,0 +1,181 @@
+// © 2021 and later: Unicode, Inc. and others.
+// License & terms of use: http://www.unicode.org/copyright.html
+/*
+******************************************************************************
+*
+* File uunitsfile.h
+*
+******************************************************************************
+*/
+
+#ifndef UUNITSFILE_H
+#define UUNITSFILE_H
+
+#include "unicode/utypes.h"
+
+#if U_SHOW_CPLUSPLUS_API
+
+#if !UCONFIG_NO_FORMATTING && !UCONFIG_NO_CONVERSION
+
+#include "unicode/locid.h"
+#include "unicode/measunit.h"
+#include "unicode/numberformatter.h"
+#include "unicode/stringpiece.h"
+#include "unicode/ustdio.h"
+#include "unicode/utext.h"
+
+/**
+ * \file
+ * \brief C++ API: Streaming unit conversion of delimited text files
+ *
+ * A UnitsFileConverter converts the numbers in a delimited text file, such as
+ * a CSV file, from one unit to another, and writes the file back out with the
+ * converted numbers formatted for the output locale:
+ * <pre>
+ * UErrorCode status = U_ZERO_ERROR;
+ * UnitsFileConverter converter(MeasureUnit::getMeter(), MeasureUnit::getFoot(),
+ *     NumberFormatter::withLocale("en").precision(Precision::maxFraction(2)),
+ *     u',', status);
+ * UFILE *in = u_fopen("heights.csv", "r", "de", "UTF-8");
+ * UFILE *out = u_fopen("heights-ft.csv", "w", "en", "UTF-8");
+ * converter.convert(in, out, status);
+ * u_fclose(in);
+ * u_fclose(out);
+ * </pre>
+ */
+
+#ifndef U_HIDE_DRAFT_API
+
+U_NAMESPACE_BEGIN
+
+class UnitsFileConverterImpl;
+
+/**
+ * Converts the numbers in a delimited text file from one unit to another, or
+ * to the units preferred for a usage in a region.
+ *
+ * The input is read line by line, and split into fields at the delimiter.
+ * Fields that parse completely as numbers, with the decimal number format of
+ * the input locale, are converted and replaced by their formatted value; all
+ * other text, including delimiters and line endings, is copied unchanged.
+ *
+ * Numbers are processed in chunks of 1024, so memory use does not depend on
+ * the size of the input: only the current chunk and its lines are held in
+ * memory, and the output for a chunk is written with a single u_file_write()
+ * call. The buffers, including the one that each number is formatted into,
+ * are reused from chunk to chunk.
+ *
+ * A UnitsFileConverter is not thread-safe: use one per thread.
+ *
+ * @draft ICU 70
+ */
+class U_IO_API UnitsFileConverter : public UMemory {
+  public:
+    /**
+     * Converts from `sourceUnit` to `targetUnit`.
+     *
+     * @param sourceUnit The unit of the numbers in the input. A single or
+     *     compound unit.
+     * @param targetUnit The unit to convert to, of the same quantity as
+     *     `sourceUnit`. A single or compound unit.
+     * @param formatter Formats the converted numbers. To show the target
+     *     unit, set its unit() accordingly.
+     * @param delimiter The field delimiter, such as u',' or u'\\t'.
+     * @param status Set if an error occurs. U_ILLEGAL_ARGUMENT_ERROR if the
+     *     units cannot be converted into each other.
+     * @draft ICU 70
+     */
+    UnitsFileConverter(const MeasureUnit &sourceUnit, const MeasureUnit &targetUnit,
+                       const number::LocalizedNumberFormatter &formatter, UChar delimiter,
+                       UErrorCode &status);
+
+    /**
+     * Converts each number to the unit that the conventions of `region`
+     * prefer for `usage` and for that number, like NumberFormatter's usage().
+     * Mixed output units, such as "foot-and-inch", are formatted as their
+     * space-separated components.
+     *
+     * As with usage(), the last component is rounded to the precision of the
+     * matching unit preference, carrying into the larger components as
+     * needed. The precision of `formatter` only applies to the display of the
+     * rounded values.
+     *
+     * @param inputUnit The unit of the numbers in the input.
+     * @param region The region, such as "US".
+     * @param usage The usage, such as "person-height".
+     * @param formatter The settings for formatting the converted numbers. Its
+     *     unit is replaced with each of the output units.
+     * @param delimiter The field delimiter, such as u',' or u'\\t'.
+     * @param status Set if an error occurs.
+     * @draft ICU 70
+     */
+    UnitsFileConverter(const MeasureUnit &inputUnit, StringPiece region, StringPiece usage,
+                       const number::LocalizedNumberFormatter &formatter, UChar delimiter,
+                       UErrorCode &status);
+
+    /**
+     * Destructor.
+     * @draft ICU 70
+     */
+    ~UnitsFileConverter();
+
+    /**
+     * Sets whether numbers are converted with decimal arithmetic. Off by
+     * default: the numbers are parsed into doubles and converted with
+     * double arithmetic.
+     *
+     * With decimal arithmetic, the fields are parsed into decimal numbers,
+     * which are converted exactly where the conversion rate allows it, and
+     * formatted like LocalizedNumberFormatter::formatDecimal() formats them.
+     * Converting 0.1 foot gives 1.2 inches rather than 1.2000000000000002,
+     * and numbers with more digits than a double holds keep them all.
+     * Converting is much slower than with doubles.
+     *
+     * @param decimal Whether to use decimal arithmetic.
+     * @param status Set if an error occurs. U_UNSUPPORTED_ERROR for a
+     *     UnitsFileConverter that converts to the preferred units of a usage.
+     * @draft ICU 70
+     */
+    void setDecimalArithmetic(UBool decimal, UErrorCode &status);
+
+    /**
+     * Reads `in` up to its end, and writes it to `out` with its numbers
+     * converted. The numbers are parsed with the locale of `in`.
+     *
+     * @param in The input.
+     * @param out The output.
+     * @param status Set if an error occurs.
+     * @return The number of numbers converted.
+     * @draft ICU 70
+     */
+    int64_t convert(UFILE *in, UFILE *out, UErrorCode &status);
+
+    /**
+     * Reads `in` from its current position up to its end, and writes it to
+     * `out` with its numbers converted.
+     *
+     * @param in The input.
+     * @param inputLocale The locale of the numbers in the input.
+     * @param out The output.
+     * @param status Set if an error occurs.
+     * @return The number of numbers converted.
+     * @draft ICU 70
+     */
+    int64_t convert(UText *in, const Locale &inputLocale, UFILE *out, UErrorCode &status);
+
+  private:
+    UnitsFileConverter(const UnitsFileConverter &) = delete;
+    UnitsFileConverter &operator=(const UnitsFileConverter &) = delete;
+
+    UnitsFileConverterImpl *fImpl;
+};
+
+U_NAMESPACE_END
+
+#endif /* U_HIDE_DRAFT_API */
+
+#endif /* #if !UCONFIG_NO_FORMATTING && !UCONFIG_NO_CONVERSION */
+
+#endif /* U_SHOW_CPLUSPLUS_API */
+
+#endif
@@ -0,0 +1,506 @@
+// © 2021 and later: Unicode, Inc. and others.
+// License & terms of use: http://www.unicode.org/copyright.html
+/*
+******************************************************************************
+*
+* File uunitsfile.cpp
+*
+******************************************************************************
+*/
+
+#include "unicode/utypes.h"
+
+#if !UCONFIG_NO_FORMATTING && !UCONFIG_NO_CONVERSION
+
+#include "unicode/unum.h"
+#include "unicode/ustring.h"
+#include "unicode/uunitsfile.h"
+#include "cmemory.h"
+#include "number_decimalquantity.h"
+#include "number_utypes.h"
+#include "units_converter.h"
+#include "units_router.h"
+
+U_NAMESPACE_BEGIN
+
+using number::LocalizedNumberFormatter;
+using number::impl::DecimalQuantity;
+
+namespace {
+
+// The number of values converted and formatted per chunk.
+constexpr int32_t kChunkValues = 1024;
+
+// Characters above this limit in the current chunk also cause a flush, so
+// that lines without numbers do not accumulate.
+constexpr int32_t kChunkTextLimit = 64 * 1024;
+
+// The size of the buffer that lines are read from a UFILE in pieces into.
+constexpr int32_t kLineBufferSize = 1024;
+
+// Returns the number of UChars of `line` without its line ending.
+int32_t lengthWithoutLineEnding(const UChar *line, int32_t length) {
+    if (length > 0 && line[length - 1] == u'\n') {
+        --length;
+    }
+    if (length > 0 && line[length - 1] == u'\r') {
+        --length;
+    }
+    return length;
+}
+
+} // namespace
+
+// The state of a UnitsFileConverter, kept out of the public header.
+class UnitsFileConverterImpl : public UMemory {
+  public:
+    UnitsFileConverterImpl(const LocalizedNumberFormatter &formatter, UChar delimiter)
+        : fFormatter(formatter), fDelimiter(delimiter) {}
+
+    ~UnitsFileConverterImpl() {
+        if (fRouter != nullptr) {
+            fRouter->removeRef();
+        }
+    }
+
+    void initConverter(const MeasureUnit &sourceUnit, const MeasureUnit &targetUnit,
+                       UErrorCode &status);
+    void initRouter(const MeasureUnit &inputUnit, StringPiece region, StringPiece usage,
+                    UErrorCode &status);
+    void setDecimalArithmetic(UBool decimal, UErrorCode &status);
+
+    // Reads either `in` or `text`, whichever is not null.
+    int64_t convert(UFILE *in, UText *text, const char *inputLocale, UFILE *out,
+                    UErrorCode &status);
+
+  private:
+    // Exactly one of fConverter and fRouter is set. fExactConverter is set
+    // along with fConverter for decimal arithmetic.
+    LocalPointer<units::UnitsConverter> fConverter;
+    LocalPointer<units::ExactUnitsConverter> fExactConverter;
+    const units::SharedUnitsRouter *fRouter = nullptr;
+    MeasureUnit fSourceUnit;
+    MeasureUnit fTargetUnit;
+
+    LocalizedNumberFormatter fFormatter;
+
+    // For routing: the formatters for the single units of each output unit of
+    // fRouter, with those of output unit i starting at fComponentStarts[i].
+    MaybeStackVector<LocalizedNumberFormatter> fComponentFormatters;
+    MaybeStackArray<int32_t, 8> fComponentStarts;
+
+    UChar fDelimiter;
+
+    // Parses the fields of the input being converted.
+    LocalUNumberFormatPointer fParser;
+
+    // The current chunk: the text read since the last flush, and the numbers
+    // parsed from it, with the range of text each replaces. With decimal
+    // arithmetic, the numbers are in fDecimals rather than fValues.
+    UnicodeString fText;
+    int32_t fCount = 0;
+    // The number of values converted by flushChunk() since convert() started.
+    int64_t fTotal = 0;
+    LocalMemory<double> fValues;
+    LocalMemory<double> fConverted;
+    LocalArray<DecimalQuantity> fDecimals;
+    LocalMemory<int32_t> fStarts;
+    LocalMemory<int32_t> fLimits;
+    // Receives the decimal numbers parsed by unum_parseDecimal().
+    MaybeStackArray<char, 40> fDecimalBuffer;
+
+    // Every number is formatted into this one result, as in
+    // LocalizedNumberFormatter::formatDoubleArray().
+    number::impl::UFormattedNumberData fResults;
+
+    // The formatted output of the current chunk.
+    UnicodeString fOutput;
+
+    void allocateChunk(UErrorCode &status);
+
+    // Reads one line, including its line ending, and appends it to fText.
+    // Returns false at the end of the input.
+    bool readLine(UFILE *in);
+    bool readLine(UText *text);
+
+    // Parses the fields of the line at [start, limit) in fText.
+    void parseLine(UFILE *out, int32_t start, int32_t limit, UErrorCode &status);
+
+    // Parses the field at [start, limit) in fText into the next number of the
+    // chunk. Returns false if the field is not a number.
+    bool parseField(int32_t start, int32_t limit, UErrorCode &status);
+
+    // Converts the numbers of the current chunk, writes the chunk's text up to
+    // textLimit with the numbers replaced, and removes it from fText.
+    void flushChunk(UFILE *out, int32_t textLimit, UErrorCode &status);
+
+    void appendRouted(double value, UErrorCode &status);
+
+    // Formats fResults.quantity with formatter, and appends it to fOutput.
+    void appendFormatted(const LocalizedNumberFormatter &formatter, UErrorCode &status);
+};
+
+void UnitsFileConverterImpl::initConverter(const MeasureUnit &sourceUnit,
+                                           const MeasureUnit &targetUnit, UErrorCode &status) {
+    allocateChunk(status);
+    fConverter.adoptInsteadAndCheckErrorCode(
+        new units::UnitsConverter(sourceUnit.getIdentifier(), targetUnit.getIdentifier(), status),
+        status);
+    if (U_FAILURE(status)) {
+        return;
+    }
+    fSourceUnit = sourceUnit;
+    fTargetUnit = targetUnit;
+}
+
+void UnitsFileConverterImpl::initRouter(const MeasureUnit &inputUnit, StringPiece region,
+                                        StringPiece usage, UErrorCode &status) {
+    allocateChunk(status);
+    fRouter = units::SharedUnitsRouter::getInstance(inputUnit, region, usage, status);
+    if (U_FAILURE(status)) {
+        return;
+    }
+    const MaybeStackVector<MeasureUnit> *outputUnits = fRouter->get().getOutputUnits();
+    if (fComponentStarts.resize(outputUnits->length() + 1) == nullptr) {
+        status = U_MEMORY_ALLOCATION_ERROR;
+        return;
+    }
+    for (int32_t i = 0; i < outputUnits->length(); i++) {
+        fComponentStarts[i] = fComponentFormatters.length();
+        auto singleUnits = (*outputUnits)[i]->splitToSingleUnits(status);
+        for (int32_t j = 0; j < singleUnits.second; j++) {
+            fComponentFormatters.emplaceBackAndCheckErrorCode(status,
+                                                              fFormatter.unit(singleUnits.first[j]));
+        }
+        if (U_FAILURE(status)) {
+            return;
+        }
+    }
+    fComponentStarts[outputUnits->length()] = fComponentFormatters.length();
+}
+
+void UnitsFileConverterImpl::setDecimalArithmetic(UBool decimal, UErrorCode &status) {
+    if (U_FAILURE(status)) {
+        return;
+    }
+    if (fConverter.isNull()) {
+        status = U_UNSUPPORTED_ERROR;
+        return;
+    }
+    if (!decimal) {
+        fExactConverter.adoptInstead(nullptr);
+        return;
+    }
+    if (fExactConverter.isValid()) {
+        return;
+    }
+    fExactConverter.adoptInsteadAndCheckErrorCode(
+        new units::ExactUnitsConverter(fSourceUnit.getIdentifier(), fTargetUnit.getIdentifier(),
+                                       status),
+        status);
+    if (U_FAILURE(status)) {
+        fExactConverter.adoptInstead(nullptr);
+        return;
+    }
+    if (fDecimals.isNull()) {
+        fDecimals.adoptInsteadAndCheckErrorCode(new DecimalQuantity[kChunkValues], status);
+        if (U_FAILURE(status)) {
+            fExactConverter.adoptInstead(nullptr);
+        }
+    }
+}
+
+void UnitsFileConverterImpl::allocateChunk(UErrorCode &status) {
+    if (U_FAILURE(status)) {
+        return;
+    }
+    if (fValues.allocateInsteadAndReset(kChunkValues) == nullptr ||
+        fConverted.allocateInsteadAndReset(kChunkValues) == nullptr ||
+        fStarts.allocateInsteadAndReset(kChunkValues) == nullptr ||
+        fLimits.allocateInsteadAndReset(kChunkValues) == nullptr) {
+        status = U_MEMORY_ALLOCATION_ERROR;
+    }
+}
+
+int64_t UnitsFileConverterImpl::convert(UFILE *in, UText *text, const char *inputLocale,
+                                        UFILE *out, UErrorCode &status) {
+    fParser.adoptInstead(unum_open(UNUM_DECIMAL, nullptr, 0, inputLocale, nullptr, &status));
+    if (U_FAILURE(status)) {
+        return 0;
+    }
+    fText.remove();
+    fCount = 0;
+    fTotal = 0;
+    for (;;) {
+        int32_t start = fText.length();
+        if (!(in != nullptr ? readLine(in) : readLine(text))) {
+            break;
+        }
+        int32_t limit =
+            start + lengthWithoutLineEnding(fText.getBuffer() + start, fText.length() - start);
+        parseLine(out, start, limit, status);
+        if (U_FAILURE(status)) {
+            return fTotal;
+        }
+        if (fCount == kChunkValues || fText.length() >= kChunkTextLimit) {
+            flushChunk(out, fText.length(), status);
+        }
+    }
+    flushChunk(out, fText.length(), status);
+    return fTotal;
+}
+
+bool UnitsFileConverterImpl::readLine(UFILE *in) {
+    UChar buffer[kLineBufferSize];
+    bool read = false;
+    while (u_fgets(buffer, UPRV_LENGTHOF(buffer), in) != nullptr) {
+        int32_t length = u_strlen(buffer);
+        fText.append(buffer, length);
+        read = true;
+        if (length > 0 && buffer[length - 1] == u'\n') {
+            break;
+        }
+    }
+    return read;
+}
+
+bool UnitsFileConverterImpl::readLine(UText *text) {
+    bool read = false;
+    for (UChar32 c; (c = UTEXT_NEXT32(text)) != U_SENTINEL;) {
+        fText.append(c);
+        read = true;
+        if (c == u'\n') {
+            break;
+        }
+    }
+    return read;
+}
+
+void UnitsFileConverterImpl::parseLine(UFILE *out, int32_t start, int32_t limit,
+                                       UErrorCode &status) {
+    int32_t fieldStart = start;
+    for (;;) {
+        int32_t fieldLimit = fText.indexOf(fDelimiter, fieldStart, limit - fieldStart);
+        if (fieldLimit < 0) {
+            fieldLimit = limit;
+        }
+        if (fieldLimit > fieldStart) {
+            if (fCount == kChunkValues) {
+                // The chunk is full: write out everything before this field.
+                flushChunk(out, fieldStart, status);
+                limit -= fieldStart;
+                fieldLimit -= fieldStart;
+                fieldStart = 0;
+            }
+            if (parseField(fieldStart, fieldLimit, status)) {
+                fStarts[fCount] = fieldStart;
+                fLimits[fCount] = fieldLimit;
+                fCount++;
+            }
+            if (U_FAILURE(status)) {
+                return;
+            }
+        }
+        if (fieldLimit == limit) {
+            return;
+        }
+        fieldStart = fieldLimit + 1;
+    }
+}
+
+bool UnitsFileConverterImpl::parseField(int32_t start, int32_t limit, UErrorCode &status) {
+    if (U_FAILURE(status)) {
+        return false;
+    }
+    const UChar *field = fText.getBuffer() + start;
+    int32_t length = limit - start;
+    UErrorCode parseStatus = U_ZERO_ERROR;
+    int32_t position = 0;
+    if (fExactConverter.isNull()) {
+        fValues[fCount] =
+            unum_parseDouble(fParser.getAlias(), field, length, &position, &parseStatus);
+        return U_SUCCESS(parseStatus) && position == length;
+    }
+    int32_t decimalLength =
+        unum_parseDecimal(fParser.getAlias(), field, length, &position, fDecimalBuffer.getAlias(),
+                          fDecimalBuffer.getCapacity(), &parseStatus);
+    if (parseStatus == U_BUFFER_OVERFLOW_ERROR) {
+        if (fDecimalBuffer.resize(decimalLength + 1) == nullptr) {
+            status = U_MEMORY_ALLOCATION_ERROR;
+            return false;
+        }
+        parseStatus = U_ZERO_ERROR;
+        position = 0;
+        decimalLength =
+            unum_parseDecimal(fParser.getAlias(), field, length, &position,
+                              fDecimalBuffer.getAlias(), fDecimalBuffer.getCapacity(), &parseStatus);
+    }
+    if (U_FAILURE(parseStatus) || position != length) {
+        return false;
+    }
+    fDecimals[fCount].setToDecNumber(StringPiece(fDecimalBuffer.getAlias(), decimalLength), status);
+    return U_SUCCESS(status);
+}
+
+void UnitsFileConverterImpl::flushChunk(UFILE *out, int32_t textLimit, UErrorCode &status) {
+    if (U_FAILURE(status)) {
+        return;
+    }
+    bool decimal = fExactConverter.isValid();
+    if (fConverter.isValid() && !decimal) {
+        fConverter->convertArray(fValues.getAlias(), fConverted.getAlias(), fCount);
+    }
+    fOutput.remove();
+    int32_t position = 0;
+    for (int32_t i = 0; i < fCount; i++) {
+        fOutput.append(fText, position, fStarts[i] - position);
+        if (decimal) {
+            fExactConverter->convert(fDecimals[i], status);
+            fResults.quantity = fDecimals[i];
+            appendFormatted(fFormatter, status);
+        } else if (fConverter.isValid()) {
+            fResults.quantity.setToDouble(fConverted[i]);
+            appendFormatted(fFormatter, status);
+        } else {
+            appendRouted(fValues[i], status);
+        }
+        position = fLimits[i];
+    }
+    if (U_FAILURE(status)) {
+        return;
+    }
+    fOutput.append(fText, position, textLimit - position);
+    if (fOutput.isBogus()) {
+        status = U_MEMORY_ALLOCATION_ERROR;
+        return;
+    }
+    if (u_file_write(fOutput.getBuffer(), fOutput.length(), out) != fOutput.length()) {
+        status = U_FILE_ACCESS_ERROR;
+        return;
+    }
+    fText.remove(0, textLimit);
+    fTotal += fCount;
+    fCount = 0;
+}
+
+void UnitsFileConverterImpl::appendRouted(double value, UErrorCode &status) {
+    const units::UnitsRouter &router = fRouter->get();
+    units::ConvertedMeasures routed;
+    const MeasureUnit &outputUnit = router.route(value, routed, status);
+    if (U_FAILURE(status)) {
+        return;
+    }
+    const MaybeStackVector<MeasureUnit> *outputUnits = router.getOutputUnits();
+    int32_t index = 0;
+    while (index < outputUnits->length() && (*outputUnits)[index] != &outputUnit) {
+        index++;
+    }
+    if (index == outputUnits->length() ||
+        fComponentStarts[index + 1] - fComponentStarts[index] != routed.count) {
+        status = U_INTERNAL_PROGRAM_ERROR;
+        return;
+    }
+    for (int32_t i = 0; i < routed.count; i++) {
+        if (i > 0) {
+            fOutput.append(u' ');
+        }
+        if (i == routed.indexOfQuantity) {
+            fResults.quantity.setToDouble(routed.quantity);
+        } else {
+            fResults.quantity.setToLong(routed.intValues[i]);
+        }
+        appendFormatted(*fComponentFormatters[fComponentStarts[index] + i], status);
+    }
+}
+
+void UnitsFileConverterImpl::appendFormatted(const LocalizedNumberFormatter &formatter,
+                                             UErrorCode &status) {
+    FormattedStringBuilder &string = fResults.getStringRef();
+    string.clear();
+    formatter.formatImpl(&fResults, status);
+    if (U_SUCCESS(status)) {
+        fOutput.append(string.chars(), string.length());
+    }
+}
+
+UnitsFileConverter::UnitsFileConverter(const MeasureUnit &sourceUnit,
+                                       const MeasureUnit &targetUnit,
+                                       const LocalizedNumberFormatter &formatter, UChar delimiter,
+                                       UErrorCode &status)
+    : fImpl(nullptr) {
+    LocalPointer<UnitsFileConverterImpl> impl(new UnitsFileConverterImpl(formatter, delimiter),
+                                              status);
+    if (U_FAILURE(status)) {
+        return;
+    }
+    impl->initConverter(sourceUnit, targetUnit, status);
+    if (U_SUCCESS(status)) {
+        fImpl = impl.orphan();
+    }
+}
+
+UnitsFileConverter::UnitsFileConverter(const MeasureUnit &inputUnit, StringPiece region,
+                                       StringPiece usage,
+                                       const LocalizedNumberFormatter &formatter, UChar delimiter,
+                                       UErrorCode &status)
+    : fImpl(nullptr) {
+    LocalPointer<UnitsFileConverterImpl> impl(new UnitsFileConverterImpl(formatter, delimiter),
+                                              status);
+    if (U_FAILURE(status)) {
+        return;
+    }
+    impl->initRouter(inputUnit, region, usage, status);
+    if (U_SUCCESS(status)) {
+        fImpl = impl.orphan();
+    }
+}
+
+UnitsFileConverter::~UnitsFileConverter() {
+    delete fImpl;
+}
+
+void UnitsFileConverter::setDecimalArithmetic(UBool decimal, UErrorCode &status) {
+    if (U_FAILURE(status)) {
+        return;
+    }
+    if (fImpl == nullptr) {
+        status = U_INVALID_STATE_ERROR;
+        return;
+    }
+    fImpl->setDecimalArithmetic(decimal, status);
+}
+
+int64_t UnitsFileConverter::convert(UFILE *in, UFILE *out, UErrorCode &status) {
+    if (U_FAILURE(status)) {
+        return 0;
+    }
+    if (fImpl == nullptr) {
+        status = U_INVALID_STATE_ERROR;
+        return 0;
+    }
+    if (in == nullptr || out == nullptr) {
+        status = U_ILLEGAL_ARGUMENT_ERROR;
+        return 0;
+    }
+    return fImpl->convert(in, nullptr, u_fgetlocale(in), out, status);
+}
+
+int64_t UnitsFileConverter::convert(UText *in, const Locale &inputLocale, UFILE *out,
+                                    UErrorCode &status) {
+    if (U_FAILURE(status)) {
+        return 0;
+    }
+    if (fImpl == nullptr) {
+        status = U_INVALID_STATE_ERROR;
+        return 0;
+    }
+    if (in == nullptr || out == nullptr) {
+        status = U_ILLEGAL_ARGUMENT_ERROR;
+        return 0;
+    }
+    return fImpl->convert(nullptr, in, inputLocale.getName(), out, status);
+}
+
+U_NAMESPACE_END
+
+#endif /* #if !UCONFIG_NO_FORMATTING && !UCONFIG_NO_CONVERSION */
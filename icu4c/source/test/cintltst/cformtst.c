@@ -42,6 +42,7 @@ void addUListFmtTest(TestNode** root);
 void addUNumberFormatterTest(TestNode** root);
 void addUFormattedValueTest(TestNode** root);
 void addUNumberRangeFormatterTest(TestNode** root);
+void addUUnitsTest(TestNode** root);
 
 void addFormatTest(TestNode** root);
 
@@ -67,6 +68,7 @@ void addFormatTest(TestNode** root)
     addUNumberFormatterTest(root);
     addUFormattedValueTest(root);
     addUNumberRangeFormatterTest(root);
+    addUUnitsTest(root);
 }
 /*Internal functions used*/
 
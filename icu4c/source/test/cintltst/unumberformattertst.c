@@ -30,6 +30,12 @@ static void TestSkeletonParseError(void);
 
 static void TestToDecimalNumber(void);
 
+static void TestResultToUTF8(void);
+
+static void TestFormatDoubleArray(void);
+
+static void TestFormatDoubleArrayToUTF8(void);
+
 static void TestPerUnitInArabic(void);
 
 void addUNumberFormatterTest(TestNode** root);
@@ -43,6 +49,9 @@ void addUNumberFormatterTest(TestNode** root) {
     TESTCASE(TestFormattedValue);
     TESTCASE(TestSkeletonParseError);
     TESTCASE(TestToDecimalNumber);
+    TESTCASE(TestResultToUTF8);
+    TESTCASE(TestFormatDoubleArray);
+    TESTCASE(TestFormatDoubleArrayToUTF8);
     TESTCASE(TestPerUnitInArabic);
 }
 
@@ -289,6 +298,113 @@ static void TestToDecimalNumber() {
     unumf_closeResult(uresult);
     unumf_close(uformatter);
 }
+static void TestResultToUTF8() {
+    UErrorCode ec = U_ZERO_ERROR;
+    UNumberFormatter* uformatter = unumf_openForSkeletonAndLocale(
+        u"currency/EUR",
+        -1,
+        "de",
+        &ec);
+    assertSuccessCheck("Should create without error", &ec, TRUE);
+    UFormattedNumber* uresult = unumf_openResult(&ec);
+    assertSuccess("Should create result without error", &ec);
+
+    unumf_formatDouble(uformatter, 1234.5, uresult, &ec);
+    assertSuccessCheck("Formatting should succeed", &ec, TRUE);
+
+    // "1.234,50 €": the no-break space and the euro sign take 2 and 3 bytes.
+    static const char expected[] = "1.234,50\xC2\xA0\xE2\x82\xAC";
+    int32_t len = unumf_resultToUTF8(uresult, NULL, 0, &ec);
+    assertIntEquals("Preflighting should set overflow", U_BUFFER_OVERFLOW_ERROR, ec);
+    assertIntEquals("Preflighting should return the length", (int32_t)strlen(expected), len);
+    ec = U_ZERO_ERROR;
+
+    char buffer[CAPACITY];
+    len = unumf_resultToUTF8(uresult, buffer, 5, &ec);
+    assertIntEquals("Too small buffer should set overflow", U_BUFFER_OVERFLOW_ERROR, ec);
+    assertIntEquals("Too small buffer should return the length", (int32_t)strlen(expected), len);
+    ec = U_ZERO_ERROR;
+
+    len = unumf_resultToUTF8(uresult, buffer, CAPACITY, &ec);
+    assertSuccessCheck("Extracting should succeed", &ec, TRUE);
+    assertIntEquals("Length should be as expected", (int32_t)strlen(expected), len);
+    assertEquals("UTF-8 string should be as expected", expected, buffer);
+
+    // cleanup:
+    unumf_closeResult(uresult);
+    unumf_close(uformatter);
+}
+
+static void TestFormatDoubleArray() {
+    UErrorCode ec = U_ZERO_ERROR;
+    UNumberFormatter* uformatter = unumf_openForSkeletonAndLocale(
+        u"currency/USD",
+        -1,
+        "en-US",
+        &ec);
+    assertSuccessCheck("Should create without error", &ec, TRUE);
+
+    static const double values[] = {3.0, -1234.5, 0.125};
+    int32_t offsets[UPRV_LENGTHOF(values) + 1];
+    UChar buffer[CAPACITY];
+
+    int32_t len = unumf_formatDoubleArray(uformatter, values, UPRV_LENGTHOF(values), NULL, 0, offsets, &ec);
+    assertIntEquals("Preflighting should set overflow", U_BUFFER_OVERFLOW_ERROR, ec);
+    assertIntEquals("Preflighting should return the length", 20, len);
+    ec = U_ZERO_ERROR;
+
+    len = unumf_formatDoubleArray(uformatter, values, UPRV_LENGTHOF(values), buffer, CAPACITY, offsets, &ec);
+    assertSuccessCheck("Formatting should succeed", &ec, TRUE);
+    assertUEquals("Should produce the concatenated results", u"$3.00-$1,234.50$0.12", buffer);
+    assertIntEquals("offsets[0]", 0, offsets[0]);
+    assertIntEquals("offsets[1]", 5, offsets[1]);
+    assertIntEquals("offsets[2]", 15, offsets[2]);
+    assertIntEquals("offsets[3]", 20, offsets[3]);
+
+    unumf_formatDoubleArray(uformatter, values, -1, buffer, CAPACITY, offsets, &ec);
+    assertIntEquals("Negative count should fail", U_ILLEGAL_ARGUMENT_ERROR, ec);
+    ec = U_ZERO_ERROR;
+
+    // cleanup:
+    unumf_close(uformatter);
+}
+
+static void TestFormatDoubleArrayToUTF8() {
+    UErrorCode ec = U_ZERO_ERROR;
+    UNumberFormatter* uformatter = unumf_openForSkeletonAndLocale(
+        u"currency/EUR",
+        -1,
+        "en-US",
+        &ec);
+    assertSuccessCheck("Should create without error", &ec, TRUE);
+
+    static const double values[] = {3.0, -1234.5, 0.125};
+    int32_t offsets[UPRV_LENGTHOF(values) + 1];
+    char buffer[CAPACITY];
+
+    // The euro sign takes 3 bytes.
+    int32_t len = unumf_formatDoubleArrayToUTF8(uformatter, values, UPRV_LENGTHOF(values), NULL, 0, offsets, &ec);
+    assertIntEquals("Preflighting should set overflow", U_BUFFER_OVERFLOW_ERROR, ec);
+    assertIntEquals("Preflighting should return the length", 26, len);
+    ec = U_ZERO_ERROR;
+
+    len = unumf_formatDoubleArrayToUTF8(uformatter, values, UPRV_LENGTHOF(values), buffer, CAPACITY, offsets, &ec);
+    assertSuccessCheck("Formatting should succeed", &ec, TRUE);
+    assertEquals("Should produce the concatenated results",
+        "\xE2\x82\xAC" "3.00-\xE2\x82\xAC" "1,234.50\xE2\x82\xAC" "0.12", buffer);
+    assertIntEquals("offsets[0]", 0, offsets[0]);
+    assertIntEquals("offsets[1]", 7, offsets[1]);
+    assertIntEquals("offsets[2]", 19, offsets[2]);
+    assertIntEquals("offsets[3]", 26, offsets[3]);
+
+    unumf_formatDoubleArrayToUTF8(uformatter, values, -1, buffer, CAPACITY, offsets, &ec);
+    assertIntEquals("Negative count should fail", U_ILLEGAL_ARGUMENT_ERROR, ec);
+    ec = U_ZERO_ERROR;
+
+    // cleanup:
+    unumf_close(uformatter);
+}
+
 
 
 static void TestPerUnitInArabic() {
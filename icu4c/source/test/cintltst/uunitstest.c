@@ -0,0 +1,206 @@
+// © 2021 and later: Unicode, Inc. and others.
+// License & terms of use: http://www.unicode.org/copyright.html
+/* C API TEST for UUnitsConverter and UUnitsRouter */
+
+#include "unicode/utypes.h"
+
+#if !UCONFIG_NO_FORMATTING
+
+#include <math.h>
+#include "unicode/uunits.h"
+#include "cintltst.h"
+#include "cmemory.h"
+#include "cformtst.h"
+
+static void TestExampleCode(void);
+static void TestConverter(void);
+static void TestConverterErrors(void);
+static void TestRouter(void);
+static void TestRouterErrors(void);
+
+void addUUnitsTest(TestNode** root);
+
+#define TESTCASE(x) addTest(root, &x, "tsformat/uunitstest/" #x)
+
+void addUUnitsTest(TestNode** root)
+{
+    TESTCASE(TestExampleCode);
+    TESTCASE(TestConverter);
+    TESTCASE(TestConverterErrors);
+    TESTCASE(TestRouter);
+    TESTCASE(TestRouterErrors);
+}
+
+static void assertDoubleNear(const char* msg, double expected, double actual) {
+    if (fabs(expected - actual) > 1e-9 * fabs(expected)) {
+        log_err("%s: expected %.17g, got %.17g\n", msg, expected, actual);
+    }
+}
+
+static void TestExampleCode() {
+    // This is the example code given in uunits.h.
+    UErrorCode ec = U_ZERO_ERROR;
+    UUnitsConverter* uconv = uunitconv_open("meter", "foot", &ec);
+    double feet = uunitconv_convert(uconv, 2.5, &ec);
+    uunitconv_close(uconv);
+    if (!assertSuccessCheck("Converter example", &ec, TRUE)) {
+        return;
+    }
+    assertDoubleNear("2.5 meters in feet", 2.5 / 0.3048, feet);
+
+    UUnitsRouter* urouter = uunitrouter_open("meter", "US", "person-height", &ec);
+    double values[4];
+    int32_t unitIndex;
+    int32_t count = uunitrouter_route(urouter, 1.8, values, 4, &unitIndex, &ec);
+    if (assertSuccessCheck("Router example", &ec, TRUE)) {
+        assertIntEquals("Component count", 2, count);
+        assertDoubleNear("Feet", 5, values[0]);
+        assertDoubleNear("Inches", 11, values[1]);
+        assertEquals("Output unit", "foot-and-inch",
+                     uunitrouter_getOutputUnit(urouter, unitIndex, &ec));
+        assertSuccess("getOutputUnit", &ec);
+    }
+    uunitrouter_close(urouter);
+}
+
+static void TestConverter() {
+    UErrorCode ec = U_ZERO_ERROR;
+    UUnitsConverter* uconv = uunitconv_open("celsius", "fahrenheit", &ec);
+    if (!assertSuccessCheck("uunitconv_open", &ec, TRUE)) {
+        return;
+    }
+    assertDoubleNear("100 C", 212, uunitconv_convert(uconv, 100, &ec));
+    assertDoubleNear("-40 C", -40, uunitconv_convert(uconv, -40, &ec));
+
+    double values[] = {0, 37, 100, -40};
+    double expected[] = {32, 98.6, 212, -40};
+    double converted[UPRV_LENGTHOF(values)];
+    uunitconv_convertArray(uconv, values, converted, UPRV_LENGTHOF(values), &ec);
+    // In place.
+    uunitconv_convertArray(uconv, values, values, UPRV_LENGTHOF(values), &ec);
+    assertSuccess("uunitconv_convertArray", &ec);
+    for (int32_t i = 0; i < UPRV_LENGTHOF(values); i++) {
+        assertDoubleNear("convertArray", expected[i], converted[i]);
+        assertDoubleNear("convertArray in place", expected[i], values[i]);
+    }
+    uunitconv_close(uconv);
+
+    // Reciprocal units.
+    uconv = uunitconv_open("liter-per-100-kilometer", "mile-per-gallon", &ec);
+    if (assertSuccess("uunitconv_open reciprocal", &ec)) {
+        assertDoubleNear("10 L/100km", 23.521458329482052, uunitconv_convert(uconv, 10, &ec));
+    }
+    uunitconv_close(uconv);
+    uunitconv_close(NULL);
+}
+
+static void TestConverterErrors() {
+    static const char* const cases[][2] = {
+        {"meter", "pound"},
+        {"meter", "foot-and-inch"},
+        {"meter", "not-a-unit"},
+    };
+    for (int32_t i = 0; i < UPRV_LENGTHOF(cases); i++) {
+        UErrorCode ec = U_ZERO_ERROR;
+        UUnitsConverter* uconv = uunitconv_open(cases[i][0], cases[i][1], &ec);
+        if (ec != U_ILLEGAL_ARGUMENT_ERROR || uconv != NULL) {
+            log_err("uunitconv_open(%s, %s): expected U_ILLEGAL_ARGUMENT_ERROR, got %s\n",
+                    cases[i][0], cases[i][1], u_errorName(ec));
+        }
+        uunitconv_close(uconv);
+    }
+
+    UErrorCode ec = U_ZERO_ERROR;
+    uunitconv_convert(NULL, 1, &ec);
+    if (ec != U_ILLEGAL_ARGUMENT_ERROR) {
+        log_err("uunitconv_convert(NULL): expected U_ILLEGAL_ARGUMENT_ERROR, got %s\n",
+                u_errorName(ec));
+    }
+}
+
+static void TestRouter() {
+    UErrorCode ec = U_ZERO_ERROR;
+    UUnitsRouter* urouter = uunitrouter_open("meter", "US", "road", &ec);
+    if (!assertSuccessCheck("uunitrouter_open", &ec, TRUE)) {
+        return;
+    }
+    int32_t unitCount = uunitrouter_countOutputUnits(urouter, &ec);
+    assertTrue("Several output units", unitCount > 1);
+
+    double value;
+    int32_t unitIndex = -1;
+    int32_t count = uunitrouter_route(urouter, -10000, &value, 1, &unitIndex, &ec);
+    assertSuccess("uunitrouter_route", &ec);
+    assertIntEquals("Component count", 1, count);
+    // Rounded like NumberFormatter's usage() without a precision: to integers,
+    // with at least two significant digits.
+    assertDoubleNear("Miles", -6.2, value);
+    assertTrue("Unit index", 0 <= unitIndex && unitIndex < unitCount);
+    assertEquals("Output unit", "mile", uunitrouter_getOutputUnit(urouter, unitIndex, &ec));
+    assertSuccess("uunitrouter_getOutputUnit", &ec);
+    uunitrouter_close(urouter);
+
+    // Negative mixed units.
+    urouter = uunitrouter_open("kilogram", "GB", "person", &ec);
+    if (assertSuccess("uunitrouter_open", &ec)) {
+        double values[3];
+        count = uunitrouter_route(urouter, -70, values, UPRV_LENGTHOF(values), NULL, &ec);
+        assertSuccess("uunitrouter_route", &ec);
+        assertIntEquals("Component count", 2, count);
+        assertDoubleNear("Stones", -11, values[0]);
+        assertDoubleNear("Pounds", -0.32, values[1]);
+    }
+    uunitrouter_close(urouter);
+
+    // The smallest unit is rounded, and rounding carries into the larger
+    // units: 1.8237 m is 5 ft 11.799 in, which rounds to 6 ft 0 in.
+    urouter = uunitrouter_open("meter", "US", "person-height", &ec);
+    if (assertSuccess("uunitrouter_open", &ec)) {
+        double values[2];
+        count = uunitrouter_route(urouter, 1.8237, values, UPRV_LENGTHOF(values), NULL, &ec);
+        assertSuccess("uunitrouter_route", &ec);
+        assertIntEquals("Component count", 2, count);
+        assertDoubleNear("Feet", 6, values[0]);
+        assertDoubleNear("Inches", 0, values[1]);
+
+        count = uunitrouter_route(urouter, -1.8237, values, UPRV_LENGTHOF(values), NULL, &ec);
+        assertSuccess("uunitrouter_route", &ec);
+        assertDoubleNear("Negative feet", -6, values[0]);
+        assertDoubleNear("Negative inches", 0, values[1]);
+    }
+    uunitrouter_close(urouter);
+    uunitrouter_close(NULL);
+}
+
+static void TestRouterErrors() {
+    UErrorCode ec = U_ZERO_ERROR;
+    UUnitsRouter* urouter = uunitrouter_open("not-a-unit", "US", "road", &ec);
+    if (ec != U_ILLEGAL_ARGUMENT_ERROR || urouter != NULL) {
+        log_err("uunitrouter_open(not-a-unit): expected U_ILLEGAL_ARGUMENT_ERROR, got %s\n",
+                u_errorName(ec));
+    }
+    uunitrouter_close(urouter);
+
+    ec = U_ZERO_ERROR;
+    urouter = uunitrouter_open("meter", "US", "person-height", &ec);
+    if (!assertSuccessCheck("uunitrouter_open", &ec, TRUE)) {
+        return;
+    }
+    // Preflighting.
+    int32_t count = uunitrouter_route(urouter, 1.8, NULL, 0, NULL, &ec);
+    if (ec != U_BUFFER_OVERFLOW_ERROR) {
+        log_err("uunitrouter_route(capacity 0): expected U_BUFFER_OVERFLOW_ERROR, got %s\n",
+                u_errorName(ec));
+    }
+    assertIntEquals("Preflighted component count", 2, count);
+
+    ec = U_ZERO_ERROR;
+    uunitrouter_getOutputUnit(urouter, uunitrouter_countOutputUnits(urouter, &ec), &ec);
+    if (ec != U_ILLEGAL_ARGUMENT_ERROR) {
+        log_err("uunitrouter_getOutputUnit(out of range): expected U_ILLEGAL_ARGUMENT_ERROR, "
+                "got %s\n", u_errorName(ec));
+    }
+    uunitrouter_close(urouter);
+}
+
+#endif /* #if !UCONFIG_NO_FORMATTING */
@@ -96,6 +96,8 @@ class MeasureFormatTest : public IntlTest {
     void Test21060_AddressSanitizerProblem();
     void Test21223_FrenchDuration();
     void TestInternalMeasureUnitImpl();
+    void TestMeasureUnitImplIdentifierCache();
+    void TestUnitEqualityAndHash();
 
     void verifyFormat(
         const char *description,
@@ -230,6 +232,8 @@ void MeasureFormatTest::runIndexedTest(
     TESTCASE_AUTO(Test21060_AddressSanitizerProblem);
     TESTCASE_AUTO(Test21223_FrenchDuration);
     TESTCASE_AUTO(TestInternalMeasureUnitImpl);
+    TESTCASE_AUTO(TestMeasureUnitImplIdentifierCache);
+    TESTCASE_AUTO(TestUnitEqualityAndHash);
     TESTCASE_AUTO_END;
 }
 
@@ -5051,8 +5055,142 @@ void MeasureFormatTest::TestInternalMeasureUnitImpl() {
     }
     assertEquals("meter-square-meter: identifier", "cubic-meter",
                  std::move(m2m).build(status).getIdentifier());
+
+    // More single units than are stored inline.
+    MeasureUnitImpl m6 = MeasureUnitImpl::forIdentifier(
+        "kilogram-meter-ampere-kelvin-per-second-candela", status);
+    status.assertSuccess();
+    assertEquals("6 units: units length", 6, m6.singleUnits.length());
+    MeasureUnitImpl m6copy = m6.copy(status);
+    m6 = std::move(m6copy);
+    status.assertSuccess();
+    assertEquals("6 units moved: units length", 6, m6.singleUnits.length());
+    if (m6.singleUnits.length() >= 6) {
+        assertEquals("6 units: units[5]", "candela", m6.singleUnits[5]->getSimpleUnitID());
+        assertEquals("6 units: units[5] power", -1, m6.singleUnits[5]->dimensionality);
+    }
+    assertEquals("6 units: identifier", "kilogram-meter-ampere-kelvin-per-candela-second",
+                 std::move(m6).build(status).getIdentifier());
 }
 
+void MeasureFormatTest::TestMeasureUnitImplIdentifierCache() {
+    IcuTestErrorCode status(*this, "TestMeasureUnitImplIdentifierCache");
+    const char *identifiers[] = {
+        "meter",
+        "foot-and-inch",
+        "kilogram-meter-per-square-second",
+        "liter-per-100-kilometer",
+    };
+    int32_t hitsBefore, missesBefore;
+    MeasureUnitImpl::getIdentifierCacheCounts(hitsBefore, missesBefore);
+
+    // Twice: parsed on the first pass, unless already cached, and found in the
+    // cache on the second.
+    for (int32_t pass = 0; pass < 2; pass++) {
+        for (const char *identifier : identifiers) {
+            MeasureUnitImpl expected = MeasureUnitImpl::forIdentifier(identifier, status);
+            MeasureUnitImpl cached = MeasureUnitImpl::forIdentifierCached(identifier, status);
+            if (status.errIfFailureAndReset("%s", identifier)) {
+                continue;
+            }
+            assertEquals(identifier, expected.complexity, cached.complexity);
+            assertEquals(identifier, expected.singleUnits.length(), cached.singleUnits.length());
+            assertEquals(identifier, std::move(expected).build(status).getIdentifier(),
+                         std::move(cached).build(status).getIdentifier());
+        }
+    }
+    int32_t hits, misses;
+    MeasureUnitImpl::getIdentifierCacheCounts(hits, misses);
+    assertTrue("at least one lookup per identifier hit the cache",
+               hits - hitsBefore >= UPRV_LENGTHOF(identifiers));
+    assertEquals("all lookups were counted", 2 * UPRV_LENGTHOF(identifiers),
+                 (hits - hitsBefore) + (misses - missesBefore));
+
+    // Invalid identifiers fail, cached or not.
+    for (int32_t pass = 0; pass < 2; pass++) {
+        MeasureUnitImpl::forIdentifierCached("meter-per-", status);
+        status.expectErrorAndReset(U_ILLEGAL_ARGUMENT_ERROR);
+    }
+}
+
+void MeasureFormatTest::TestUnitEqualityAndHash() {
+    IcuTestErrorCode status(*this, "TestUnitEqualityAndHash");
+    MeasureUnit newton1 = MeasureUnit::forIdentifier("kilogram-meter-per-square-second", status);
+    MeasureUnit newton2 = MeasureUnit::forIdentifier("meter-kilogram-per-second-second", status);
+    MeasureUnit newton3 = MeasureUnit::getKilogram()
+        .product(MeasureUnit::getMeter(), status)
+        .product(MeasureUnit::getSecond().withDimensionality(-2, status), status);
+    MeasureUnit footInch = MeasureUnit::forIdentifier("foot-and-inch", status);
+    MeasureUnit meter = MeasureUnit::forIdentifier("meter", status);
+    status.assertSuccess();
+
+    // Each MeasureUnit owns its MeasureUnitImpl, which outlives neither the
+    // MeasureUnit nor its copies.
+    const MeasureUnitImpl *impl = MeasureUnitImpl::get(newton1);
+    assertTrue("compound unit has an impl", impl != nullptr);
+    MeasureUnit copy(newton1);
+    assertTrue("copies own their impl", MeasureUnitImpl::get(copy) != impl);
+    MeasureUnit moved(std::move(copy));
+    assertTrue("built-in unit has no impl", MeasureUnitImpl::get(meter) == nullptr);
+
+    assertTrue("newton1 == newton2", newton1 == newton2);
+    assertTrue("newton1 == newton3", newton1 == newton3);
+    assertTrue("newton1 == moved", newton1 == moved);
+    assertTrue("meter == getMeter()", meter == MeasureUnit::getMeter());
+    assertTrue("newton1 != footInch", newton1 != footInch);
+    assertTrue("newton1 != meter", newton1 != meter);
+    assertTrue("meter != newton1", meter != newton1);
+    assertTrue("meter != foot", meter != MeasureUnit::getFoot());
+
+    assertEquals("hash newton1 newton2", newton1.hashCode(), newton2.hashCode());
+    assertEquals("hash newton1 newton3", newton1.hashCode(), newton3.hashCode());
+    assertEquals("hash newton1 moved", newton1.hashCode(), moved.hashCode());
+    assertEquals("hash meter", MeasureUnit::getMeter().hashCode(), meter.hashCode());
+
+    // Assignment keeps the hash code along with the identifier.
+    MeasureUnit assigned;
+    assigned = footInch;
+    assertTrue("assigned == footInch", assigned == footInch);
+    assertEquals("hash assigned", footInch.hashCode(), assigned.hashCode());
+    assigned = meter;
+    assertTrue("reassigned == meter", assigned == meter);
+    assertEquals("hash reassigned", meter.hashCode(), assigned.hashCode());
+
+    // Currencies that ICU does not know have an impl too.
+    CurrencyUnit xyz1(u"XYZ", status);
+    CurrencyUnit xyz2(u"XYZ", status);
+    CurrencyUnit xya(u"XYA", status);
+    status.assertSuccess();
+    assertTrue("XYZ == XYZ", xyz1 == xyz2);
+    assertTrue("XYZ != XYA", xyz1 != xya);
+    assertEquals("hash XYZ", xyz1.hashCode(), xyz2.hashCode());
+    assertEquals("XYZ identifier", "XYZ", xyz1.getIdentifier());
+
+    // Units built in different ways from many prefixes and powers agree with
+    // the units parsed from their identifiers.
+    const UMeasurePrefix prefixes[] = {
+        UMEASURE_PREFIX_YOTTA, UMEASURE_PREFIX_ZETTA, UMEASURE_PREFIX_EXA,   UMEASURE_PREFIX_PETA,
+        UMEASURE_PREFIX_TERA,  UMEASURE_PREFIX_GIGA,  UMEASURE_PREFIX_MEGA,  UMEASURE_PREFIX_KILO,
+        UMEASURE_PREFIX_HECTO, UMEASURE_PREFIX_DEKA,  UMEASURE_PREFIX_DECI,  UMEASURE_PREFIX_CENTI,
+        UMEASURE_PREFIX_MILLI, UMEASURE_PREFIX_MICRO, UMEASURE_PREFIX_NANO,  UMEASURE_PREFIX_PICO,
+        UMEASURE_PREFIX_FEMTO, UMEASURE_PREFIX_ATTO,  UMEASURE_PREFIX_ZEPTO, UMEASURE_PREFIX_YOCTO,
+    };
+    const int32_t kCount = 8 * UPRV_LENGTHOF(prefixes);
+    for (int32_t i = 0; i < kCount; i++) {
+        MeasureUnit built = MeasureUnit::getSecond()
+            .withPrefix(prefixes[i % UPRV_LENGTHOF(prefixes)], status)
+            .withDimensionality(2 + i / UPRV_LENGTHOF(prefixes), status)
+            .product(MeasureUnit::getMeter(), status);
+        MeasureUnit parsed = MeasureUnit::forIdentifier(built.getIdentifier(), status);
+        if (status.errIfFailureAndReset("unit %d", i)) {
+            return;
+        }
+        assertTrue(UnicodeString("built == parsed: ") + built.getIdentifier(), built == parsed);
+        assertEquals(UnicodeString("hash: ") + built.getIdentifier(), built.hashCode(),
+                     parsed.hashCode());
+        assertTrue(UnicodeString("!= newton: ") + built.getIdentifier(), built != newton1);
+    }
+}
 
 void MeasureFormatTest::verifyFieldPosition(
         const char *description,
@@ -64,6 +64,8 @@ class NumberFormatterApiTest : public IntlTestWithFieldPosition {
     void unitUsage();
     void unitUsageErrorCodes();
     void unitUsageSkeletons();
+    void unitLongNameDataCache();
+    void unitUsageLazyLongNames();
     void unitCurrency();
     void unitInflections();
     void unitGender();
@@ -87,15 +89,20 @@ class NumberFormatterApiTest : public IntlTestWithFieldPosition {
     void locale();
     void skeletonUserGuideExamples();
     void formatTypes();
+    void formatDoubleArray();
+    void formatDoubleArrayToUTF8();
+    void formatIntegerDigits();
     void fieldPositionLogic();
     void fieldPositionCoverage();
     void toFormat();
     void errors();
     void validRanges();
     void copyMove();
+    void sharedCompiled();
     void localPointerCAPI();
     void toObject();
     void toDecimalNumber();
+    void appendToUTF8();
     void microPropsInternals();
 
     void runIndexedTest(int32_t index, UBool exec, const char *&name, char *par = 0);
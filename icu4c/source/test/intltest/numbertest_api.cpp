@@ -18,7 +18,9 @@
 #include "number_utils.h"
 #include "number_utypes.h"
 #include "number_microprops.h"
+#include "number_longnames.h"
 #include "numbertest.h"
+#include "unifiedcache.h"
 
 using number::impl::UFormattedNumberData;
 
@@ -85,6 +87,8 @@ void NumberFormatterApiTest::runIndexedTest(int32_t index, UBool exec, const cha
         TESTCASE_AUTO(unitUsage);
         TESTCASE_AUTO(unitUsageErrorCodes);
         TESTCASE_AUTO(unitUsageSkeletons);
+        TESTCASE_AUTO(unitLongNameDataCache);
+        TESTCASE_AUTO(unitUsageLazyLongNames);
         TESTCASE_AUTO(unitCurrency);
         TESTCASE_AUTO(unitInflections);
         TESTCASE_AUTO(unitGender);
@@ -111,6 +115,9 @@ void NumberFormatterApiTest::runIndexedTest(int32_t index, UBool exec, const cha
         TESTCASE_AUTO(locale);
         TESTCASE_AUTO(skeletonUserGuideExamples);
         TESTCASE_AUTO(formatTypes);
+        TESTCASE_AUTO(formatDoubleArray);
+        TESTCASE_AUTO(formatDoubleArrayToUTF8);
+        TESTCASE_AUTO(formatIntegerDigits);
         TESTCASE_AUTO(fieldPositionLogic);
         TESTCASE_AUTO(fieldPositionCoverage);
         TESTCASE_AUTO(toFormat);
@@ -121,9 +128,11 @@ void NumberFormatterApiTest::runIndexedTest(int32_t index, UBool exec, const cha
             TESTCASE_AUTO(validRanges);
         }
         TESTCASE_AUTO(copyMove);
+        TESTCASE_AUTO(sharedCompiled);
         TESTCASE_AUTO(localPointerCAPI);
         TESTCASE_AUTO(toObject);
         TESTCASE_AUTO(toDecimalNumber);
+        TESTCASE_AUTO(appendToUTF8);
         TESTCASE_AUTO(microPropsInternals);
     TESTCASE_AUTO_END;
 }
@@ -1766,6 +1775,76 @@ void NumberFormatterApiTest::unitUsage() {
     // divide-by-zero behaviour.
 }
 
+void NumberFormatterApiTest::unitLongNameDataCache() {
+    IcuTestErrorCode status(*this, "unitLongNameDataCache()");
+    // Evict unused entries, so that the entries added below are not evicted
+    // before they are looked up again.
+    const UnifiedCache *cache = UnifiedCache::getInstance(status);
+    if (status.errIfFailureAndReset("UnifiedCache::getInstance")) {
+        return;
+    }
+    cache->flush();
+
+    int32_t hits0, misses0, bytes0;
+    LongNameHandler::getMeasureDataCacheStats(hits0, misses0, bytes0);
+
+    // The road preferences for en-GB include the mixed unit yard-and-foot, so
+    // the data for several units is loaded.
+    LocalizedNumberFormatter formatter = NumberFormatter::with()
+                                             .unit(MeasureUnit::getMeter())
+                                             .usage("road")
+                                             .unitWidth(UNUM_UNIT_WIDTH_FULL_NAME)
+                                             .locale("en-GB");
+    UnicodeString first = formatter.formatDouble(1000, status).toString(status);
+    int32_t hits1, misses1, bytes1;
+    LongNameHandler::getMeasureDataCacheStats(hits1, misses1, bytes1);
+    assertTrue("First formatter loads data", misses1 > misses0);
+    assertTrue("Loaded data is accounted for", bytes1 > bytes0);
+
+    // A second, equivalent formatter finds all of its data in the cache.
+    LocalizedNumberFormatter formatter2 = NumberFormatter::with()
+                                              .unit(MeasureUnit::getMeter())
+                                              .usage("road")
+                                              .unitWidth(UNUM_UNIT_WIDTH_FULL_NAME)
+                                              .locale("en-GB");
+    UnicodeString second = formatter2.formatDouble(1000, status).toString(status);
+    int32_t hits2, misses2, bytes2;
+    LongNameHandler::getMeasureDataCacheStats(hits2, misses2, bytes2);
+    assertEquals("Second formatter loads nothing", misses1, misses2);
+    assertTrue("Second formatter finds the data in the cache", hits2 > hits1);
+    assertEquals("Same output", first, second);
+    status.errIfFailureAndReset("formatDouble");
+}
+
+void NumberFormatterApiTest::unitUsageLazyLongNames() {
+    IcuTestErrorCode status(*this, "unitUsageLazyLongNames()");
+    const UnifiedCache *cache = UnifiedCache::getInstance(status);
+    if (status.errIfFailureAndReset("UnifiedCache::getInstance")) {
+        return;
+    }
+    cache->flush();
+
+    // The long names of each output unit are only loaded once a value is
+    // routed to it.
+    LocalizedNumberFormatter formatter = NumberFormatter::with()
+                                             .unit(MeasureUnit::getMeter())
+                                             .usage("road")
+                                             .unitWidth(UNUM_UNIT_WIDTH_FULL_NAME)
+                                             .locale("en-US");
+    int32_t hits0, misses0, bytes0;
+    LongNameHandler::getMeasureDataCacheStats(hits0, misses0, bytes0);
+    assertEquals("Miles", u"6.2 miles", formatter.formatDouble(10000, status).toString(status));
+    int32_t hits1, misses1, bytes1;
+    LongNameHandler::getMeasureDataCacheStats(hits1, misses1, bytes1);
+    assertTrue("Routing to miles loads data", misses1 > misses0);
+
+    assertEquals("Feet", u"350 feet", formatter.formatDouble(100, status).toString(status));
+    int32_t hits2, misses2, bytes2;
+    LongNameHandler::getMeasureDataCacheStats(hits2, misses2, bytes2);
+    assertTrue("Routing to feet loads data not loaded for miles", misses2 > misses1);
+    status.errIfFailureAndReset("formatDouble");
+}
+
 void NumberFormatterApiTest::unitUsageErrorCodes() {
     IcuTestErrorCode status(*this, "unitUsageErrorCodes()");
     UnlocalizedNumberFormatter unloc_formatter;
@@ -4608,6 +4687,192 @@ void NumberFormatterApiTest::formatTypes() {
     actual = formatter.precision(Precision::unlimited()).formatDecimal(str, status).toString(status);
     assertEquals("Format decNumber to 40 digits", str, actual);
 }
+void NumberFormatterApiTest::formatDoubleArray() {
+    IcuTestErrorCode status(*this, "formatDoubleArray");
+    LocalizedNumberFormatter formatter = NumberFormatter::withLocale(Locale::getEnglish())
+        .unit(MeasureUnit::getMeter())
+        .unitWidth(UNUM_UNIT_WIDTH_SHORT);
+
+    static const double values[] = {514.23, -0.5, 0.0, 51423.0, 1e20, uprv_getInfinity()};
+    static const char16_t* expected[] = {
+        u"514.23 m", u"-0.5 m", u"0 m", u"51,423 m", u"100,000,000,000,000,000,000 m", u"∞ m"};
+    int32_t count = UPRV_LENGTHOF(values);
+    int32_t offsets[UPRV_LENGTHOF(values) + 1];
+
+    // Preflight.
+    int32_t length = formatter.formatDoubleArray(values, count, nullptr, 0, offsets, status);
+    status.expectErrorAndReset(U_BUFFER_OVERFLOW_ERROR);
+    char16_t buffer[100];
+    assertTrue("Total length fits the test buffer", length < UPRV_LENGTHOF(buffer));
+    assertEquals("Preflight offsets[count]", length, offsets[count]);
+
+    // Too small: nothing past the capacity is written.
+    buffer[5] = u'x';
+    assertEquals("Too small length",
+        length, formatter.formatDoubleArray(values, count, buffer, 5, offsets, status));
+    status.expectErrorAndReset(U_BUFFER_OVERFLOW_ERROR);
+    assertEquals("Too small buffer untouched", u'x', buffer[5]);
+
+    // Formatting every value must match formatDouble() on the temporary compiled,
+    // the static, and the compiled path.
+    for (int32_t threshold : {3, 0, 1}) {
+        LocalizedNumberFormatter f = formatter.threshold(threshold);
+        assertEquals("Length", length, f.formatDoubleArray(values, count, buffer, 100, offsets, status));
+        status.errIfFailureAndReset();
+        assertEquals("NUL-terminated", u'\0', buffer[length]);
+        assertEquals("offsets[0]", 0, offsets[0]);
+        for (int32_t i = 0; i < count; i++) {
+            UnicodeString actual(buffer + offsets[i], offsets[i + 1] - offsets[i]);
+            assertEquals(UnicodeString(u"Value ") + Int64ToUnicodeString(i), expected[i], actual);
+            assertEquals(UnicodeString(u"formatDouble ") + Int64ToUnicodeString(i),
+                f.formatDouble(values[i], status).toString(status), actual);
+        }
+    }
+
+    // Empty batch.
+    assertEquals("Empty", 0, formatter.formatDoubleArray(nullptr, 0, buffer, 100, offsets, status));
+    status.errIfFailureAndReset();
+    assertEquals("Empty offsets[0]", 0, offsets[0]);
+    assertEquals("Empty NUL", u'\0', buffer[0]);
+
+    // Bad arguments.
+    formatter.formatDoubleArray(values, -1, buffer, 100, offsets, status);
+    status.expectErrorAndReset(U_ILLEGAL_ARGUMENT_ERROR);
+    formatter.formatDoubleArray(values, count, buffer, 100, nullptr, status);
+    status.expectErrorAndReset(U_ILLEGAL_ARGUMENT_ERROR);
+    formatter.formatDoubleArray(values, count, nullptr, 100, offsets, status);
+    status.expectErrorAndReset(U_ILLEGAL_ARGUMENT_ERROR);
+}
+
+void NumberFormatterApiTest::formatDoubleArrayToUTF8() {
+    IcuTestErrorCode status(*this, "formatDoubleArrayToUTF8");
+    // fr uses U+202F as the grouping separator and between the number and the unit.
+    LocalizedNumberFormatter formatter = NumberFormatter::withLocale("fr")
+        .unit(MeasureUnit::getMeter())
+        .unitWidth(UNUM_UNIT_WIDTH_SHORT);
+
+    static const double values[] = {514.23, -0.5, 0.0, 51423.0, uprv_getInfinity()};
+    static const char* expected[] = {
+        u8"514,23\u202Fm", u8"-0,5\u202Fm", u8"0\u202Fm", u8"51\u202F423\u202Fm",
+        u8"\u221E\u202Fm"};
+    int32_t count = UPRV_LENGTHOF(values);
+    int32_t offsets[UPRV_LENGTHOF(values) + 1];
+
+    // Preflight.
+    int32_t length = formatter.formatDoubleArrayToUTF8(values, count, nullptr, 0, offsets, status);
+    status.expectErrorAndReset(U_BUFFER_OVERFLOW_ERROR);
+    char buffer[100];
+    assertTrue("Total length fits the test buffer", length < UPRV_LENGTHOF(buffer));
+    assertEquals("Preflight offsets[count]", length, offsets[count]);
+
+    // Too small: nothing past the capacity is written.
+    buffer[5] = 'x';
+    assertEquals("Too small length",
+        length, formatter.formatDoubleArrayToUTF8(values, count, buffer, 5, offsets, status));
+    status.expectErrorAndReset(U_BUFFER_OVERFLOW_ERROR);
+    assertEquals("Too small buffer untouched", 'x', buffer[5]);
+
+    // Formatting every value must match formatDouble() on the temporary compiled,
+    // the static, and the compiled path.
+    for (int32_t threshold : {3, 0, 1}) {
+        LocalizedNumberFormatter f = formatter.threshold(threshold);
+        assertEquals("Length", length,
+            f.formatDoubleArrayToUTF8(values, count, buffer, 100, offsets, status));
+        status.errIfFailureAndReset();
+        assertEquals("NUL-terminated", '\0', buffer[length]);
+        assertEquals("offsets[0]", 0, offsets[0]);
+        for (int32_t i = 0; i < count; i++) {
+            std::string actual(buffer + offsets[i], offsets[i + 1] - offsets[i]);
+            assertEquals(UnicodeString(u"Value ") + Int64ToUnicodeString(i),
+                expected[i], actual.c_str());
+            std::string fromFormatDouble;
+            f.formatDouble(values[i], status).toString(status).toUTF8String(fromFormatDouble);
+            assertEquals(UnicodeString(u"formatDouble ") + Int64ToUnicodeString(i),
+                fromFormatDouble.c_str(), actual.c_str());
+        }
+    }
+
+    // Empty batch.
+    assertEquals("Empty", 0,
+        formatter.formatDoubleArrayToUTF8(nullptr, 0, buffer, 100, offsets, status));
+    status.errIfFailureAndReset();
+    assertEquals("Empty offsets[0]", 0, offsets[0]);
+    assertEquals("Empty NUL", '\0', buffer[0]);
+
+    // Bad arguments.
+    formatter.formatDoubleArrayToUTF8(values, -1, buffer, 100, offsets, status);
+    status.expectErrorAndReset(U_ILLEGAL_ARGUMENT_ERROR);
+    formatter.formatDoubleArrayToUTF8(values, count, buffer, 100, nullptr, status);
+    status.expectErrorAndReset(U_ILLEGAL_ARGUMENT_ERROR);
+    formatter.formatDoubleArrayToUTF8(values, count, nullptr, 100, offsets, status);
+    status.expectErrorAndReset(U_ILLEGAL_ARGUMENT_ERROR);
+}
+
+void NumberFormatterApiTest::formatIntegerDigits() {
+    IcuTestErrorCode status(*this, "formatIntegerDigits");
+
+    // Integer digits in single code units are written two at a time, with the grouping separators.
+    static const struct TestCase {
+        const char* locale;
+        int64_t input;
+        const char16_t* expected;
+    } cases[] = {
+        {"en", 0, u"0"},
+        {"en", 7, u"7"},
+        {"en", 10, u"10"},
+        {"en", -1234567, u"-1,234,567"},
+        {"en", 100000000, u"100,000,000"},
+        {"en", 123456789012345678LL, u"123,456,789,012,345,678"},
+        // More than 18 digits
+        {"en", INT64_MAX, u"9,223,372,036,854,775,807"},
+        {"en", INT64_MIN, u"-9,223,372,036,854,775,808"},
+        {"en-IN", 1234567890, u"1,23,45,67,890"},
+        // Minimum grouping digits
+        {"es", 1234, u"1234"},
+        {"es", 12345, u"12.345"},
+        {"ar-EG", 1234567, u"١٬٢٣٤٬٥٦٧"},
+        // Digits outside of the BMP
+        {"en-u-nu-mathsanb", 1234, u"\U0001D7ED,\U0001D7EE\U0001D7EF\U0001D7F0"},
+    };
+    for (const auto& cas : cases) {
+        UnicodeString message = UnicodeString(cas.locale, -1, US_INV) + u" " + Int64ToUnicodeString(cas.input);
+        assertEquals(message, cas.expected,
+            NumberFormatter::withLocale(cas.locale).formatInt(cas.input, status).toString(status));
+        status.errDataIfFailureAndReset("%s %lld", cas.locale, static_cast<long long>(cas.input));
+    }
+
+    LocalizedNumberFormatter padded = NumberFormatter::withLocale("en")
+        .integerWidth(IntegerWidth::zeroFillTo(5).truncateAt(7));
+    assertEquals("Zero fill", u"00,012", padded.formatInt(12, status).toString(status));
+    assertEquals("Truncate", u"2,345,678", padded.formatInt(912345678, status).toString(status));
+    assertEquals("Fraction", u"00,012.5", padded.formatDouble(12.5, status).toString(status));
+
+    // Long grouping separators; from five code units, the digits are written one by one.
+    DecimalFormatSymbols symbols("en", status);
+    symbols.setSymbol(DecimalFormatSymbols::kGroupingSeparatorSymbol, u"<->", FALSE);
+    LocalizedNumberFormatter custom = NumberFormatter::withLocale("en").symbols(symbols);
+    assertEquals("Custom separator", u"1<->234<->567", custom.formatInt(1234567, status).toString(status));
+    symbols.setSymbol(DecimalFormatSymbols::kGroupingSeparatorSymbol, u"<--->", FALSE);
+    custom = NumberFormatter::withLocale("en").symbols(symbols);
+    assertEquals("Long separator", u"1<--->234<--->567", custom.formatInt(1234567, status).toString(status));
+    symbols.setSymbol(DecimalFormatSymbols::kMonetaryGroupingSeparatorSymbol, u"'", FALSE);
+    custom = NumberFormatter::withLocale("en").symbols(symbols).unit(CurrencyUnit(u"USD", status));
+    assertEquals("Monetary separator", u"$1'234'567.00", custom.formatInt(1234567, status).toString(status));
+
+    FormattedNumber result = NumberFormatter::withLocale("en").formatInt(-1234567, status);
+    static const UFieldPosition expectedFieldPositions[] = {
+        // field, begin index, end index
+        {UNUM_SIGN_FIELD, 0, 1},
+        {UNUM_GROUPING_SEPARATOR_FIELD, 2, 3},
+        {UNUM_GROUPING_SEPARATOR_FIELD, 6, 7},
+        {UNUM_INTEGER_FIELD, 1, 10}};
+    assertNumberFieldPositions(
+        u"Field positions",
+        result,
+        expectedFieldPositions,
+        UPRV_LENGTHOF(expectedFieldPositions));
+}
+
 
 void NumberFormatterApiTest::fieldPositionLogic() {
     IcuTestErrorCode status(*this, "fieldPositionLogic");
@@ -5247,6 +5512,64 @@ void NumberFormatterApiTest::copyMove() {
     assertEquals("FormattedNumber move assignment", u"20%", result.toString(status));
 }
 
+void NumberFormatterApiTest::sharedCompiled() {
+    IcuTestErrorCode status(*this, "sharedCompiled");
+
+    // Formatters from a skeleton compile on the first call.
+    LocalizedNumberFormatter l1 =
+        NumberFormatter::forSkeleton(u"scientific/sign-always precision-integer", status).locale("en");
+    assertEquals("First call", u"1E+3", l1.formatInt(1234, status).toString(status));
+    if (status.errDataIfFailureAndReset()) { return; }
+    assertTrue("First call compiles", l1.getCompiled() != nullptr);
+
+    // Formatters with the same settings and locale share the compiled formatter.
+    LocalPointer<LocalizedNumberFormatter> l2 = NumberFormatter::with()
+        .notation(Notation::scientific().withExponentSignDisplay(UNUM_SIGN_ALWAYS))
+        .precision(Precision::integer())
+        .locale("en")
+        .threshold(1)
+        .clone();
+    assertEquals("Equivalent settings", u"1E+3", l2->formatInt(1234, status).toString(status));
+    assertTrue("Equivalent settings share", l1.getCompiled() == l2->getCompiled());
+
+    // Different settings or locales do not share.
+    LocalizedNumberFormatter l3 =
+        NumberFormatter::forSkeleton(u"scientific/sign-always precision-integer", status).locale("de");
+    assertEquals("Other locale", u"1E+3", l3.formatInt(1234, status).toString(status));
+    assertTrue("Other locale does not share", l1.getCompiled() != l3.getCompiled());
+    LocalizedNumberFormatter l4 =
+        NumberFormatter::forSkeleton(u"scientific precision-integer", status).locale("en");
+    assertEquals("Other settings", u"1E3", l4.formatInt(1234, status).toString(status));
+    assertTrue("Other settings do not share", l1.getCompiled() != l4.getCompiled());
+    LocalizedNumberFormatter l5 =
+        NumberFormatter::forSkeleton(u"precision-increment/5", status).locale("en");
+    LocalizedNumberFormatter l6 =
+        NumberFormatter::forSkeleton(u"precision-increment/0.5", status).locale("en");
+    assertEquals("Increment 5", u"1,235", l5.formatInt(1234, status).toString(status));
+    assertEquals("Increment 0.5", u"1,234.0", l6.formatDouble(1234.2, status).toString(status));
+    assertTrue("Other increments do not share", l5.getCompiled() != l6.getCompiled());
+
+    // The shared formatter outlives the formatter that compiled it.
+    l2.adoptInstead(nullptr);
+    l1 = NumberFormatter::withLocale("en");
+    LocalizedNumberFormatter l7 =
+        NumberFormatter::forSkeleton(u"precision-integer scientific/sign-always", status).locale("en");
+    assertEquals("After release", u"-5E+0", l7.formatInt(-5, status).toString(status));
+    assertEquals("After release", u"1E+3", l7.formatInt(1234, status).toString(status));
+
+    // Custom symbols are not shared.
+    DecimalFormatSymbols symbols("en", status);
+    symbols.setSymbol(DecimalFormatSymbols::kExponentialSymbol, u"x10^", status);
+    LocalizedNumberFormatter l8 = NumberFormatter::with()
+        .notation(Notation::scientific().withExponentSignDisplay(UNUM_SIGN_ALWAYS))
+        .precision(Precision::integer())
+        .symbols(symbols)
+        .locale("en")
+        .threshold(1);
+    assertEquals("Custom symbols", u"1x10^+3", l8.formatInt(1234, status).toString(status));
+    assertTrue("Custom symbols do not share", l7.getCompiled() != l8.getCompiled());
+}
+
 void NumberFormatterApiTest::localPointerCAPI() {
     // NOTE: This is also the sample code in unumberformatter.h
     UErrorCode ec = U_ZERO_ERROR;
@@ -5338,6 +5661,48 @@ void NumberFormatterApiTest::toDecimalNumber() {
     assertEquals(u"Should have expected toDecimalNumber string result",
         "9.8765E+14", fn.toDecimalNumber<std::string>(status).c_str());
 }
+void NumberFormatterApiTest::appendToUTF8() {
+    IcuTestErrorCode status(*this, "appendToUTF8");
+    static const struct TestCase {
+        const char16_t* skeleton;
+        const char* locale;
+        double value;
+    } cases[] = {
+        {u"", "en", -514.23},
+        {u"currency/EUR", "de", 51423.5},
+        {u"percent", "ar", 0.25},
+        {u"unit/celsius unit-width-full-name", "ja", 21.5},
+        // Digits outside the BMP, and more UTF-16 units than one transcoding chunk,
+        // so that chunk boundaries fall between surrogate pairs.
+        {u"numbering-system/mathsanb", "en", 1e300},
+        {u"numbering-system/mathsanb", "en", 1e299},
+    };
+    for (const auto& cas : cases) {
+        LocalizedNumberFormatter formatter =
+            NumberFormatter::forSkeleton(cas.skeleton, status).locale(cas.locale);
+        FormattedNumber result = formatter.formatDouble(cas.value, status);
+        std::string expected;
+        result.toString(status).toUTF8String(expected);
+        std::string actual;
+        StringByteSink<std::string> sink(&actual);
+        result.appendToUTF8(sink, status);
+        assertEquals(UnicodeString(cas.skeleton) + u" " + cas.locale, expected.c_str(), actual.c_str());
+        status.errIfFailureAndReset();
+    }
+
+    // Appends rather than replaces.
+    std::string actual = "x=";
+    StringByteSink<std::string> sink(&actual);
+    NumberFormatter::withLocale("en").formatDouble(1.5, status).appendToUTF8(sink, status);
+    assertEquals("Append", "x=1.5", actual.c_str());
+
+    // Errors are passed through.
+    FormattedNumber empty;
+    empty.appendToUTF8(sink, status);
+    status.expectErrorAndReset(U_INVALID_STATE_ERROR);
+    assertEquals("Nothing appended on error", "x=1.5", actual.c_str());
+}
+
 
 void NumberFormatterApiTest::microPropsInternals() {
     // Verify copy construction and assignment operators.
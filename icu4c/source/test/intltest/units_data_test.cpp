@@ -5,8 +5,13 @@
 
 #if !UCONFIG_NO_FORMATTING
 
+#include "charstr.h"
+#include "cstring.h"
 #include "measunit_impl.h"
+#include "unicode/bytestrie.h"
+#include "units_converter.h"
 #include "units_data.h"
+#include "units_prebuilt.h"
 
 #include "intltest.h"
 
@@ -20,8 +25,12 @@ class UnitsDataTest : public IntlTest {
     void runIndexedTest(int32_t index, UBool exec, const char *&name, char *par = NULL);
 
     void testGetUnitCategory();
+    void testUnitCategories();
     void testGetAllConversionRates();
+    void testExtractConversionInfo();
     void testGetPreferencesFor();
+    void testGetInstance();
+    void testPrebuiltUnitsData();
 };
 
 extern IntlTest *createUnitsDataTest() { return new UnitsDataTest(); }
@@ -30,8 +39,12 @@ void UnitsDataTest::runIndexedTest(int32_t index, UBool exec, const char *&name,
     if (exec) { logln("TestSuite UnitsDataTest: "); }
     TESTCASE_AUTO_BEGIN;
     TESTCASE_AUTO(testGetUnitCategory);
+    TESTCASE_AUTO(testUnitCategories);
     TESTCASE_AUTO(testGetAllConversionRates);
+    TESTCASE_AUTO(testExtractConversionInfo);
     TESTCASE_AUTO(testGetPreferencesFor);
+    TESTCASE_AUTO(testGetInstance);
+    TESTCASE_AUTO(testPrebuiltUnitsData);
     TESTCASE_AUTO_END;
 }
 
@@ -60,6 +73,67 @@ void UnitsDataTest::testGetUnitCategory() {
     }
 }
 
+void UnitsDataTest::testUnitCategories() {
+    IcuTestErrorCode status(*this, "testUnitCategories");
+    const ConversionRates *rates = ConversionRates::getInstance(status);
+    const UnitCategories *categories = UnitCategories::getInstance(status);
+    if (status.errIfFailureAndReset("getInstance()")) {
+        return;
+    }
+
+    // UnitCategories must agree with looking up the identifier of the compound
+    // base unit, for all simple units and for these compound units.
+    MaybeStackVector<CharString> identifiers;
+    const char *compoundUnits[] = {
+        "mile-per-hour", "liter-per-100-kilometer", "mile-per-gallon", "kilowatt-hour",
+        "gram-per-kilogram", "lumen", "lux", "square-meter-per-meter", "meter-per-meter",
+        "per-second", "kilogram-square-meter-per-square-second", "milligram-per-deciliter",
+    };
+    for (const char *unit : compoundUnits) {
+        identifiers.emplaceBackAndCheckErrorCode(status, unit, status);
+    }
+    MaybeStackVector<ConversionRateInfo> conversionInfo;
+    getAllConversionRates(conversionInfo, status);
+    for (int32_t i = 0; i < conversionInfo.length(); i++) {
+        identifiers.emplaceBackAndCheckErrorCode(status, conversionInfo[i]->sourceUnit.toStringPiece(),
+                                                 status);
+    }
+    if (status.errIfFailureAndReset("identifiers")) {
+        return;
+    }
+
+    for (int32_t i = 0; i < identifiers.length(); i++) {
+        const char *identifier = identifiers[i]->data();
+        MeasureUnitImpl unit = MeasureUnitImpl::forIdentifier(identifier, status);
+        if (status.errIfFailureAndReset("forIdentifier(%s)", identifier)) {
+            continue;
+        }
+        MeasureUnit baseUnit = extractCompoundBaseUnit(unit, *rates, status).build(status);
+        CharString expected = getUnitQuantity(baseUnit.getIdentifier(), status);
+        UErrorCode expectedStatus = status.reset();
+        StringPiece actual = categories->getCategory(unit, status);
+        UErrorCode actualStatus = status.reset();
+        assertEquals(UnicodeString("status for ") + identifier, u_errorName(expectedStatus),
+                     u_errorName(actualStatus));
+        if (U_SUCCESS(expectedStatus) && U_SUCCESS(actualStatus)) {
+            assertEquals(UnicodeString("category of ") + identifier, expected.data(),
+                         CharString(actual, status).data());
+        }
+    }
+
+    // Units and their reciprocals have the same dimensions, apart from
+    // swapping numerator and denominator.
+    UnitDimensions speed, pace;
+    categories->getDimensions(MeasureUnitImpl::forIdentifier("mile-per-hour", status), speed, status);
+    categories->getDimensions(MeasureUnitImpl::forIdentifier("second-per-meter", status), pace,
+                              status);
+    if (!status.errIfFailureAndReset("getDimensions()")) {
+        assertTrue("speed != pace", speed.compareTo(pace) != 0);
+        pace.takeReciprocal();
+        assertEquals("speed == reciprocal of pace", 0, speed.compareTo(pace));
+    }
+}
+
 void UnitsDataTest::testGetAllConversionRates() {
     IcuTestErrorCode status(*this, "testGetAllConversionRates");
     MaybeStackVector<ConversionRateInfo> conversionInfo;
@@ -76,6 +150,53 @@ void UnitsDataTest::testGetAllConversionRates() {
     }
 }
 
+void UnitsDataTest::testExtractConversionInfo() {
+    IcuTestErrorCode status(*this, "testExtractConversionInfo");
+    MaybeStackVector<ConversionRateInfo> conversionInfo;
+    getAllConversionRates(conversionInfo, status);
+    ConversionRates rates(status);
+    if (status.errIfFailureAndReset("ConversionRates(status)")) {
+        return;
+    }
+
+    // Every source unit must be found via the index.
+    for (int i = 0; i < conversionInfo.length(); i++) {
+        const ConversionRateInfo *expected = conversionInfo[i];
+        ConversionRateView actual =
+            rates.extractConversionInfo(expected->sourceUnit.toStringPiece(), status);
+        const Factor *factor = rates.extractFactor(expected->sourceUnit.toStringPiece(), status);
+        if (status.errIfFailureAndReset("extractConversionInfo(\"%s\")",
+                                        expected->sourceUnit.data())) {
+            continue;
+        }
+        assertEquals("sourceUnit", expected->sourceUnit.data(),
+                     CharString(actual.sourceUnit, status).data());
+        assertEquals("baseUnit", expected->baseUnit.data(),
+                     CharString(actual.baseUnit, status).data());
+        assertEquals("factor", expected->factor.data(), CharString(actual.factor, status).data());
+        assertEquals("offset", expected->offset.data(), CharString(actual.offset, status).data());
+        assertTrue("factor", factor != nullptr);
+    }
+
+    // Precomputed factors keep symbolic constants unsubstituted.
+    const Factor *footFactor = rates.extractFactor("foot", status);
+    if (!status.errIfFailureAndReset("extractFactor(\"foot\")")) {
+        assertEquals("foot: ft_to_m exponent", 1, footFactor->constantExponents[CONSTANT_FT2M]);
+        assertEquals("foot: numerator", 1.0, footFactor->factorNum);
+        assertEquals("foot: denominator", 1.0, footFactor->factorDen);
+    }
+    const Factor *celsiusFactor = rates.extractFactor("celsius", status);
+    if (!status.errIfFailureAndReset("extractFactor(\"celsius\")")) {
+        assertEquals("celsius: offset", 273.15, celsiusFactor->offset);
+    }
+
+    // Prefixed and unknown units are not in the index.
+    rates.extractConversionInfo("kilometer", status);
+    status.expectErrorAndReset(U_INTERNAL_PROGRAM_ERROR);
+    rates.extractFactor("foo", status);
+    status.expectErrorAndReset(U_INTERNAL_PROGRAM_ERROR);
+}
+
 class UnitPreferencesOpenedUp : public UnitPreferences {
   public:
     UnitPreferencesOpenedUp(UErrorCode &status) : UnitPreferences(status) {}
@@ -153,6 +274,153 @@ void UnitsDataTest::testGetPreferencesFor() {
         }
         status.errIfFailureAndReset("testCase '%s'", t.name);
     }
+
+    // Every set of preferences is found by its own category, usage and region.
+    // Unknown regions fall back to "001" of the same usage, and unknown
+    // sub-usages to the usage.
+    for (int32_t i = 0; i < metadata->length(); i++) {
+        const UnitPreferenceMetadata &m = *(*metadata)[i];
+        const UnitPreference *const *prefs;
+        int32_t prefsCount;
+        preferences.getPreferencesFor(m.category.data(), m.usage.data(), m.region.data(), prefs,
+                                      prefsCount, status);
+        if (status.errIfFailureAndReset("getPreferencesFor(\"%s\", \"%s\", \"%s\", ...",
+                                        m.category.data(), m.usage.data(), m.region.data())) {
+            continue;
+        }
+        assertTrue(UnicodeString("exact: ") + m.category.data() + "/" + m.usage.data() + "/" +
+                       m.region.data(),
+                   prefs == unitPrefs->getAlias() + m.prefsOffset && prefsCount == m.prefsCount);
+
+        if (uprv_strcmp(m.region.data(), "001") != 0) {
+            continue;
+        }
+        CharString subUsage(m.usage, status);
+        subUsage.append("-xyzzy", status);
+        const char *regions[] = {"XX", "", "U", "USA"};
+        for (const char *region : regions) {
+            preferences.getPreferencesFor(m.category.data(), subUsage.data(), region, prefs,
+                                          prefsCount, status);
+            if (status.errIfFailureAndReset("getPreferencesFor(\"%s\", \"%s\", \"%s\", ...",
+                                            m.category.data(), subUsage.data(), region)) {
+                continue;
+            }
+            assertTrue(UnicodeString("fallback: ") + m.category.data() + "/" + subUsage.data() +
+                           "/" + region,
+                       prefs == unitPrefs->getAlias() + m.prefsOffset);
+        }
+    }
+
+    const UnitPreference *const *prefs;
+    int32_t prefsCount;
+    preferences.getPreferencesFor("no-such-category", "default", "001", prefs, prefsCount, status);
+    status.expectErrorAndReset(U_ILLEGAL_ARGUMENT_ERROR);
+    assertEquals("unknown category: count", 0, prefsCount);
+    preferences.getPreferencesFor("", "default", "001", prefs, prefsCount, status);
+    status.expectErrorAndReset(U_ILLEGAL_ARGUMENT_ERROR);
+}
+
+void UnitsDataTest::testGetInstance() {
+    IcuTestErrorCode status(*this, "testGetInstance");
+    const ConversionRates *rates = ConversionRates::getInstance(status);
+    const UnitPreferences *prefs = UnitPreferences::getInstance(status);
+    if (status.errIfFailureAndReset("getInstance()")) {
+        return;
+    }
+    assertTrue("ConversionRates::getInstance() not null", rates != nullptr);
+    assertTrue("UnitPreferences::getInstance() not null", prefs != nullptr);
+    assertTrue("ConversionRates::getInstance() is shared",
+               rates == ConversionRates::getInstance(status));
+    assertTrue("UnitPreferences::getInstance() is shared",
+               prefs == UnitPreferences::getInstance(status));
+
+    ConversionRateView info = rates->extractConversionInfo("foot", status);
+    if (!status.errIfFailureAndReset("extractConversionInfo(\"foot\")")) {
+        assertEquals("foot base unit", "meter", CharString(info.baseUnit, status).data());
+    }
+
+    const UnitPreference *const *unitPrefs;
+    int32_t prefsCount;
+    prefs->getPreferencesFor("length", "road", "US", unitPrefs, prefsCount, status);
+    if (!status.errIfFailureAndReset("getPreferencesFor(\"length\", \"road\", \"US\", ...)")) {
+        assertTrue("US road preferences", prefsCount > 0);
+    }
+}
+
+void UnitsDataTest::testPrebuiltUnitsData() {
+    IcuTestErrorCode status(*this, "testPrebuiltUnitsData");
+
+    // Read back the data that genunits writes to units.icu.
+    CharString bytes;
+    buildPrebuiltUnitsData(bytes, status);
+    if (status.errIfFailureAndReset("buildPrebuiltUnitsData()")) { return; }
+    // Copy the data into memory that is aligned for its int32_t and double
+    // values, as udata_getMemory() is: a CharString buffer is not.
+    LocalMemory<int32_t> aligned;
+    if (aligned.allocateInsteadAndReset((bytes.length() + 3) / 4) == nullptr) {
+        errln("out of memory");
+        return;
+    }
+    uprv_memcpy(aligned.getAlias(), bytes.data(), bytes.length());
+    PrebuiltUnitsData data(nullptr, aligned.getAlias());
+    assertEquals("constants count", (int32_t)CONSTANTS_COUNT, data.getConstantsCount());
+
+    MaybeStackVector<ConversionRateInfo> rates;
+    getAllConversionRates(rates, status);
+    if (status.errIfFailureAndReset("getAllConversionRates()")) { return; }
+    assertEquals("conversion rates count", rates.length(), data.getConversionRatesCount());
+    BytesTrie trie(data.getConversionRatesTrie().data());
+    for (int32_t i = 0; i < rates.length(); i++) {
+        const ConversionRateInfo &info = *rates[i];
+        trie.reset();
+        UStringTrieResult result = trie.next(info.sourceUnit.data(), info.sourceUnit.length());
+        if (!assertTrue(info.sourceUnit.data(), USTRINGTRIE_HAS_VALUE(result))) { continue; }
+        int32_t idx = trie.getValue();
+        assertEquals("source unit", info.sourceUnit.data(),
+                     data.getRateString(idx, UNITS_RATE_SOURCE_UNIT));
+        assertEquals("base unit", info.baseUnit.data(), data.getRateString(idx, UNITS_RATE_BASE_UNIT));
+        assertEquals("factor", info.factor.data(), data.getRateString(idx, UNITS_RATE_FACTOR));
+        assertEquals("offset", info.offset.data(), data.getRateString(idx, UNITS_RATE_OFFSET));
+
+        Factor expected = loadFactor(info, status);
+        if (status.errIfFailureAndReset("loadFactor(%s)", info.sourceUnit.data())) { continue; }
+        const double *values = data.getFactorValues(idx);
+        assertEquals("factorNum", expected.factorNum, values[0]);
+        assertEquals("factorDen", expected.factorDen, values[1]);
+        assertEquals("offset", expected.offset, values[2]);
+        const int32_t *exponents = data.getFactorExponents(idx);
+        assertEquals("reciprocal", expected.reciprocal, exponents[0] != 0);
+        for (int32_t j = 0; j < CONSTANTS_COUNT; j++) {
+            assertEquals("constant exponent", expected.constantExponents[j], exponents[1 + j]);
+        }
+    }
+
+    // If ICU data includes units.icu, it must match the units resource.
+    const PrebuiltUnitsData *loaded = PrebuiltUnitsData::getInstance(status);
+    if (status.errIfFailureAndReset("PrebuiltUnitsData::getInstance()")) { return; }
+    if (loaded == nullptr) {
+        logln("units.icu is not available");
+        return;
+    }
+    assertEquals("loaded: conversion rates count", data.getConversionRatesCount(),
+                 loaded->getConversionRatesCount());
+    if (!assertEquals("loaded: simple units count", data.getSimpleUnitsCount(),
+                      loaded->getSimpleUnitsCount())) {
+        return;
+    }
+    for (int32_t i = 0; i < data.getSimpleUnitsCount(); i++) {
+        assertEquals("loaded: simple unit", data.getSimpleUnit(i), loaded->getSimpleUnit(i));
+        assertEquals("loaded: simple unit category", data.getSimpleUnitCategories()[i],
+                     loaded->getSimpleUnitCategories()[i]);
+    }
+    if (!assertEquals("loaded: categories count", data.getCategoriesCount(),
+                      loaded->getCategoriesCount())) {
+        return;
+    }
+    for (int32_t i = 0; i < data.getCategoriesCount(); i++) {
+        assertEquals("loaded: category", UnicodeString(data.getCategory(i)),
+                     UnicodeString(loaded->getCategory(i)));
+    }
 }
 
 #endif /* #if !UCONFIG_NO_FORMATTING */
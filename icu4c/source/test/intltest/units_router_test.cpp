@@ -5,10 +5,26 @@
 
 #if !UCONFIG_NO_FORMATTING
 
+#include <cmath>
+#include <float.h>
+
+#include "cmemory.h"
+#include "double-conversion-ieee.h"
 #include "intltest.h"
+#include "unicode/measunit.h"
 #include "unicode/unistr.h"
+#include "units_converter.h"
 #include "units_router.h"
 
+using icu::double_conversion::Double;
+using icu::units::ComplexUnitsConverter;
+using icu::units::ConversionRates;
+using icu::units::ConvertedMeasures;
+using icu::units::ConverterPreference;
+using icu::units::SharedUnitsRouter;
+using icu::units::UnitsConverter;
+using icu::units::UnitsRouter;
+
 
 class UnitsRouterTest : public IntlTest {
   public:
@@ -17,6 +33,8 @@ class UnitsRouterTest : public IntlTest {
     void runIndexedTest(int32_t index, UBool exec, const char *&name, char *par = NULL);
 
     void testBasic();
+    void testSharedUnitsRouter();
+    void testLimitsInInputUnit();
 };
 
 extern IntlTest *createUnitsRouterTest() { return new UnitsRouterTest(); }
@@ -25,9 +43,162 @@ void UnitsRouterTest::runIndexedTest(int32_t index, UBool exec, const char *&nam
     if (exec) { logln("TestSuite UnitsRouterTest: "); }
     TESTCASE_AUTO_BEGIN;
     TESTCASE_AUTO(testBasic);
+    TESTCASE_AUTO(testSharedUnitsRouter);
+    TESTCASE_AUTO(testLimitsInInputUnit);
     TESTCASE_AUTO_END;
 }
 
 void UnitsRouterTest::testBasic() { IcuTestErrorCode status(*this, "UnitsRouter testBasic"); }
 
+void UnitsRouterTest::testSharedUnitsRouter() {
+    IcuTestErrorCode status(*this, "UnitsRouter testSharedUnitsRouter");
+    MeasureUnit meter = MeasureUnit::forIdentifier("meter", status);
+    MeasureUnit kilometer = MeasureUnit::forIdentifier("kilometer", status);
+
+    const SharedUnitsRouter *road = SharedUnitsRouter::getInstance(meter, "US", "road", status);
+    const SharedUnitsRouter *road2 = SharedUnitsRouter::getInstance(meter, "US", "road", status);
+    const SharedUnitsRouter *roadGB = SharedUnitsRouter::getInstance(meter, "GB", "road", status);
+    const SharedUnitsRouter *person =
+        SharedUnitsRouter::getInstance(meter, "US", "person-height", status);
+    const SharedUnitsRouter *roadKm =
+        SharedUnitsRouter::getInstance(kilometer, "US", "road", status);
+    if (status.errIfFailureAndReset("SharedUnitsRouter::getInstance")) {
+        SharedObject::clearPtr(road);
+        SharedObject::clearPtr(road2);
+        SharedObject::clearPtr(roadGB);
+        SharedObject::clearPtr(person);
+        SharedObject::clearPtr(roadKm);
+        return;
+    }
+    assertTrue("Same key, same router", road == road2);
+    assertTrue("Different region, different router", road != roadGB);
+    assertTrue("Different usage, different router", road != person);
+    assertTrue("Different input unit, different router", road != roadKm);
+
+    // The shared router routes just like one built directly.
+    UnitsRouter router(meter, "US", "road", status);
+    status.assertSuccess();
+    const MaybeStackVector<MeasureUnit> *expectedUnits = router.getOutputUnits();
+    const MaybeStackVector<MeasureUnit> *actualUnits = road->get().getOutputUnits();
+    assertEquals("Output units count", expectedUnits->length(), actualUnits->length());
+    for (int32_t i = 0; i < expectedUnits->length() && i < actualUnits->length(); i++) {
+        assertEquals("Output unit", (*expectedUnits)[i]->getIdentifier(),
+                     (*actualUnits)[i]->getIdentifier());
+    }
+    static const double kQuantities[] = {0.5, 100.0, 1000.0, 100000.0};
+    for (double quantity : kQuantities) {
+        ConvertedMeasures expected, actual;
+        const MeasureUnit &expectedUnit = router.route(quantity, nullptr, expected, status);
+        const MeasureUnit &actualUnit = road->get().route(quantity, nullptr, actual, status);
+        status.assertSuccess();
+        assertEquals("Routed unit", expectedUnit.getIdentifier(), actualUnit.getIdentifier());
+        assertEquals("Routed count", expected.count, actual.count);
+        assertEquals("Routed indexOfQuantity", expected.indexOfQuantity, actual.indexOfQuantity);
+        assertEquals("Routed quantity", expected.quantity, actual.quantity);
+        for (int32_t i = 0; i < expected.count && i < actual.count; i++) {
+            if (i != expected.indexOfQuantity) {
+                assertEquals("Routed value", expected.intValues[i], actual.intValues[i]);
+            }
+        }
+    }
+
+    SharedObject::clearPtr(road);
+    SharedObject::clearPtr(road2);
+    SharedObject::clearPtr(roadGB);
+    SharedObject::clearPtr(person);
+    SharedObject::clearPtr(roadKm);
+}
+
+void UnitsRouterTest::testLimitsInInputUnit() {
+    IcuTestErrorCode status(*this, "UnitsRouter testLimitsInInputUnit");
+    const ConversionRates *rates = ConversionRates::getInstance(status);
+    if (status.errIfFailureAndReset("ConversionRates::getInstance")) {
+        return;
+    }
+
+    struct TestCase {
+        const char *source;
+        const char *target;
+        // The biggest unit of target, which limit is in.
+        const char *limitUnit;
+        double limit;
+        bool reciprocal;
+        // Whether the threshold is within one ulp of the inverse conversion
+        // of the limit. Rounding errors in the inverse conversion can put it
+        // further away, especially near zero after subtracting an offset.
+        bool exact;
+    } testCases[]{
+        {"meter", "foot-and-inch", "foot", 3.0, false, true},
+        {"meter", "centimeter", "centimeter", 100.0, false, true},
+        {"kilometer", "mile", "mile", 0.1, false, false},
+        {"meter-per-second", "kilometer-per-hour", "kilometer-per-hour", 1.0, false, true},
+        {"celsius", "fahrenheit", "fahrenheit", 50.0, false, false},
+        {"celsius", "fahrenheit", "fahrenheit", 32.0, false, false},
+        {"kelvin", "celsius", "celsius", -273.15, false, false},
+        {"liter-per-100-kilometer", "mile-per-gallon", "mile-per-gallon", 20.0, true, false},
+    };
+    for (const auto &testCase : testCases) {
+        MeasureUnitImpl source = MeasureUnitImpl::forIdentifier(testCase.source, status);
+        MeasureUnitImpl target = MeasureUnitImpl::forIdentifier(testCase.target, status);
+        ComplexUnitsConverter converter(source, target, *rates, status);
+        if (status.errIfFailureAndReset("%s -> %s", testCase.source, testCase.target)) {
+            continue;
+        }
+        double low, high;
+        converter.getLimitsInInputUnit(testCase.limit, low, high);
+        ConverterPreference preference(source, target, testCase.limit, UnicodeString(), *rates,
+                                       status);
+        MeasureUnitImpl limitUnit = MeasureUnitImpl::forIdentifier(testCase.limitUnit, status);
+        UnitsConverter limitConverter(source, limitUnit, *rates, status);
+        if (status.errIfFailureAndReset("ConverterPreference %s -> %s", testCase.source,
+                                        testCase.target)) {
+            continue;
+        }
+
+        UnicodeString name = UnicodeString(testCase.source) + " -> " + testCase.target;
+        if (testCase.reciprocal) {
+            assertFalse(name + ": no precomputed limit", low <= high);
+        } else if (testCase.exact) {
+            // The threshold is within one ulp of the inverse conversion of
+            // the limit: it is exact, the smallest quantity that converts to
+            // at least the limit.
+            assertEquals(name + ": low == high", low, high);
+            assertTrue(name + ": the threshold reaches the limit",
+                       converter.greaterThanOrEqual(low, testCase.limit));
+            assertFalse(name + ": one ulp below the threshold does not",
+                        converter.greaterThanOrEqual(Double(low).PreviousDouble(), testCase.limit));
+        } else {
+            // A band around the threshold.
+            assertTrue(name + ": low < high", low < high);
+            assertFalse(name + ": low does not reach the limit",
+                        converter.greaterThanOrEqual(low, testCase.limit));
+            assertTrue(name + ": high reaches the limit",
+                       converter.greaterThanOrEqual(high, testCase.limit));
+        }
+
+        // Probe the quantity exactly on the limit converted to the input
+        // unit, and one ulp on either side, as well as the quantities around
+        // it: reachesLimit() must agree with the conversion everywhere.
+        double inputLimit = limitConverter.convertInverse(testCase.limit);
+        double quantities[] = {0.0, inputLimit / 2, inputLimit, inputLimit * 2, 1e6};
+        for (double quantity : quantities) {
+            const double probes[] = {Double(quantity).PreviousDouble(), quantity,
+                                     Double(quantity).NextDouble()};
+            const char *probeNames[] = {"one ulp below", "exactly", "one ulp above"};
+            for (int32_t i = 0; i < UPRV_LENGTHOF(probes); i++) {
+                assertEquals(name + ": reachesLimit() " + probeNames[i] + " at " + quantity,
+                             converter.greaterThanOrEqual(probes[i], testCase.limit),
+                             (UBool)preference.reachesLimit(probes[i]));
+            }
+            for (int32_t i = -64; i <= 64; i++) {
+                double probe = quantity * (1 + i * DBL_EPSILON);
+                if (converter.greaterThanOrEqual(probe, testCase.limit) !=
+                    (UBool)preference.reachesLimit(probe)) {
+                    errln(name + ": reachesLimit() disagrees with the conversion at " + probe);
+                }
+            }
+        }
+    }
+}
+
 #endif /* #if !UCONFIG_NO_FORMATTING */
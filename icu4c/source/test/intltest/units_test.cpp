@@ -51,6 +51,8 @@ class UnitsTest : public IntlTest {
     void testComplexUnitsConverterSorting();
     void testUnitPreferencesWithCLDRTests();
     void testConverter();
+    void testConverterArray();
+    void testExactConverter();
 };
 
 extern IntlTest *createUnitsTest() { return new UnitsTest(); }
@@ -68,6 +70,8 @@ void UnitsTest::runIndexedTest(int32_t index, UBool exec, const char *&name, cha
     TESTCASE_AUTO(testComplexUnitsConverterSorting);
     TESTCASE_AUTO(testUnitPreferencesWithCLDRTests);
     TESTCASE_AUTO(testConverter);
+    TESTCASE_AUTO(testConverterArray);
+    TESTCASE_AUTO(testExactConverter);
     TESTCASE_AUTO_END;
 }
 
@@ -145,6 +149,12 @@ void UnitsTest::testExtractConvertibility() {
         {"percent", "portion", CONVERTIBLE},                                         //
         {"ofhg", "kilogram-per-square-meter-square-second", CONVERTIBLE},            //
         {"second-per-meter", "meter-per-second", RECIPROCAL},                        //
+        {"meter", "pound", UNCONVERTIBLE},                                           //
+        {"lumen", "candela", CONVERTIBLE},                                           //
+        {"liter-per-kilometer", "square-meter", CONVERTIBLE},                        //
+        {"mile-per-gallon", "square-meter", RECIPROCAL},                             //
+        {"meter-per-second", "meter-per-square-second", UNCONVERTIBLE},              //
+        {"gram-per-kilogram", "portion", UNCONVERTIBLE},                             //
     };
 
     for (const auto &testCase : testCases) {
@@ -159,11 +169,7 @@ void UnitsTest::testExtractConvertibility() {
             continue;
         }
 
-        ConversionRates conversionRates(status);
-        if (status.errIfFailureAndReset("conversionRates(status)")) {
-            continue;
-        }
-        auto convertibility = extractConvertibility(source, target, conversionRates, status);
+        auto convertibility = extractConvertibility(source, target, status);
         if (status.errIfFailureAndReset("extractConvertibility(<%s>, <%s>, ...)", testCase.source,
                                         testCase.target)) {
             continue;
@@ -182,51 +188,62 @@ void UnitsTest::testConversionInfo() {
         const char *source;
         const char *target;
         const ConversionInfo expectedConversionInfo;
+        const ConverterKind expectedKind;
     } testCases[]{
         {
             "meter",
             "meter",
             {1.0, 0, false},
+            KIND_SCALE,
         },
         {
             "meter",
             "foot",
             {3.28084, 0, false},
+            KIND_SCALE,
         },
         {
             "foot",
             "meter",
             {0.3048, 0, false},
+            KIND_SCALE,
         },
         {
             "celsius",
             "kelvin",
             {1, 273.15, false},
+            KIND_SCALE_OFFSET,
         },
         {
             "fahrenheit",
             "kelvin",
             {5.0 / 9.0, 255.372, false},
+            KIND_SCALE_OFFSET,
         },
         {
             "fahrenheit",
             "celsius",
             {5.0 / 9.0, -17.7777777778, false},
+            KIND_SCALE_OFFSET,
         },
         {
             "celsius",
             "fahrenheit",
             {9.0 / 5.0, 32, false},
+            KIND_SCALE_OFFSET,
         },
         {
             "fahrenheit",
             "fahrenheit",
             {1.0, 0, false},
+            // The offsets cancel out, but applying them may round.
+            KIND_SCALE_OFFSET,
         },
         {
             "mile-per-gallon",
             "liter-per-100-kilometer",
             {0.00425143707, 0, true},
+            KIND_RECIPROCAL,
         },
     };
 
@@ -244,6 +261,9 @@ void UnitsTest::testConversionInfo() {
         UnicodeString message =
             UnicodeString("testConverter: ") + testCase.source + " to " + testCase.target;
 
+        assertEquals(message + ", kind: ", testCase.expectedKind,
+                     unitsConverter.getLinearConversion().kind);
+
         double maxDelta = 1e-6 * uprv_fabs(testCase.expectedConversionInfo.conversionRate);
         if (testCase.expectedConversionInfo.conversionRate == 0) {
             maxDelta = 1e-12;
@@ -390,6 +410,145 @@ void UnitsTest::testConverter() {
     }
 }
 
+// Checks that convertArray() and convertInverseArray() produce exactly what
+// convert() and convertInverse() produce for each element.
+void UnitsTest::testConverterArray() {
+    IcuTestErrorCode status(*this, "UnitsTest::testConverterArray");
+
+    struct TestCase {
+        const char *source;
+        const char *target;
+    } testCases[]{
+        {"meter", "foot"},
+        {"kilogram", "pound"},
+        {"celsius", "fahrenheit"},
+        {"kelvin", "celsius"},
+        {"meter-per-second", "mile-per-hour"},
+        // Reciprocal
+        {"liter-per-100-kilometer", "mile-per-gallon"},
+        {"mile-per-gallon", "liter-per-kilometer"},
+    };
+    const double inputs[] = {0.0, 1.0, -1.0, 0.5, 3.75, 100.0, -273.15, 1e-9, 1e12, 42.0, 7.0};
+    const int32_t length = UPRV_LENGTHOF(inputs);
+
+    for (const auto &testCase : testCases) {
+        UnitsConverter converter(testCase.source, testCase.target, status);
+        if (status.errIfFailureAndReset("UnitsConverter(<%s>, <%s>, ...)", testCase.source,
+                                        testCase.target)) {
+            continue;
+        }
+        CharString msg;
+        msg.append(testCase.source, status).append(" to ", status).append(testCase.target, status);
+
+        double outputs[length];
+        converter.convertArray(inputs, outputs, length);
+        for (int32_t i = 0; i < length; i++) {
+            assertEquals(msg.data(), converter.convert(inputs[i]), outputs[i]);
+        }
+
+        double inverses[length];
+        converter.convertInverseArray(inputs, inverses, length);
+        for (int32_t i = 0; i < length; i++) {
+            assertEquals(msg.data(), converter.convertInverse(inputs[i]), inverses[i]);
+        }
+
+        // In-place conversion.
+        converter.convertArray(outputs, outputs, length);
+        for (int32_t i = 0; i < length; i++) {
+            assertEquals(msg.data(), converter.convert(converter.convert(inputs[i])), outputs[i]);
+        }
+    }
+}
+
+void UnitsTest::testExactConverter() {
+    IcuTestErrorCode status(*this, "UnitsTest::testExactConverter");
+
+    struct TestCase {
+        const char *source;
+        const char *target;
+        const char *inputValue;
+        const char *expectedValue;
+    } testCases[]{
+        {"foot", "inch", "1", "12"},
+        {"inch", "foot", "18", "1.5"},
+        {"mile", "kilometer", "1", "1.609344"},
+        {"gallon", "liter", "1", "3.785411784"},
+        {"cubic-foot", "cubic-meter", "1", "0.028316846592"},
+        {"pound", "kilogram", "2.5", "1.133980925"},
+        {"square-yard", "square-foot", "0.1", "0.9"},
+        {"kibibyte", "byte", "1.5", "1536"},
+        // Offsets
+        {"celsius", "fahrenheit", "37", "98.6"},
+        {"fahrenheit", "celsius", "98.6", "37"},
+        {"celsius", "fahrenheit", "0", "32"},
+        {"kelvin", "celsius", "0", "-273.15"},
+        // Reciprocal
+        {"liter-per-100-kilometer", "kilometer-per-liter", "4", "25"},
+        {"liter-per-100-kilometer", "kilometer-per-liter", "0", "0"},
+    };
+
+    for (const auto &testCase : testCases) {
+        ExactUnitsConverter converter(testCase.source, testCase.target, status);
+        if (status.errIfFailureAndReset("ExactUnitsConverter(<%s>, <%s>, ...)", testCase.source,
+                                        testCase.target)) {
+            continue;
+        }
+        CharString msg;
+        msg.append(testCase.source, status).append(" to ", status).append(testCase.target, status);
+
+        DecimalQuantity quantity;
+        quantity.setToDecNumber(testCase.inputValue, status);
+        converter.convert(quantity, status);
+        if (status.errIfFailureAndReset("%s", msg.data())) {
+            continue;
+        }
+        DecimalQuantity expected;
+        expected.setToDecNumber(testCase.expectedValue, status);
+        assertEquals(msg.data(), expected.toPlainString(), quantity.toPlainString());
+
+        // The inverse conversion restores the input.
+        converter.convertInverse(quantity, status);
+        if (status.errIfFailureAndReset("%s", msg.data())) {
+            continue;
+        }
+        DecimalQuantity input;
+        input.setToDecNumber(testCase.inputValue, status);
+        assertEquals(UnicodeString("inverse ") + msg.data(), input.toPlainString(),
+                     quantity.toPlainString());
+    }
+
+    // The exact conversions agree with the double conversions.
+    const char *const unitPairs[][2] = {
+        {"meter", "foot"},
+        {"celsius", "fahrenheit"},
+        {"kelvin", "fahrenheit"},
+        {"meter-per-second", "mile-per-hour"},
+        {"square-mile", "hectare"},
+        {"cubic-meter-per-meter", "mile-per-gallon"},
+        {"megabyte", "mebibyte"},
+        {"newton-meter", "foot-pound-force"},
+        {"radian", "degree"},
+    };
+    for (const auto &units : unitPairs) {
+        UnitsConverter converter(units[0], units[1], status);
+        ExactUnitsConverter exactConverter(units[0], units[1], status);
+        if (status.errIfFailureAndReset("%s to %s", units[0], units[1])) {
+            continue;
+        }
+        CharString msg;
+        msg.append(units[0], status).append(" to ", status).append(units[1], status);
+        double value = 123.456;
+        DecimalQuantity quantity;
+        quantity.setToDouble(value);
+        exactConverter.convert(quantity, status);
+        if (status.errIfFailureAndReset("%s", msg.data())) {
+            continue;
+        }
+        double expected = converter.convert(value);
+        assertEqualsNear(msg.data(), expected, quantity.toDouble(), 1e-12 * uprv_fabs(expected));
+    }
+}
+
 /**
  * Trims whitespace off of the specified string.
  * @param field is two pointers pointing at the start and end of the string.
@@ -477,7 +636,7 @@ void unitsTestDataLineFn(void *context, char *fields[][2], int32_t fieldCount, U
                      expected, commentConversionFormula.length(), commentConversionFormula.data());
 
     // Convertibility:
-    auto convertibility = extractConvertibility(sourceUnit, targetUnit, *ctx->conversionRates, status);
+    auto convertibility = extractConvertibility(sourceUnit, targetUnit, status);
     if (status.errIfFailureAndReset("extractConvertibility(<%s>, <%s>, ...)",
                                     sourceIdent.data(), targetIdent.data())) {
         return;
@@ -765,6 +924,26 @@ void UnitsTest::testComplexUnitsConverterSorting() {
                                  actual[i]->getNumber().getDouble(), testCase.accuracy);
             }
         }
+
+        // The allocation-free overload must produce the same values, in the
+        // same order.
+        ConvertedMeasures converted;
+        converter.convert(testCase.inputValue, nullptr, converted, status);
+        if (status.errIfFailureAndReset()) {
+            continue;
+        }
+        assertEquals(testCase.msg, testCase.expectedCount, converted.count);
+        for (int i = 0; i < testCase.expectedCount && i < converted.count; i++) {
+            if (testCase.expected[i].getNumber().getType() == Formattable::Type::kDouble) {
+                assertEquals(testCase.msg, i, converted.indexOfQuantity);
+                assertEqualsNear(testCase.msg, testCase.expected[i].getNumber().getDouble(),
+                                 converted.quantity, testCase.accuracy);
+            } else {
+                assertTrue(testCase.msg, i != converted.indexOfQuantity);
+                assertEquals(testCase.msg, testCase.expected[i].getNumber().getInt64(),
+                             converted.intValues[i]);
+            }
+        }
     }
 }
 
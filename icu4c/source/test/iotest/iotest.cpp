@@ -737,6 +737,7 @@ static void addAllTests(TestNode** root) {
     addTest(root, &ScanfMultipleIntegers, "ScanfMultipleIntegers");
 #endif
     addStreamTests(root);
+    addUnitsFileTests(root);
 }
 
 /* returns the path to icu/source/data/out */
@@ -32,6 +32,9 @@ addTranslitTest(TestNode** root);
 U_CFUNC void
 addStreamTests(TestNode** root);
 
+U_CFUNC void
+addUnitsFileTests(TestNode** root);
+
 U_CDECL_BEGIN
 extern const UChar NEW_LINE[];
 extern const char C_NEW_LINE[];
@@ -0,0 +1,327 @@
+// © 2021 and later: Unicode, Inc. and others.
+// License & terms of use: http://www.unicode.org/copyright.html
+/*
+**********************************************************************
+*   file name:  unitstst.cpp
+*   encoding:   UTF-8
+*   tab size:   8 (not used)
+*   indentation:4
+*
+*   Tests for UnitsFileConverter.
+**********************************************************************
+*/
+
+#include "unicode/utypes.h"
+
+#if !UCONFIG_NO_FORMATTING && !UCONFIG_NO_CONVERSION
+
+#include "unicode/measunit.h"
+#include "unicode/numberformatter.h"
+#include "unicode/unistr.h"
+#include "unicode/ustdio.h"
+#include "unicode/ustring.h"
+#include "unicode/utext.h"
+#include "unicode/uunitsfile.h"
+#include "cmemory.h"
+#include "iotest.h"
+
+#include <string>
+
+using namespace icu;
+using icu::number::LocalizedNumberFormatter;
+using icu::number::NumberFormatter;
+using icu::number::Precision;
+
+namespace {
+
+// The number of values that UnitsFileConverter converts per chunk.
+constexpr int32_t kChunkValues = 1024;
+
+// Creates a UFILE that writes into `outputBuffer`, with room for the longer
+// formatted numbers of an input of `inputLength`.
+UFILE *openOutput(LocalMemory<UChar> &outputBuffer, int32_t inputLength, UErrorCode &status) {
+    int32_t outputCapacity = 4 * inputLength + 16;
+    if (outputBuffer.allocateInsteadAndReset(outputCapacity) == nullptr) {
+        status = U_MEMORY_ALLOCATION_ERROR;
+        return nullptr;
+    }
+    return u_fstropen(outputBuffer.getAlias(), outputCapacity, "en_US");
+}
+
+// Runs `converter` over `input`, read and written as string UFILEs, and
+// returns the output.
+UnicodeString convertString(UnitsFileConverter &converter, const UnicodeString &input,
+                            int64_t &count, UErrorCode &status) {
+    UnicodeString inputCopy(input);
+    int32_t inputLength = inputCopy.length();
+    LocalMemory<UChar> outputBuffer;
+    UFILE *out = openOutput(outputBuffer, inputLength, status);
+    if (U_FAILURE(status)) {
+        return UnicodeString();
+    }
+    UChar *inputBuffer = inputCopy.getBuffer(inputLength);
+    UFILE *in = u_fstropen(inputBuffer, inputLength, "en_US");
+    count = converter.convert(in, out, status);
+    u_fclose(in);
+    u_fclose(out);
+    inputCopy.releaseBuffer(inputLength);
+    return UnicodeString(outputBuffer.getAlias(), u_strlen(outputBuffer.getAlias()));
+}
+
+// Like convertString(), with the input read from a UText.
+UnicodeString convertText(UnitsFileConverter &converter, const UnicodeString &input,
+                          const Locale &inputLocale, int64_t &count, UErrorCode &status) {
+    LocalMemory<UChar> outputBuffer;
+    UFILE *out = openOutput(outputBuffer, input.length(), status);
+    if (U_FAILURE(status)) {
+        return UnicodeString();
+    }
+    UText *in = utext_openConstUnicodeString(nullptr, &input, &status);
+    count = converter.convert(in, inputLocale, out, status);
+    utext_close(in);
+    u_fclose(out);
+    return UnicodeString(outputBuffer.getAlias(), u_strlen(outputBuffer.getAlias()));
+}
+
+std::string toUTF8(const UnicodeString &s) {
+    std::string result;
+    return s.toUTF8String(result);
+}
+
+} // namespace
+
+U_CDECL_BEGIN
+
+static void U_CALLCONV TestConverter(void) {
+    UErrorCode status = U_ZERO_ERROR;
+    LocalizedNumberFormatter formatter =
+        NumberFormatter::withLocale("en").precision(Precision::maxFraction(2));
+    UnitsFileConverter converter(MeasureUnit::getMeter(), MeasureUnit::getFoot(), formatter, u',',
+                                 status);
+    if (U_FAILURE(status)) {
+        log_data_err("Failed to create the converter - %s\n", u_errorName(status));
+        return;
+    }
+
+    int64_t count = 0;
+    UnicodeString output = convertString(
+        converter, u"name,height,width\nalice,1.5,2\r\nbob,,x1\nhalf,0.5", count, status);
+    if (U_FAILURE(status)) {
+        log_err("UnitsFileConverter::convert() failed - %s\n", u_errorName(status));
+        return;
+    }
+    if (count != 3) {
+        log_err("Converted %d values, expected 3\n", (int)count);
+    }
+    if (output != u"name,height,width\nalice,4.92,6.56\r\nbob,,x1\nhalf,1.64") {
+        log_err("Unexpected output: %s\n", toUTF8(output).c_str());
+    }
+}
+
+static void U_CALLCONV TestConverterChunks(void) {
+    UErrorCode status = U_ZERO_ERROR;
+    LocalizedNumberFormatter formatter = NumberFormatter::withLocale("en").grouping(UNUM_GROUPING_OFF);
+    UnitsFileConverter converter(MeasureUnit::getMeter(), MeasureUnit::getCentimeter(), formatter,
+                                 u'\t', status);
+    if (U_FAILURE(status)) {
+        log_data_err("Failed to create the converter - %s\n", u_errorName(status));
+        return;
+    }
+
+    // Many short lines, then a single line longer than a chunk: chunks end
+    // both between and within lines.
+    const int32_t lineCount = 3 * kChunkValues + 7;
+    const int32_t longLineCount = 2 * kChunkValues + 3;
+    UnicodeString input, expected;
+    for (int32_t i = 0; i < lineCount; i++) {
+        input.append(u"row\t").append(u'1' + i % 9).append(u"\t2\n");
+        expected.append(u"row\t").append(u'1' + i % 9).append(u"00\t200\n");
+    }
+    for (int32_t i = 0; i < longLineCount; i++) {
+        input.append(u"3\t");
+        expected.append(u"300\t");
+    }
+    input.append(u"end\n");
+    expected.append(u"end\n");
+
+    int64_t count = 0;
+    UnicodeString output = convertString(converter, input, count, status);
+    if (U_FAILURE(status)) {
+        log_err("UnitsFileConverter::convert() failed - %s\n", u_errorName(status));
+        return;
+    }
+    if (count != 2 * lineCount + longLineCount) {
+        log_err("Converted %d values, expected %d\n", (int)count, 2 * lineCount + longLineCount);
+    }
+    if (output != expected) {
+        log_err("Unexpected output of length %d, expected length %d\n", output.length(),
+                expected.length());
+    }
+}
+
+static void U_CALLCONV TestRouter(void) {
+    UErrorCode status = U_ZERO_ERROR;
+    LocalizedNumberFormatter formatter =
+        NumberFormatter::withLocale("en").precision(Precision::integer());
+    UnitsFileConverter converter(MeasureUnit::getMeter(), "US", "person-height", formatter, u',',
+                                 status);
+    if (U_FAILURE(status)) {
+        log_data_err("Failed to create the converter - %s\n", u_errorName(status));
+        return;
+    }
+
+    int64_t count = 0;
+    UnicodeString output = convertString(converter, u"bob,1.8\n", count, status);
+    if (U_FAILURE(status)) {
+        log_err("UnitsFileConverter::convert() failed - %s\n", u_errorName(status));
+        return;
+    }
+    if (count != 1) {
+        log_err("Converted %d values, expected 1\n", (int)count);
+    }
+    if (output != u"bob,5 ft 11 in\n") {
+        log_err("Unexpected output: %s\n", toUTF8(output).c_str());
+    }
+
+    // Only a converter between two units has decimal arithmetic.
+    converter.setDecimalArithmetic(true, status);
+    if (status != U_UNSUPPORTED_ERROR) {
+        log_err("setDecimalArithmetic() on a router: got %s, expected U_UNSUPPORTED_ERROR\n",
+                u_errorName(status));
+    }
+}
+
+// Without a precision() on the formatter, the routed values are rounded as by
+// NumberFormatter::usage(): to the precision of the unit preference, with a
+// carry into the larger unit.
+static void U_CALLCONV TestRouterPrecision(void) {
+    UErrorCode status = U_ZERO_ERROR;
+    LocalizedNumberFormatter formatter = NumberFormatter::withLocale("en");
+    UnitsFileConverter converter(MeasureUnit::getMeter(), "US", "person-height", formatter, u',',
+                                 status);
+    if (U_FAILURE(status)) {
+        log_data_err("Failed to create the converter - %s\n", u_errorName(status));
+        return;
+    }
+
+    int64_t count = 0;
+    // 1.8 m is 5 ft 10.866 in, and 1.8237 m is 5 ft 11.799 in.
+    UnicodeString output = convertString(converter, u"bob,1.8\nalice,1.8237\n", count, status);
+    if (U_FAILURE(status)) {
+        log_err("UnitsFileConverter::convert() failed - %s\n", u_errorName(status));
+        return;
+    }
+    if (count != 2) {
+        log_err("Converted %d values, expected 2\n", (int)count);
+    }
+    if (output != u"bob,5 ft 11 in\nalice,6 ft 0 in\n") {
+        log_err("Unexpected output: %s\n", toUTF8(output).c_str());
+    }
+
+    // The same rounding as NumberFormatter::usage().
+    LocalizedNumberFormatter usageFormatter = NumberFormatter::withLocale("en-US")
+        .unit(MeasureUnit::getMeter())
+        .usage("person-height");
+    UnicodeString usageOutput = usageFormatter.formatDouble(1.8237, status).toString(status);
+    if (U_SUCCESS(status) && usageOutput != u"6 ft, 0 in") {
+        log_err("Unexpected usage() output: %s\n", toUTF8(usageOutput).c_str());
+    }
+}
+
+static void U_CALLCONV TestText(void) {
+    UErrorCode status = U_ZERO_ERROR;
+    LocalizedNumberFormatter formatter =
+        NumberFormatter::withLocale("en").precision(Precision::maxFraction(2));
+    UnitsFileConverter converter(MeasureUnit::getMeter(), MeasureUnit::getFoot(), formatter, u';',
+                                 status);
+    if (U_FAILURE(status)) {
+        log_data_err("Failed to create the converter - %s\n", u_errorName(status));
+        return;
+    }
+
+    // The numbers are parsed with the given locale, and the supplementary
+    // characters are copied through.
+    int64_t count = 0;
+    UnicodeString output = convertText(
+        converter, u"Höhe;Breite\n1,5;2\r\n\U0001F4CF;0,5", Locale::getGermany(), count, status);
+    if (U_FAILURE(status)) {
+        log_err("UnitsFileConverter::convert(UText) failed - %s\n", u_errorName(status));
+        return;
+    }
+    if (count != 3) {
+        log_err("Converted %d values, expected 3\n", (int)count);
+    }
+    if (output != u"Höhe;Breite\n4.92;6.56\r\n\U0001F4CF;1.64") {
+        log_err("Unexpected output: %s\n", toUTF8(output).c_str());
+    }
+
+    LocalMemory<UChar> outputBuffer;
+    UFILE *out = openOutput(outputBuffer, 0, status);
+    converter.convert(static_cast<UText *>(nullptr), Locale::getGermany(), out, status);
+    u_fclose(out);
+    if (status != U_ILLEGAL_ARGUMENT_ERROR) {
+        log_err("convert(nullptr): got %s, expected U_ILLEGAL_ARGUMENT_ERROR\n",
+                u_errorName(status));
+    }
+}
+
+static void U_CALLCONV TestDecimalArithmetic(void) {
+    UErrorCode status = U_ZERO_ERROR;
+    LocalizedNumberFormatter formatter =
+        NumberFormatter::withLocale("en").precision(Precision::unlimited()).grouping(
+            UNUM_GROUPING_OFF);
+    UnitsFileConverter converter(MeasureUnit::getFoot(), MeasureUnit::getInch(), formatter, u',',
+                                 status);
+    if (U_FAILURE(status)) {
+        log_data_err("Failed to create the converter - %s\n", u_errorName(status));
+        return;
+    }
+
+    const UnicodeString input = u"0.1,12345678901234567890.123\n";
+    int64_t count = 0;
+    UnicodeString output = convertString(converter, input, count, status);
+    if (U_FAILURE(status)) {
+        log_err("UnitsFileConverter::convert() failed - %s\n", u_errorName(status));
+        return;
+    }
+    if (output != u"1.2000000000000002,148148146814814800000\n") {
+        log_err("Unexpected output with doubles: %s\n", toUTF8(output).c_str());
+    }
+
+    converter.setDecimalArithmetic(true, status);
+    output = convertString(converter, input, count, status);
+    if (U_FAILURE(status)) {
+        log_err("UnitsFileConverter::convert() with decimals failed - %s\n", u_errorName(status));
+        return;
+    }
+    if (count != 2) {
+        log_err("Converted %d values, expected 2\n", (int)count);
+    }
+    // Formatted as formatDecimal() formats the exact products.
+    UnicodeString expected = formatter.formatDecimal("1.2", status).toString(status);
+    expected.append(u',')
+        .append(formatter.formatDecimal("148148146814814814681.476", status).toString(status))
+        .append(u'\n');
+    if (U_FAILURE(status)) {
+        log_err("formatDecimal() failed - %s\n", u_errorName(status));
+        return;
+    }
+    if (output != expected || output != u"1.2,148148146814814814681.476\n") {
+        log_err("Unexpected output with decimals: %s\n", toUTF8(output).c_str());
+    }
+}
+
+U_CDECL_END
+
+#endif /* #if !UCONFIG_NO_FORMATTING && !UCONFIG_NO_CONVERSION */
+
+U_CFUNC void addUnitsFileTests(TestNode** root) {
+#if !UCONFIG_NO_FORMATTING && !UCONFIG_NO_CONVERSION
+    addTest(root, &TestConverter, "unitsfile/TestConverter");
+    addTest(root, &TestConverterChunks, "unitsfile/TestConverterChunks");
+    addTest(root, &TestRouter, "unitsfile/TestRouter");
+    addTest(root, &TestRouterPrecision, "unitsfile/TestRouterPrecision");
+    addTest(root, &TestText, "unitsfile/TestText");
+    addTest(root, &TestDecimalArithmetic, "unitsfile/TestDecimalArithmetic");
+#endif
+}
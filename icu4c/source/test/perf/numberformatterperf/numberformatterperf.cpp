@@ -0,0 +1,470 @@
+/*
+***********************************************************************
+* © 2021 and later: Unicode, Inc. and others.
+* License & terms of use: http://www.unicode.org/copyright.html
+***********************************************************************
+*/
+
+// Performance tests for number formatting with number::LocalizedNumberFormatter
+// and the unumf_* C API.
+//
+// Usage from within <ICU build tree>/test/perf/numberformatterperf/ :
+// (Linux)
+//  make
+//  export LD_LIBRARY_PATH=../../../lib:../../../stubdata:../../../tools/ctestfw
+//  ./numberformatterperf TestFormatDouble TestFormatDoubleArray --passes 3 --iterations 100
+//  ./numberformatterperf TestCApiFormatDouble TestCApiFormatDoubleArray --passes 3 --iterations 100
+//  ./numberformatterperf TestToUTF8String TestAppendToUTF8 --passes 3 --iterations 100
+//  ./numberformatterperf TestCApiResultToStringToUTF8 TestCApiResultToUTF8 --passes 3 --iterations 100
+//  ./numberformatterperf TestAppendToUTF8 TestFormatDoubleArrayToUTF8 --passes 3 --iterations 100
+//  ./numberformatterperf TestFormatterPerRequest --passes 3 --iterations 10
+//  ./numberformatterperf TestFormatInt TestFormatIntArabicDigits --passes 3 --iterations 100
+//  ./numberformatterperf TestFormatRandomDouble --passes 3 --iterations 100
+
+#include "unicode/utypes.h"
+
+#if !UCONFIG_NO_FORMATTING
+
+#include "cmemory.h"
+#include "unicode/numberformatter.h"
+#include "unicode/unumberformatter.h"
+#include "unicode/uperf.h"
+#include "unicode/ustring.h"
+
+#include <string>
+
+using namespace icu;
+
+namespace {
+
+// A column of amounts formatted by every test.
+const int32_t kValuesCount = 10000;
+
+// The formatter settings for every test: two fraction digits and grouping, as
+// for the amounts in a report.
+const char16_t kSkeleton[] = u".00";
+const char kLocale[] = "en-US";
+
+// The locales of the UTF-8 tests, all with ASCII digits: en-US formats the
+// amounts as ASCII only, de and fr use non-ASCII grouping separators for some.
+const char *const kUTF8Locales[] = {"en-US", "de", "fr"};
+
+// Fills values with kValuesCount amounts from -5000 to about 100000, with up to
+// four fraction digits.
+void fillValues(double *values) {
+    for (int32_t i = 0; i < kValuesCount; i++) {
+        values[i] = (i * 7919 % 1050000 - 50000) / 10.0 + (i % 13) / 1000.0;
+    }
+}
+
+// The magnitudes of the random doubles.
+const double kRandomScales[] = {1e-2, 1, 1e2, 1e4, 1e7};
+
+// Fills values with kValuesCount pseudo-random doubles from 0.001 to about
+// 10^7, with all 53 bits of the significand set at random: most of them need
+// 16 or 17 digits to round-trip.
+void fillRandomValues(double *values) {
+    uint64_t state = 0x9e3779b97f4a7c15ULL;
+    for (int32_t i = 0; i < kValuesCount; i++) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        double unit = static_cast<double>(state >> 11) / 9007199254740992.0; // 2^53
+        values[i] = unit * kRandomScales[i % UPRV_LENGTHOF(kRandomScales)];
+    }
+}
+
+// The number of formatters created by the per-request test, and the number of
+// values each of them formats.
+const int32_t kRequestsCount = 1000;
+const int32_t kValuesPerRequest = 5;
+
+} // namespace
+
+// Formats kValuesCount doubles into one buffer: the results of every test end
+// up in the same layout.
+class NumberFormatterFunction : public UPerfFunction {
+  public:
+    NumberFormatterFunction(UErrorCode &status)
+        : formatter_(number::NumberFormatter::forSkeleton(kSkeleton, status).locale(kLocale)) {
+        fillValues(values_);
+        // Compile the formatter before timing.
+        formatter_.formatDouble(1.5, status);
+        formatter_.formatDouble(1.5, status);
+        formatter_.formatDouble(1.5, status);
+    }
+    virtual long getOperationsPerIteration() { return kValuesCount; }
+
+  protected:
+    number::LocalizedNumberFormatter formatter_;
+    double values_[kValuesCount];
+    char16_t buffer_[kValuesCount * 16];
+    int32_t offsets_[kValuesCount + 1];
+};
+
+// Calls formatDouble() and copies out the string for each value.
+class FormatDouble : public NumberFormatterFunction {
+  public:
+    FormatDouble(UErrorCode &status) : NumberFormatterFunction(status) {}
+    virtual void call(UErrorCode *status) {
+        int32_t length = 0;
+        for (int32_t i = 0; i < kValuesCount; i++) {
+            offsets_[i] = length;
+            length += formatter_.formatDouble(values_[i], *status)
+                          .toTempString(*status)
+                          .extract(buffer_ + length, UPRV_LENGTHOF(buffer_) - length, *status);
+        }
+        offsets_[kValuesCount] = length;
+    }
+};
+
+// Formats all values with one formatDoubleArray() call.
+class FormatDoubleArray : public NumberFormatterFunction {
+  public:
+    FormatDoubleArray(UErrorCode &status) : NumberFormatterFunction(status) {}
+    virtual void call(UErrorCode *status) {
+        formatter_.formatDoubleArray(values_, kValuesCount, buffer_, UPRV_LENGTHOF(buffer_),
+                                     offsets_, *status);
+    }
+};
+
+// Calls unumf_formatDouble() and unumf_resultToString() for each value.
+class CApiFormatDouble : public NumberFormatterFunction {
+  public:
+    CApiFormatDouble(UErrorCode &status)
+        : NumberFormatterFunction(status),
+          uformatter_(unumf_openForSkeletonAndLocale(kSkeleton, -1, kLocale, &status)),
+          uresult_(unumf_openResult(&status)) {}
+    virtual void call(UErrorCode *status) {
+        int32_t length = 0;
+        for (int32_t i = 0; i < kValuesCount; i++) {
+            offsets_[i] = length;
+            unumf_formatDouble(uformatter_.getAlias(), values_[i], uresult_.getAlias(), status);
+            length += unumf_resultToString(uresult_.getAlias(), buffer_ + length,
+                                           UPRV_LENGTHOF(buffer_) - length, status);
+        }
+        offsets_[kValuesCount] = length;
+    }
+
+  private:
+    LocalUNumberFormatterPointer uformatter_;
+    LocalUFormattedNumberPointer uresult_;
+};
+
+// Formats all values with one unumf_formatDoubleArray() call.
+class CApiFormatDoubleArray : public NumberFormatterFunction {
+  public:
+    CApiFormatDoubleArray(UErrorCode &status)
+        : NumberFormatterFunction(status),
+          uformatter_(unumf_openForSkeletonAndLocale(kSkeleton, -1, kLocale, &status)) {}
+    virtual void call(UErrorCode *status) {
+        unumf_formatDoubleArray(uformatter_.getAlias(), values_, kValuesCount, buffer_,
+                                UPRV_LENGTHOF(buffer_), offsets_, status);
+    }
+
+  private:
+    LocalUNumberFormatterPointer uformatter_;
+};
+
+// Formats kValuesCount doubles in each of kUTF8Locales and appends the UTF-8
+// results to one string.
+class UTF8Function : public UPerfFunction {
+  public:
+    UTF8Function(UErrorCode &status) {
+        fillValues(values_);
+        for (const char *locale : kUTF8Locales) {
+            number::LocalizedNumberFormatter *formatter = formatters_.emplaceBackAndCheckErrorCode(
+                status, number::NumberFormatter::forSkeleton(kSkeleton, status).locale(locale));
+            if (U_FAILURE(status)) {
+                return;
+            }
+            // Compile the formatter before timing.
+            formatter->formatDouble(1.5, status);
+            formatter->formatDouble(1.5, status);
+            formatter->formatDouble(1.5, status);
+            uformatters_[formatters_.length() - 1].adoptInstead(
+                unumf_openForSkeletonAndLocale(kSkeleton, -1, locale, &status));
+        }
+        uresult_.adoptInstead(unumf_openResult(&status));
+    }
+    virtual long getOperationsPerIteration() {
+        return (long)kValuesCount * UPRV_LENGTHOF(kUTF8Locales);
+    }
+
+  protected:
+    MaybeStackVector<number::LocalizedNumberFormatter> formatters_;
+    LocalUNumberFormatterPointer uformatters_[UPRV_LENGTHOF(kUTF8Locales)];
+    LocalUFormattedNumberPointer uresult_;
+    double values_[kValuesCount];
+    std::string output_;
+};
+
+// Converts the result of toTempString() to UTF-8 for each value.
+class ToUTF8String : public UTF8Function {
+  public:
+    ToUTF8String(UErrorCode &status) : UTF8Function(status) {}
+    virtual void call(UErrorCode *status) {
+        output_.clear();
+        for (int32_t i = 0; i < formatters_.length(); i++) {
+            for (int32_t j = 0; j < kValuesCount; j++) {
+                formatters_[i]->formatDouble(values_[j], *status)
+                    .toTempString(*status)
+                    .toUTF8String(output_);
+            }
+        }
+    }
+};
+
+// Calls appendToUTF8() for each value.
+class AppendToUTF8 : public UTF8Function {
+  public:
+    AppendToUTF8(UErrorCode &status) : UTF8Function(status) {}
+    virtual void call(UErrorCode *status) {
+        output_.clear();
+        StringByteSink<std::string> sink(&output_);
+        for (int32_t i = 0; i < formatters_.length(); i++) {
+            for (int32_t j = 0; j < kValuesCount; j++) {
+                formatters_[i]->formatDouble(values_[j], *status).appendToUTF8(sink, *status);
+            }
+        }
+    }
+};
+
+// Calls unumf_resultToString() and u_strToUTF8() for each value.
+class CApiResultToStringToUTF8 : public UTF8Function {
+  public:
+    CApiResultToStringToUTF8(UErrorCode &status) : UTF8Function(status) {}
+    virtual void call(UErrorCode *status) {
+        output_.clear();
+        for (int32_t i = 0; i < formatters_.length(); i++) {
+            for (int32_t j = 0; j < kValuesCount; j++) {
+                unumf_formatDouble(uformatters_[i].getAlias(), values_[j], uresult_.getAlias(),
+                                   status);
+                UChar buffer16[64];
+                int32_t length16 = unumf_resultToString(uresult_.getAlias(), buffer16,
+                                                        UPRV_LENGTHOF(buffer16), status);
+                char buffer8[192];
+                int32_t length8;
+                u_strToUTF8(buffer8, UPRV_LENGTHOF(buffer8), &length8, buffer16, length16, status);
+                output_.append(buffer8, length8);
+            }
+        }
+    }
+};
+
+// Calls unumf_resultToUTF8() for each value.
+class CApiResultToUTF8 : public UTF8Function {
+  public:
+    CApiResultToUTF8(UErrorCode &status) : UTF8Function(status) {}
+    virtual void call(UErrorCode *status) {
+        output_.clear();
+        for (int32_t i = 0; i < formatters_.length(); i++) {
+            for (int32_t j = 0; j < kValuesCount; j++) {
+                unumf_formatDouble(uformatters_[i].getAlias(), values_[j], uresult_.getAlias(),
+                                   status);
+                char buffer8[192];
+                int32_t length8 = unumf_resultToUTF8(uresult_.getAlias(), buffer8,
+                                                     UPRV_LENGTHOF(buffer8), status);
+                output_.append(buffer8, length8);
+            }
+        }
+    }
+};
+
+// Formats all values for each locale with one formatDoubleArrayToUTF8() call.
+class FormatDoubleArrayToUTF8 : public UTF8Function {
+  public:
+    FormatDoubleArrayToUTF8(UErrorCode &status) : UTF8Function(status) {}
+    virtual void call(UErrorCode *status) {
+        output_.clear();
+        for (int32_t i = 0; i < formatters_.length(); i++) {
+            int32_t length = formatters_[i]->formatDoubleArrayToUTF8(
+                values_, kValuesCount, buffer_, UPRV_LENGTHOF(buffer_), offsets_, *status);
+            output_.append(buffer_, length);
+        }
+    }
+
+  private:
+    char buffer_[kValuesCount * 24];
+    int32_t offsets_[kValuesCount + 1];
+};
+
+// Formats kValuesCount integers from -5000000 to about 100000000 with grouping,
+// and copies out each string.
+class FormatInt : public UPerfFunction {
+  public:
+    FormatInt(const char *locale, UErrorCode &status)
+        : formatter_(number::NumberFormatter::withLocale(locale)) {
+        double values[kValuesCount];
+        fillValues(values);
+        for (int32_t i = 0; i < kValuesCount; i++) {
+            values_[i] = static_cast<int64_t>(values[i] * 1000);
+        }
+        // Compile the formatter before timing.
+        formatter_.formatInt(1, status);
+        formatter_.formatInt(1, status);
+        formatter_.formatInt(1, status);
+    }
+    virtual void call(UErrorCode *status) {
+        int32_t length = 0;
+        for (int32_t i = 0; i < kValuesCount; i++) {
+            length += formatter_.formatInt(values_[i], *status)
+                          .toTempString(*status)
+                          .extract(buffer_ + length, UPRV_LENGTHOF(buffer_) - length, *status);
+        }
+    }
+    virtual long getOperationsPerIteration() { return kValuesCount; }
+
+  private:
+    number::LocalizedNumberFormatter formatter_;
+    int64_t values_[kValuesCount];
+    char16_t buffer_[kValuesCount * 16];
+};
+
+// Creates a formatter from a skeleton for each "request", as a server does,
+// and formats a few values with it.
+class FormatterPerRequest : public UPerfFunction {
+  public:
+    FormatterPerRequest(UErrorCode &status) {
+        (void)status;
+        fillValues(values_);
+    }
+    virtual void call(UErrorCode *status) {
+        output_.remove();
+        for (int32_t i = 0; i < kRequestsCount; i++) {
+            number::LocalizedNumberFormatter formatter =
+                number::NumberFormatter::forSkeleton(kSkeleton, *status).locale(kLocale);
+            for (int32_t j = 0; j < kValuesPerRequest; j++) {
+                output_.append(formatter.formatDouble(values_[i * kValuesPerRequest + j], *status)
+                                   .toTempString(*status));
+            }
+        }
+    }
+    virtual long getOperationsPerIteration() { return kRequestsCount; }
+
+  private:
+    double values_[kValuesCount];
+    UnicodeString output_;
+};
+
+// Formats kValuesCount random doubles with unlimited precision, so that each
+// value is formatted with its shortest round-trip digits, and copies out each
+// string.
+class FormatRandomDouble : public UPerfFunction {
+  public:
+    FormatRandomDouble(UErrorCode &status)
+        : formatter_(number::NumberFormatter::withLocale(kLocale)
+                         .precision(number::Precision::unlimited())) {
+        fillRandomValues(values_);
+        // Compile the formatter before timing.
+        formatter_.formatDouble(1.5, status);
+        formatter_.formatDouble(1.5, status);
+        formatter_.formatDouble(1.5, status);
+    }
+    virtual void call(UErrorCode *status) {
+        int32_t length = 0;
+        for (int32_t i = 0; i < kValuesCount; i++) {
+            length += formatter_.formatDouble(values_[i], *status)
+                          .toTempString(*status)
+                          .extract(buffer_ + length, UPRV_LENGTHOF(buffer_) - length, *status);
+        }
+    }
+    virtual long getOperationsPerIteration() { return kValuesCount; }
+
+  private:
+    number::LocalizedNumberFormatter formatter_;
+    double values_[kValuesCount];
+    char16_t buffer_[kValuesCount * 32];
+};
+
+class NumberFormatterPerfTest : public UPerfTest {
+  public:
+    NumberFormatterPerfTest(int32_t argc, const char *argv[], UErrorCode &status)
+        : UPerfTest(argc, argv, nullptr, 0, "numberformatterperf", status) {}
+
+    virtual UPerfFunction *runIndexedTest(int32_t index, UBool exec, const char *&name,
+                                          char *par = nullptr);
+
+  private:
+    UPerfFunction *TestFormatDouble() { return create<FormatDouble>(); }
+    UPerfFunction *TestFormatDoubleArray() { return create<FormatDoubleArray>(); }
+    UPerfFunction *TestCApiFormatDouble() { return create<CApiFormatDouble>(); }
+    UPerfFunction *TestCApiFormatDoubleArray() { return create<CApiFormatDoubleArray>(); }
+    UPerfFunction *TestToUTF8String() { return create<ToUTF8String>(); }
+    UPerfFunction *TestAppendToUTF8() { return create<AppendToUTF8>(); }
+    UPerfFunction *TestCApiResultToStringToUTF8() { return create<CApiResultToStringToUTF8>(); }
+    UPerfFunction *TestCApiResultToUTF8() { return create<CApiResultToUTF8>(); }
+    UPerfFunction *TestFormatDoubleArrayToUTF8() { return create<FormatDoubleArrayToUTF8>(); }
+    UPerfFunction *TestFormatterPerRequest() { return create<FormatterPerRequest>(); }
+    UPerfFunction *TestFormatInt() { return createFormatInt("en-US"); }
+    // Arabic-Indic digits, which are not ASCII but single code units.
+    UPerfFunction *TestFormatIntArabicDigits() { return createFormatInt("ar-EG"); }
+    UPerfFunction *TestFormatRandomDouble() { return create<FormatRandomDouble>(); }
+
+    template <typename T>
+    UPerfFunction *create() {
+        UErrorCode status = U_ZERO_ERROR;
+        UPerfFunction *function = new T(status);
+        if (U_FAILURE(status)) {
+            fprintf(stderr, "Failed to create the formatters: %s\n", u_errorName(status));
+        }
+        return function;
+    }
+
+    UPerfFunction *createFormatInt(const char *locale) {
+        UErrorCode status = U_ZERO_ERROR;
+        UPerfFunction *function = new FormatInt(locale, status);
+        if (U_FAILURE(status)) {
+            fprintf(stderr, "Failed to create the formatter: %s\n", u_errorName(status));
+        }
+        return function;
+    }
+};
+
+UPerfFunction *NumberFormatterPerfTest::runIndexedTest(int32_t index, UBool exec,
+                                                       const char *&name,
+                                                       char *par /*= nullptr*/) {
+    (void)par;
+    TESTCASE_AUTO_BEGIN;
+
+    TESTCASE_AUTO(TestFormatDouble);
+    TESTCASE_AUTO(TestFormatDoubleArray);
+    TESTCASE_AUTO(TestCApiFormatDouble);
+    TESTCASE_AUTO(TestCApiFormatDoubleArray);
+    TESTCASE_AUTO(TestToUTF8String);
+    TESTCASE_AUTO(TestAppendToUTF8);
+    TESTCASE_AUTO(TestCApiResultToStringToUTF8);
+    TESTCASE_AUTO(TestCApiResultToUTF8);
+    TESTCASE_AUTO(TestFormatDoubleArrayToUTF8);
+    TESTCASE_AUTO(TestFormatterPerRequest);
+    TESTCASE_AUTO(TestFormatInt);
+    TESTCASE_AUTO(TestFormatIntArabicDigits);
+    TESTCASE_AUTO(TestFormatRandomDouble);
+
+    TESTCASE_AUTO_END;
+    return nullptr;
+}
+
+int main(int argc, const char *argv[]) {
+    UErrorCode status = U_ZERO_ERROR;
+    NumberFormatterPerfTest test(argc, argv, status);
+
+    if (U_FAILURE(status)) {
+        fprintf(stderr, "The error is %s\n", u_errorName(status));
+        test.usage();
+        return status;
+    }
+
+    if (test.run() == FALSE) {
+        test.usage();
+        fprintf(stderr, "FAILED: Tests could not be run please check the arguments.\n");
+        return -1;
+    }
+    return 0;
+}
+
+#else
+
+int main() {
+    return 0;
+}
+
+#endif /* #if !UCONFIG_NO_FORMATTING */
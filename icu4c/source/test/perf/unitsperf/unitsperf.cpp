@@ -0,0 +1,863 @@
+/*
+***********************************************************************
+* © 2020 and later: Unicode, Inc. and others.
+* License & terms of use: http://www.unicode.org/copyright.html
+***********************************************************************
+*/
+
+// Performance tests for unit conversion and usage-based unit routing.
+//
+// Usage from within <ICU build tree>/test/perf/unitsperf/ :
+// (Linux)
+//  make
+//  export LD_LIBRARY_PATH=../../../lib:../../../stubdata:../../../tools/ctestfw
+//  ./unitsperf TestUnitsRouterConstruct TestUnitsRouterShared --passes 3 --iterations 1000
+//  ./unitsperf TestUnitCategoryFromBaseUnit TestUnitCategoryLookup --passes 3 --iterations 1000
+//  ./unitsperf TestGetPreferencesFor --passes 3 --iterations 10000
+//  ./unitsperf TestUnitsRoute --passes 3 --iterations 100
+//  ./unitsperf TestUsageFormatterConstruct TestUsageFormatterCompiled --passes 3 --iterations 100
+//  ./unitsperf TestUsageFormatMixed --passes 3 --iterations 10
+//  ./unitsperf TestConverterConstruct --passes 3 --iterations 1000
+//  ./unitsperf TestConvertScalarLoop TestConvertArray TestCApiConvertArray --passes 3 --iterations 100
+//  ./unitsperf TestCApiRoute TestRouteFormatParse --passes 3 --iterations 10
+//  ./unitsperf TestConvertViaDouble TestConvertExact --passes 3 --iterations 10
+//  ./unitsperf TestParseIdentifier TestParseIdentifierCached --passes 3 --iterations 1000
+//  ./unitsperf TestMeasureUnitCopyCompare TestMeasureUnitHash --passes 3 --iterations 1000
+//  ./unitsperf TestUnitExtrasColdStart --passes 3 --iterations 10
+//  ./unitsperf TestConvertFile TestConvertFileDecimal --passes 1 --iterations 1
+
+#include "unicode/utypes.h"
+
+#if !UCONFIG_NO_FORMATTING
+
+#include "cmemory.h"
+#include "measunit_impl.h"
+#include "number_decimalquantity.h"
+#include "units_converter.h"
+#include "units_data.h"
+#include "units_router.h"
+#include "unicode/numberformatter.h"
+#include "unicode/uclean.h"
+#include "unicode/unum.h"
+#include "unicode/uperf.h"
+#include "unicode/uunits.h"
+// uperf.h defines the ucbuf.h U_EOF, which ustdio.h defines differently;
+// neither is used here.
+#undef U_EOF
+#include "unicode/ustdio.h"
+#include "unicode/uunitsfile.h"
+
+#include <cstddef>
+#include <stdlib.h>
+
+using namespace icu;
+using namespace icu::units;
+using icu::number::impl::DecimalQuantity;
+
+namespace {
+
+struct RouterTestCase {
+    const char *inputUnit;
+    const char *region;
+    const char *usage;
+};
+
+const RouterTestCase kRouterTestCases[] = {
+    {"meter", "US", "person-height"},
+    {"meter", "DE", "person-height"},
+    {"meter", "US", "road"},
+    {"meter-per-second", "US", "default"},
+    {"kilogram", "GB", "person"},
+    {"celsius", "US", "weather"},
+};
+
+// A column of telemetry values converted by the TestConvert* tests.
+const int32_t kConvertValuesCount = 100000;
+
+// Source and target units for the TestConvert* tests: a plain factor, a
+// factor with offsets, a compound unit and a reciprocal conversion.
+const char *const kConvertTestCases[][2] = {
+    {"meter", "foot"},
+    {"celsius", "fahrenheit"},
+    {"meter-per-second", "mile-per-hour"},
+    {"liter-per-100-kilometer", "mile-per-gallon"},
+};
+
+// Unit identifiers of all complexities, as passed to MeasureUnit::forIdentifier().
+const char *const kIdentifiers[] = {
+    "meter",
+    "kilometer",
+    "foot-and-inch",
+    "mile-per-hour",
+    "kilogram-meter-per-square-second",
+    "liter-per-100-kilometer",
+    "square-kilometer",
+    "cubic-centimeter",
+    "kilowatt-hour",
+    "pound-force-foot",
+    "year-and-month-and-day",
+    "milligram-ofglucose-per-deciliter",
+};
+
+// The number of DecimalQuantity values converted by TestConvertViaDouble and
+// TestConvertExact.
+const int32_t kDecimalValuesCount = 1000;
+
+// Routers exercised by TestUnitsRoute: heights, most of which fall in between
+// the preference limits, and speeds, which have a single preference.
+const RouterTestCase kRouteTestCases[] = {
+    {"meter", "US", "person-height"},
+    {"meter-per-second", "US", "default"},
+};
+
+// The number of quantities routed by TestUnitsRoute, per router.
+const int32_t kRouteValuesCount = 10000;
+
+// The category, usage and region looked up by TestGetPreferencesFor: exact
+// matches, and usages and regions that fall back.
+const char *const kPreferencesTestCases[][3] = {
+    {"length", "road", "US"},
+    {"length", "person-height", "DE"},
+    {"length", "person-height-xyzzy", "XX"},
+    {"mass", "person", "GB"},
+    {"speed", "default", "001"},
+    {"volume", "vehicle-fuel", "CA"},
+    {"area", "land-agriculture-grain", "AT"},
+    {"consumption", "unknown", "FR"},
+};
+
+// The router of TestCApiRoute and TestRouteFormatParse: road distances,
+// routed to feet or miles in the US.
+const RouterTestCase kRoadTestCase = {"meter", "US", "road"};
+
+// The i-th of the kRouteValuesCount distances routed by TestCApiRoute and
+// TestRouteFormatParse: 1 to 10000 meters, in increasing steps.
+double roadValue(int32_t i) {
+    return (1 + i % 100) * (1 + i / 100);
+}
+
+// Formatters exercised by TestUsageFormatMixed: usages whose preferences
+// include the mixed units foot-and-inch and stone-and-pound.
+const RouterTestCase kMixedFormatTestCases[] = {
+    {"meter", "US", "person-height"},
+    {"kilogram", "GB", "person"},
+};
+
+// The number of values formatted by TestUsageFormatMixed, per formatter.
+const int32_t kMixedFormatValuesCount = 1000;
+
+// The input generated for TestConvertFile: kFileLines lines of three fields,
+// about 25 bytes each, for a file of about 250 MB.
+const char *const kFileInputName = "unitsperf-input.csv";
+const char *const kFileOutputName = "unitsperf-output.csv";
+const int32_t kFileLines = 10 * 1000 * 1000;
+
+// The bytes of ICU heap memory in use, counted by the memory functions set in
+// main(). Each block is prefixed with its size.
+int64_t gHeapBytes = 0;
+
+void *U_CALLCONV countingAlloc(const void * /*context*/, size_t size) {
+    max_align_t *block = static_cast<max_align_t *>(malloc(sizeof(max_align_t) + size));
+    if (block == nullptr) {
+        return nullptr;
+    }
+    *reinterpret_cast<size_t *>(block) = size;
+    gHeapBytes += size;
+    return block + 1;
+}
+
+void *U_CALLCONV countingRealloc(const void *context, void *mem, size_t size) {
+    if (mem == nullptr) {
+        return countingAlloc(context, size);
+    }
+    max_align_t *block = static_cast<max_align_t *>(mem) - 1;
+    size_t oldSize = *reinterpret_cast<size_t *>(block);
+    block = static_cast<max_align_t *>(realloc(block, sizeof(max_align_t) + size));
+    if (block == nullptr) {
+        return nullptr;
+    }
+    *reinterpret_cast<size_t *>(block) = size;
+    gHeapBytes += (int64_t)size - (int64_t)oldSize;
+    return block + 1;
+}
+
+void U_CALLCONV countingFree(const void * /*context*/, void *mem) {
+    if (mem == nullptr) {
+        return;
+    }
+    max_align_t *block = static_cast<max_align_t *>(mem) - 1;
+    gHeapBytes -= *reinterpret_cast<size_t *>(block);
+    free(block);
+}
+
+void setCountingMemoryFunctions(UErrorCode &status) {
+    u_setMemoryFunctions(nullptr, countingAlloc, countingRealloc, countingFree, &status);
+}
+
+} // namespace
+
+// Shared setup for the TestConvert* tests.
+class UnitsConvertFunction : public UPerfFunction {
+  public:
+    UnitsConvertFunction(UErrorCode &status) {
+        if (U_FAILURE(status)) {
+            return;
+        }
+        if (input_.allocateInsteadAndReset(kConvertValuesCount) == nullptr ||
+            output_.allocateInsteadAndReset(kConvertValuesCount) == nullptr) {
+            status = U_MEMORY_ALLOCATION_ERROR;
+            return;
+        }
+        for (int32_t i = 0; i < kConvertValuesCount; i++) {
+            input_[i] = -40.0 + (i % 1000) * 0.125;
+        }
+        for (const auto &units : kConvertTestCases) {
+            converters_.emplaceBackAndCheckErrorCode(status, units[0], units[1], status);
+        }
+    }
+    virtual long getOperationsPerIteration() {
+        return (long)kConvertValuesCount * UPRV_LENGTHOF(kConvertTestCases);
+    }
+
+  protected:
+    LocalMemory<double> input_;
+    LocalMemory<double> output_;
+    MaybeStackVector<UnitsConverter> converters_;
+};
+
+// Converts kConvertValuesCount values with a scalar convert() loop, for each
+// of kConvertTestCases.
+class ConvertScalarLoop : public UnitsConvertFunction {
+  public:
+    ConvertScalarLoop(UErrorCode &status) : UnitsConvertFunction(status) {}
+    virtual void call(UErrorCode * /*status*/) {
+        for (int32_t c = 0; c < converters_.length(); c++) {
+            const UnitsConverter &converter = *converters_[c];
+            for (int32_t i = 0; i < kConvertValuesCount; i++) {
+                output_[i] = converter.convert(input_[i]);
+            }
+        }
+    }
+};
+
+// Converts kConvertValuesCount values with convertArray(), for each of
+// kConvertTestCases.
+class ConvertArray : public UnitsConvertFunction {
+  public:
+    ConvertArray(UErrorCode &status) : UnitsConvertFunction(status) {}
+    virtual void call(UErrorCode * /*status*/) {
+        for (int32_t c = 0; c < converters_.length(); c++) {
+            converters_[c]->convertArray(input_.getAlias(), output_.getAlias(), kConvertValuesCount);
+        }
+    }
+};
+
+// Constructs a UnitsConverter for each of kConvertTestCases.
+class ConverterConstruct : public UPerfFunction {
+  public:
+    virtual void call(UErrorCode *status) {
+        for (const auto &units : kConvertTestCases) {
+            UnitsConverter converter(units[0], units[1], *status);
+        }
+    }
+    virtual long getOperationsPerIteration() { return UPRV_LENGTHOF(kConvertTestCases); }
+};
+
+// Shared setup for TestConvertViaDouble and TestConvertExact.
+template <typename Converter>
+class DecimalConvertFunction : public UPerfFunction {
+  public:
+    DecimalConvertFunction(UErrorCode &status) {
+        for (const auto &units : kConvertTestCases) {
+            converters_.emplaceBackAndCheckErrorCode(status, units[0], units[1], status);
+        }
+    }
+    virtual long getOperationsPerIteration() {
+        return (long)kDecimalValuesCount * UPRV_LENGTHOF(kConvertTestCases);
+    }
+
+  protected:
+    MaybeStackVector<Converter> converters_;
+
+    static void setInput(DecimalQuantity &quantity, int32_t i) {
+        quantity.setToDouble(-40.0 + (i % 1000) * 0.125);
+    }
+};
+
+// Converts DecimalQuantity values the way UsagePrefsHandler does: through
+// double and UnitsConverter::convert().
+class ConvertViaDouble : public DecimalConvertFunction<UnitsConverter> {
+  public:
+    ConvertViaDouble(UErrorCode &status) : DecimalConvertFunction(status) {}
+    virtual void call(UErrorCode * /*status*/) {
+        DecimalQuantity quantity;
+        for (int32_t c = 0; c < converters_.length(); c++) {
+            for (int32_t i = 0; i < kDecimalValuesCount; i++) {
+                setInput(quantity, i);
+                quantity.setToDouble(converters_[c]->convert(quantity.toDouble()));
+            }
+        }
+    }
+};
+
+// Converts DecimalQuantity values with ExactUnitsConverter::convert().
+class ConvertExact : public DecimalConvertFunction<ExactUnitsConverter> {
+  public:
+    ConvertExact(UErrorCode &status) : DecimalConvertFunction(status) {}
+    virtual void call(UErrorCode *status) {
+        DecimalQuantity quantity;
+        for (int32_t c = 0; c < converters_.length(); c++) {
+            for (int32_t i = 0; i < kDecimalValuesCount; i++) {
+                setInput(quantity, i);
+                converters_[c]->convert(quantity, *status);
+            }
+        }
+    }
+};
+
+// Parses each of kIdentifiers with MeasureUnitImpl::forIdentifier().
+class ParseIdentifier : public UPerfFunction {
+  public:
+    virtual void call(UErrorCode *status) {
+        for (const char *identifier : kIdentifiers) {
+            MeasureUnitImpl::forIdentifier(identifier, *status);
+        }
+    }
+    virtual long getOperationsPerIteration() { return UPRV_LENGTHOF(kIdentifiers); }
+};
+
+// Parses each of kIdentifiers with MeasureUnitImpl::forIdentifierCached().
+class ParseIdentifierCached : public UPerfFunction {
+  public:
+    virtual void call(UErrorCode *status) {
+        for (const char *identifier : kIdentifiers) {
+            MeasureUnitImpl::forIdentifierCached(identifier, *status);
+        }
+    }
+    virtual long getOperationsPerIteration() { return UPRV_LENGTHOF(kIdentifiers); }
+};
+
+// Shared setup for TestMeasureUnitCopyCompare and TestMeasureUnitHash: the
+// MeasureUnits of kIdentifiers.
+class MeasureUnitFunction : public UPerfFunction {
+  public:
+    MeasureUnitFunction(UErrorCode &status) {
+        for (int32_t i = 0; i < UPRV_LENGTHOF(kIdentifiers); i++) {
+            fUnits[i] = MeasureUnit::forIdentifier(kIdentifiers[i], status);
+        }
+    }
+
+  protected:
+    MeasureUnit fUnits[UPRV_LENGTHOF(kIdentifiers)];
+};
+
+// Copies each of the MeasureUnits of kIdentifiers, and compares the copy with
+// each of them, like a map keyed by units does.
+class MeasureUnitCopyCompare : public MeasureUnitFunction {
+  public:
+    MeasureUnitCopyCompare(UErrorCode &status) : MeasureUnitFunction(status) {}
+    virtual void call(UErrorCode * /*status*/) {
+        int32_t equal = 0;
+        for (const MeasureUnit &unit : fUnits) {
+            MeasureUnit copy(unit);
+            for (const MeasureUnit &other : fUnits) {
+                equal += copy == other;
+            }
+        }
+        fEqual = equal;
+    }
+    virtual long getOperationsPerIteration() { return UPRV_LENGTHOF(kIdentifiers); }
+
+  private:
+    // Keeps the compiler from optimizing the comparisons away.
+    volatile int32_t fEqual = 0;
+};
+
+// Hashes each of the MeasureUnits of kIdentifiers.
+class MeasureUnitHash : public MeasureUnitFunction {
+  public:
+    MeasureUnitHash(UErrorCode &status) : MeasureUnitFunction(status) {}
+    virtual void call(UErrorCode * /*status*/) {
+        int32_t hash = 0;
+        for (const MeasureUnit &unit : fUnits) {
+            hash += unit.hashCode();
+        }
+        fHash = hash;
+    }
+    virtual long getOperationsPerIteration() { return UPRV_LENGTHOF(kIdentifiers); }
+
+  private:
+    // Keeps the compiler from optimizing the hashing away.
+    volatile int32_t fHash = 0;
+};
+
+// Parses a unit identifier right after u_cleanup(): the cost of
+// initUnitExtras(), including the loading of the units data it needs, on the
+// first use of the units code in a process.
+class UnitExtrasColdStart : public UPerfFunction {
+  public:
+    virtual void call(UErrorCode *status) {
+        u_cleanup();
+        // u_cleanup() resets the memory functions, and the blocks allocated
+        // so far are to be freed by countingFree().
+        setCountingMemoryFunctions(*status);
+        MeasureUnitImpl::forIdentifier("kilogram-meter-per-square-second", *status);
+    }
+    virtual long getOperationsPerIteration() { return 1; }
+};
+
+// Loads the units data the way every UnitsRouter used to: a fresh
+// ConversionRates and UnitPreferences instance per call.
+class ConversionRatesLoad : public UPerfFunction {
+  public:
+    virtual void call(UErrorCode *status) {
+        ConversionRates rates(*status);
+        UnitPreferences prefs(*status);
+    }
+    virtual long getOperationsPerIteration() { return 1; }
+};
+
+// Constructs a UnitsRouter for each of kRouterTestCases.
+class UnitsRouterConstruct : public UPerfFunction {
+  public:
+    virtual void call(UErrorCode *status) {
+        for (const auto &t : kRouterTestCases) {
+            UnitsRouter router(t.inputUnit, t.region, t.usage, *status);
+        }
+    }
+    virtual long getOperationsPerIteration() { return UPRV_LENGTHOF(kRouterTestCases); }
+};
+
+// Obtains the shared UnitsRouter for each of kRouterTestCases, as every
+// UsagePrefsHandler does.
+class UnitsRouterShared : public UPerfFunction {
+  public:
+    virtual void call(UErrorCode *status) {
+        for (const auto &t : kRouterTestCases) {
+            MeasureUnit inputUnit = MeasureUnit::forIdentifier(t.inputUnit, *status);
+            const SharedUnitsRouter *router =
+                SharedUnitsRouter::getInstance(inputUnit, t.region, t.usage, *status);
+            SharedObject::clearPtr(router);
+        }
+    }
+    virtual long getOperationsPerIteration() { return UPRV_LENGTHOF(kRouterTestCases); }
+};
+
+// Looks up the unit preferences for each of kPreferencesTestCases.
+class GetPreferencesFor : public UPerfFunction {
+  public:
+    virtual void call(UErrorCode *status) {
+        const UnitPreferences *prefs = UnitPreferences::getInstance(*status);
+        if (U_FAILURE(*status)) {
+            return;
+        }
+        for (const auto &t : kPreferencesTestCases) {
+            const UnitPreference *const *unitPrefs;
+            int32_t count;
+            prefs->getPreferencesFor(t[0], t[1], t[2], unitPrefs, count, *status);
+        }
+    }
+    virtual long getOperationsPerIteration() { return UPRV_LENGTHOF(kPreferencesTestCases); }
+};
+
+// Looks up the category of the input unit of each of kRouterTestCases the way
+// UnitsRouter used to: by building and serializing its compound base unit.
+class UnitCategoryFromBaseUnit : public UPerfFunction {
+  public:
+    UnitCategoryFromBaseUnit(UErrorCode &status) {
+        rates_ = ConversionRates::getInstance(status);
+        for (const auto &t : kRouterTestCases) {
+            if (U_FAILURE(status)) {
+                return;
+            }
+            MeasureUnitImpl *unit = units_.emplaceBackAndCheckErrorCode(status);
+            if (unit != nullptr) {
+                *unit = MeasureUnitImpl::forIdentifier(t.inputUnit, status);
+            }
+        }
+    }
+    virtual void call(UErrorCode *status) {
+        for (int32_t i = 0; i < units_.length(); i++) {
+            MeasureUnit baseUnit = extractCompoundBaseUnit(*units_[i], *rates_, *status).build(*status);
+            getUnitQuantity(baseUnit.getIdentifier(), *status);
+        }
+    }
+    virtual long getOperationsPerIteration() { return UPRV_LENGTHOF(kRouterTestCases); }
+
+  protected:
+    const ConversionRates *rates_ = nullptr;
+    MaybeStackVector<MeasureUnitImpl> units_;
+};
+
+// Looks up the same categories from the dimensions of the units.
+class UnitCategoryLookup : public UnitCategoryFromBaseUnit {
+  public:
+    UnitCategoryLookup(UErrorCode &status) : UnitCategoryFromBaseUnit(status) {
+        categories_ = UnitCategories::getInstance(status);
+    }
+    virtual void call(UErrorCode *status) {
+        for (int32_t i = 0; i < units_.length(); i++) {
+            categories_->getCategory(*units_[i], *status);
+        }
+    }
+
+  private:
+    const UnitCategories *categories_ = nullptr;
+};
+
+// Routes kRouteValuesCount quantities through each of kRouteTestCases.
+class UnitsRoute : public UPerfFunction {
+  public:
+    UnitsRoute(UErrorCode &status) {
+        if (U_FAILURE(status)) {
+            return;
+        }
+        for (const auto &t : kRouteTestCases) {
+            routers_.emplaceBackAndCheckErrorCode(status, t.inputUnit, t.region, t.usage, status);
+        }
+    }
+    virtual void call(UErrorCode *status) {
+        ConvertedMeasures result;
+        for (int32_t i = 0; i < routers_.length(); i++) {
+            for (int32_t j = 0; j < kRouteValuesCount; j++) {
+                // 0.01 to 100 units, in increasing steps.
+                routers_[i]->route(0.01 * (1 + j % 100) * (1 + j / 100), nullptr, result, *status);
+            }
+        }
+    }
+    virtual long getOperationsPerIteration() {
+        return (long)kRouteValuesCount * UPRV_LENGTHOF(kRouteTestCases);
+    }
+
+  private:
+    MaybeStackVector<UnitsRouter> routers_;
+};
+
+// Converts kConvertValuesCount values with uunitconv_convertArray(), for each
+// of kConvertTestCases: the C API counterpart of TestConvertArray.
+class CApiConvertArray : public UnitsConvertFunction {
+  public:
+    CApiConvertArray(UErrorCode &status) : UnitsConvertFunction(status) {
+        for (const auto &units : kConvertTestCases) {
+            uconverters_[uconvertersCount_++].adoptInstead(uunitconv_open(units[0], units[1], &status));
+        }
+    }
+    virtual void call(UErrorCode *status) {
+        for (int32_t c = 0; c < uconvertersCount_; c++) {
+            uunitconv_convertArray(uconverters_[c].getAlias(), input_.getAlias(), output_.getAlias(),
+                                   kConvertValuesCount, status);
+        }
+    }
+
+  private:
+    LocalUUnitsConverterPointer uconverters_[UPRV_LENGTHOF(kConvertTestCases)];
+    int32_t uconvertersCount_ = 0;
+};
+
+// Routes kRouteValuesCount values with uunitrouter_route().
+class CApiRoute : public UPerfFunction {
+  public:
+    CApiRoute(UErrorCode &status)
+        : urouter_(uunitrouter_open(kRoadTestCase.inputUnit, kRoadTestCase.region,
+                                    kRoadTestCase.usage, &status)) {}
+    virtual void call(UErrorCode *status) {
+        double components[4];
+        int32_t unitIndex;
+        for (int32_t i = 0; i < kRouteValuesCount; i++) {
+            uunitrouter_route(urouter_.getAlias(), roadValue(i), components,
+                              UPRV_LENGTHOF(components), &unitIndex, status);
+        }
+    }
+    virtual long getOperationsPerIteration() { return kRouteValuesCount; }
+
+  private:
+    LocalUUnitsRouterPointer urouter_;
+};
+
+// Obtains the values of TestCApiRoute the way a caller without the C API has
+// to: formats each value with a usage formatter, and parses the number back.
+class RouteFormatParse : public UPerfFunction {
+  public:
+    RouteFormatParse(UErrorCode &status)
+        : formatter_(number::NumberFormatter::with()
+                         .unit(MeasureUnit::forIdentifier(kRoadTestCase.inputUnit, status))
+                         .usage(kRoadTestCase.usage)
+                         .precision(number::Precision::maxSignificantDigits(17))
+                         .grouping(UNUM_GROUPING_OFF)
+                         .threshold(1)
+                         .locale(Locale("en", kRoadTestCase.region))),
+          parser_(unum_open(UNUM_DECIMAL, nullptr, 0, "en", nullptr, &status)) {}
+    virtual void call(UErrorCode *status) {
+        for (int32_t i = 0; i < kRouteValuesCount; i++) {
+            UnicodeString formatted = formatter_.formatDouble(roadValue(i), *status).toString(*status);
+            // Parses the number up to the unit.
+            unum_parseDouble(parser_.getAlias(), formatted.getBuffer(), formatted.length(), nullptr,
+                             status);
+        }
+    }
+    virtual long getOperationsPerIteration() { return kRouteValuesCount; }
+
+  private:
+    number::LocalizedNumberFormatter formatter_;
+    LocalUNumberFormatPointer parser_;
+};
+
+// Builds a full-name usage formatter for each of kRouterTestCases, and formats
+// one value with it: the formatter is constructed on its first use.
+class UsageFormatterConstruct : public UPerfFunction {
+  public:
+    virtual void call(UErrorCode *status) {
+        for (const auto &t : kRouterTestCases) {
+            number::LocalizedNumberFormatter formatter =
+                number::NumberFormatter::with()
+                    .unit(MeasureUnit::forIdentifier(t.inputUnit, *status))
+                    .usage(t.usage)
+                    .unitWidth(UNUM_UNIT_WIDTH_FULL_NAME)
+                    .locale(Locale("en", t.region));
+            formatter.formatDouble(1.5, *status);
+        }
+    }
+    virtual long getOperationsPerIteration() { return UPRV_LENGTHOF(kRouterTestCases); }
+};
+
+// Builds a compiled full-name usage formatter for each of kRouterTestCases, as
+// a long-lived formatter is, and formats one value with it. Reports the heap
+// memory that these formatters retain on construction.
+class UsageFormatterCompiled : public UPerfFunction {
+  public:
+    UsageFormatterCompiled(UErrorCode &status) {
+        // Load the shared data into the caches, so that only the memory of
+        // the formatters themselves is counted.
+        call(&status);
+        int64_t before = gHeapBytes;
+        {
+            MaybeStackVector<number::LocalizedNumberFormatter> formatters;
+            for (const auto &t : kRouterTestCases) {
+                number::LocalizedNumberFormatter *formatter =
+                    formatters.emplaceBackAndCheckErrorCode(status, create(t, status));
+                if (U_FAILURE(status)) {
+                    return;
+                }
+                formatter->formatDouble(1.5, status);
+            }
+            fprintf(stderr, "Compiled usage formatters retain %lld bytes each.\n",
+                    (long long)(gHeapBytes - before) / UPRV_LENGTHOF(kRouterTestCases));
+        }
+    }
+    virtual void call(UErrorCode *status) {
+        for (const auto &t : kRouterTestCases) {
+            create(t, *status).formatDouble(1.5, *status);
+        }
+    }
+    virtual long getOperationsPerIteration() { return UPRV_LENGTHOF(kRouterTestCases); }
+
+  private:
+    static number::LocalizedNumberFormatter create(const RouterTestCase &t, UErrorCode &status) {
+        return number::NumberFormatter::with()
+            .unit(MeasureUnit::forIdentifier(t.inputUnit, status))
+            .usage(t.usage)
+            .unitWidth(UNUM_UNIT_WIDTH_FULL_NAME)
+            .threshold(1)
+            .locale(Locale("en", t.region));
+    }
+};
+
+// Formats kMixedFormatValuesCount values with a compiled usage formatter for
+// each of kMixedFormatTestCases, most of them as mixed units.
+class UsageFormatMixed : public UPerfFunction {
+  public:
+    UsageFormatMixed(UErrorCode &status) {
+        for (const auto &t : kMixedFormatTestCases) {
+            formatters_.emplaceBackAndCheckErrorCode(
+                status, number::NumberFormatter::with()
+                            .unit(MeasureUnit::forIdentifier(t.inputUnit, status))
+                            .usage(t.usage)
+                            .threshold(1)
+                            .locale(Locale("en", t.region)));
+        }
+    }
+    virtual void call(UErrorCode *status) {
+        for (int32_t i = 0; i < formatters_.length(); i++) {
+            for (int32_t j = 0; j < kMixedFormatValuesCount; j++) {
+                // 0.5 to 100.4 units: heights in meters and weights in kilograms.
+                formatters_[i]->formatDouble(0.5 + j * 0.1, *status).toTempString(*status);
+            }
+        }
+    }
+    virtual long getOperationsPerIteration() {
+        return (long)kMixedFormatValuesCount * UPRV_LENGTHOF(kMixedFormatTestCases);
+    }
+
+  private:
+    MaybeStackVector<number::LocalizedNumberFormatter> formatters_;
+};
+
+// Converts a generated CSV file of kFileLines pairs of distance readings with
+// a UnitsFileConverter, from meters to feet. The file is written on
+// construction, and replaced by every call.
+class ConvertFile : public UPerfFunction {
+  public:
+    ConvertFile(UErrorCode &status, UBool decimal = false)
+        : formatter_(number::NumberFormatter::withLocale("en").precision(
+              number::Precision::maxFraction(3))),
+          decimal_(decimal) {
+        if (U_FAILURE(status)) {
+            return;
+        }
+        FILE *file = fopen(kFileInputName, "w");
+        if (file == nullptr) {
+            status = U_FILE_ACCESS_ERROR;
+            return;
+        }
+        for (int32_t i = 0; i < kFileLines; i++) {
+            fprintf(file, "sensor-%04d,%d.%03d,%d.%02d\n", i % 10000, i % 1000, i % 997, i % 89,
+                    i % 100);
+        }
+        fclose(file);
+    }
+    virtual ~ConvertFile() {
+        remove(kFileInputName);
+        remove(kFileOutputName);
+    }
+    virtual void call(UErrorCode *status) {
+        UnitsFileConverter fileConverter(MeasureUnit::getMeter(), MeasureUnit::getFoot(),
+                                         formatter_, u',', *status);
+        fileConverter.setDecimalArithmetic(decimal_, *status);
+        UFILE *in = u_fopen(kFileInputName, "r", "en", "UTF-8");
+        UFILE *out = u_fopen(kFileOutputName, "w", "en", "UTF-8");
+        if (in == nullptr || out == nullptr) {
+            *status = U_FILE_ACCESS_ERROR;
+        } else {
+            fileConverter.convert(in, out, *status);
+        }
+        u_fclose(in);
+        u_fclose(out);
+    }
+    virtual long getOperationsPerIteration() { return 2L * kFileLines; }
+
+  private:
+    number::LocalizedNumberFormatter formatter_;
+    UBool decimal_;
+};
+
+// Like ConvertFile, with decimal arithmetic.
+class ConvertFileDecimal : public ConvertFile {
+  public:
+    ConvertFileDecimal(UErrorCode &status) : ConvertFile(status, true) {}
+};
+
+class UnitsPerfTest : public UPerfTest {
+  public:
+    UnitsPerfTest(int32_t argc, const char *argv[], UErrorCode &status)
+        : UPerfTest(argc, argv, nullptr, 0, "unitsperf", status) {}
+
+    virtual UPerfFunction *runIndexedTest(int32_t index, UBool exec, const char *&name,
+                                          char *par = nullptr);
+
+  private:
+    UPerfFunction *TestConversionRatesLoad() { return new ConversionRatesLoad(); }
+    UPerfFunction *TestUnitsRouterConstruct() { return new UnitsRouterConstruct(); }
+    UPerfFunction *TestUnitsRouterShared() { return new UnitsRouterShared(); }
+    UPerfFunction *TestGetPreferencesFor() { return new GetPreferencesFor(); }
+    UPerfFunction *TestUnitCategoryFromBaseUnit() {
+        return createConvertFunction<UnitCategoryFromBaseUnit>();
+    }
+    UPerfFunction *TestUnitCategoryLookup() { return createConvertFunction<UnitCategoryLookup>(); }
+    UPerfFunction *TestUnitsRoute() { return createConvertFunction<UnitsRoute>(); }
+    UPerfFunction *TestUsageFormatterConstruct() { return new UsageFormatterConstruct(); }
+    UPerfFunction *TestUsageFormatterCompiled() {
+        return createConvertFunction<UsageFormatterCompiled>();
+    }
+    UPerfFunction *TestCApiConvertArray() { return createConvertFunction<CApiConvertArray>(); }
+    UPerfFunction *TestCApiRoute() { return createConvertFunction<CApiRoute>(); }
+    UPerfFunction *TestRouteFormatParse() { return createConvertFunction<RouteFormatParse>(); }
+    UPerfFunction *TestUsageFormatMixed() { return createConvertFunction<UsageFormatMixed>(); }
+    UPerfFunction *TestConvertFile() { return createConvertFunction<ConvertFile>(); }
+    UPerfFunction *TestConvertFileDecimal() { return createConvertFunction<ConvertFileDecimal>(); }
+    UPerfFunction *TestParseIdentifier() { return new ParseIdentifier(); }
+    UPerfFunction *TestParseIdentifierCached() { return new ParseIdentifierCached(); }
+    UPerfFunction *TestMeasureUnitCopyCompare() {
+        return createConvertFunction<MeasureUnitCopyCompare>();
+    }
+    UPerfFunction *TestMeasureUnitHash() { return createConvertFunction<MeasureUnitHash>(); }
+    UPerfFunction *TestUnitExtrasColdStart() { return new UnitExtrasColdStart(); }
+    UPerfFunction *TestConverterConstruct() { return new ConverterConstruct(); }
+    UPerfFunction *TestConvertScalarLoop() { return createConvertFunction<ConvertScalarLoop>(); }
+    UPerfFunction *TestConvertArray() { return createConvertFunction<ConvertArray>(); }
+    UPerfFunction *TestConvertViaDouble() { return createConvertFunction<ConvertViaDouble>(); }
+    UPerfFunction *TestConvertExact() { return createConvertFunction<ConvertExact>(); }
+
+    template <typename T>
+    UPerfFunction *createConvertFunction() {
+        UErrorCode status = U_ZERO_ERROR;
+        UPerfFunction *function = new T(status);
+        if (U_FAILURE(status)) {
+            fprintf(stderr, "Failed to create the converters: %s\n", u_errorName(status));
+        }
+        return function;
+    }
+};
+
+UPerfFunction *UnitsPerfTest::runIndexedTest(int32_t index, UBool exec, const char *&name,
+                                             char *par /*= nullptr*/) {
+    (void)par;
+    TESTCASE_AUTO_BEGIN;
+
+    TESTCASE_AUTO(TestConversionRatesLoad);
+    TESTCASE_AUTO(TestUnitsRouterConstruct);
+    TESTCASE_AUTO(TestUnitsRouterShared);
+    TESTCASE_AUTO(TestGetPreferencesFor);
+    TESTCASE_AUTO(TestUnitCategoryFromBaseUnit);
+    TESTCASE_AUTO(TestUnitCategoryLookup);
+    TESTCASE_AUTO(TestUnitsRoute);
+    TESTCASE_AUTO(TestCApiRoute);
+    TESTCASE_AUTO(TestRouteFormatParse);
+    TESTCASE_AUTO(TestUsageFormatterConstruct);
+    TESTCASE_AUTO(TestUsageFormatterCompiled);
+    TESTCASE_AUTO(TestUsageFormatMixed);
+    TESTCASE_AUTO(TestParseIdentifier);
+    TESTCASE_AUTO(TestParseIdentifierCached);
+    TESTCASE_AUTO(TestMeasureUnitCopyCompare);
+    TESTCASE_AUTO(TestMeasureUnitHash);
+    TESTCASE_AUTO(TestUnitExtrasColdStart);
+    TESTCASE_AUTO(TestConverterConstruct);
+    TESTCASE_AUTO(TestConvertScalarLoop);
+    TESTCASE_AUTO(TestConvertArray);
+    TESTCASE_AUTO(TestCApiConvertArray);
+    TESTCASE_AUTO(TestConvertViaDouble);
+    TESTCASE_AUTO(TestConvertExact);
+    TESTCASE_AUTO(TestConvertFile);
+    TESTCASE_AUTO(TestConvertFileDecimal);
+
+    TESTCASE_AUTO_END;
+    return nullptr;
+}
+
+int main(int argc, const char *argv[]) {
+    UErrorCode status = U_ZERO_ERROR;
+    // Before any ICU allocation: count the heap memory for
+    // TestUsageFormatterCompiled.
+    setCountingMemoryFunctions(status);
+    UnitsPerfTest test(argc, argv, status);
+
+    if (U_FAILURE(status)) {
+        fprintf(stderr, "The error is %s\n", u_errorName(status));
+        test.usage();
+        return status;
+    }
+
+    if (test.run() == FALSE) {
+        test.usage();
+        fprintf(stderr, "FAILED: Tests could not be run please check the arguments.\n");
+        return -1;
+    }
+    return 0;
+}
+
+#else
+
+int main() {
+    return 0;
+}
+
+#endif /* #if !UCONFIG_NO_FORMATTING */
@@ -0,0 +1,176 @@
+// © 2020 and later: Unicode, Inc. and others.
+// License & terms of use: http://www.unicode.org/copyright.html
+
+//--------------------------------------------------------------------
+//
+//   Tool for generating units.icu: the tables ICU needs for parsing unit
+//   identifiers, looking up unit categories and converting between units,
+//   precomputed from the "units" resource bundle so that they do not need
+//   to be built at runtime. See i18n/units_prebuilt.h for the data format.
+//
+//   Usage:  genunits [options] -i icu-data-dir -d destination-dir
+//
+//   The ICU data directory must contain units.res.
+//
+//--------------------------------------------------------------------
+
+#include "unicode/utypes.h"
+#include "unicode/uclean.h"
+#include "unicode/udata.h"
+#include "unicode/putil.h"
+
+#include "charstr.h"
+#include "cmemory.h"
+#include "uoptions.h"
+#include "unewdata.h"
+#include "units_data.h"
+#include "units_prebuilt.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+U_NAMESPACE_USE
+
+static char *progName;
+static UOption options[]={
+    UOPTION_HELP_H,             /* 0 */
+    UOPTION_HELP_QUESTION_MARK, /* 1 */
+    UOPTION_VERBOSE,            /* 2 */
+    UOPTION_ICUDATADIR,         /* 3 */
+    UOPTION_DESTDIR,            /* 4 */
+    UOPTION_COPYRIGHT,          /* 5 */
+    UOPTION_QUIET,              /* 6 */
+};
+
+void usageAndDie(int retCode) {
+        printf("Usage: %s [-v] [-options] -i icu-data-dir -d destination-dir\n", progName);
+        printf("\tRead the units resource bundle and write out units.icu\n"
+            "options:\n"
+            "\t-h or -? or --help  this usage text\n"
+            "\t-c or --copyright   include a copyright notice\n"
+            "\t-v or --verbose     turn on verbose output\n"
+            "\t-q or --quiet       do not display warnings and progress\n"
+            "\t-i or --icudatadir  directory for locating units.res,\n"
+            "\t                    followed by path, defaults to %s\n"
+            "\t-d or --destdir     destination directory, followed by the path\n",
+            u_getDataDirectory());
+        exit (retCode);
+}
+
+#if UCONFIG_NO_FORMATTING
+
+/* dummy UDataInfo cf. udata.h */
+static UDataInfo dummyDataInfo = {
+    sizeof(UDataInfo),
+    0,
+
+    U_IS_BIG_ENDIAN,
+    U_CHARSET_FAMILY,
+    U_SIZEOF_UCHAR,
+    0,
+
+    { 0, 0, 0, 0 },                 /* dummy dataFormat */
+    { 0, 0, 0, 0 },                 /* dummy formatVersion */
+    { 0, 0, 0, 0 }                  /* dummy dataVersion */
+};
+
+#else
+
+static UDataInfo dataInfo = {
+    sizeof(UDataInfo),
+    0,
+
+    U_IS_BIG_ENDIAN,
+    U_CHARSET_FAMILY,
+    U_SIZEOF_UCHAR,
+    0,
+
+    { UNITS_FMT_0, UNITS_FMT_1, UNITS_FMT_2, UNITS_FMT_3 },  /* dataFormat="Unit" */
+    { 1, 0, 0, 0 },                 /* formatVersion */
+    { 0, 0, 0, 0 }                  /* dataVersion */
+};
+
+#endif
+
+int main(int argc, char **argv) {
+    UErrorCode status = U_ZERO_ERROR;
+    const char *outDir = NULL;
+    const char *copyright = NULL;
+
+    U_MAIN_INIT_ARGS(argc, argv);
+    progName = argv[0];
+    argc=u_parseArgs(argc, argv, UPRV_LENGTHOF(options), options);
+    if(argc<0) {
+        // Unrecognized option
+        fprintf(stderr, "error in command line argument \"%s\"\n", argv[-argc]);
+        usageAndDie(U_ILLEGAL_ARGUMENT_ERROR);
+    }
+
+    if(options[0].doesOccur || options[1].doesOccur) {
+        //  -? or -h for help.
+        usageAndDie(0);
+    }
+
+    if (options[3].doesOccur) {
+        u_setDataDirectory(options[3].value);
+    }
+    if (options[4].doesOccur) {
+        outDir = options[4].value;
+    }
+    if (options[5].doesOccur) {
+        copyright = U_COPYRIGHT_STRING;
+    }
+    UBool verbose = options[2].doesOccur;
+    UBool quiet = options[6].doesOccur;
+
+#if UCONFIG_NO_FORMATTING
+    // The units code is not available: write a dummy file, so that the data
+    // build does not fail.
+    UNewDataMemory *pData;
+    const char *msg =
+        "genunits writes dummy units.icu because of UCONFIG_NO_FORMATTING, see uconfig.h";
+    fprintf(stderr, "%s\n", msg);
+
+    pData = udata_create(outDir, UNITS_DATA_TYPE, UNITS_DATA_NAME, &dummyDataInfo, NULL, &status);
+    udata_writeBlock(pData, msg, (int32_t)strlen(msg));
+    udata_finish(pData, &status);
+    return (int)status;
+
+#else
+    CharString data;
+    units::buildPrebuiltUnitsData(data, status);
+    if (U_FAILURE(status)) {
+        fprintf(stderr, "genunits: could not build the units data from units.res - %s\n",
+                u_errorName(status));
+        exit(status);
+    }
+    if (verbose) {
+        printf("genunits: units.icu data size %d bytes\n", (int)data.length());
+    }
+
+    UNewDataMemory *pData =
+        udata_create(outDir, UNITS_DATA_TYPE, UNITS_DATA_NAME, &dataInfo, copyright, &status);
+    if (U_FAILURE(status)) {
+        fprintf(stderr, "genunits: could not open output file \"%s.%s\" - %s\n",
+                UNITS_DATA_NAME, UNITS_DATA_TYPE, u_errorName(status));
+        exit(status);
+    }
+    udata_writeBlock(pData, data.data(), data.length());
+    uint32_t bytesWritten = udata_finish(pData, &status);
+    if (U_FAILURE(status)) {
+        fprintf(stderr, "genunits: error %s writing the output file\n", u_errorName(status));
+        exit(status);
+    }
+    if (bytesWritten != (uint32_t)data.length()) {
+        fprintf(stderr, "genunits: error writing the output file\n");
+        exit(U_INTERNAL_PROGRAM_ERROR);
+    }
+
+    u_cleanup();
+    if (!quiet) {
+        printf("genunits: tool completed successfully.\n");
+    }
+    return 0;
+#endif  // UCONFIG_NO_FORMATTING
+}
@@ -67,6 +67,10 @@
 #include "uspoof_impl.h"
 #endif
 
+#if !UCONFIG_NO_FORMATTING
+#include "units_prebuilt.h"
+#endif
+
 U_NAMESPACE_USE
 
 /* definitions */
@@ -741,6 +745,115 @@ ulayout_swap(const UDataSwapper *ds,
     return headerSize + size;
 }
 
+#if !UCONFIG_NO_FORMATTING
+
+// Precompiled units data swapping ---------------------------------------------
+
+static int32_t U_CALLCONV
+units_swap(const UDataSwapper *ds,
+           const void *inData, int32_t length, void *outData,
+           UErrorCode *pErrorCode) {
+    // udata_swapDataHeader checks the arguments.
+    int32_t headerSize = udata_swapDataHeader(ds, inData, length, outData, pErrorCode);
+    if (pErrorCode == nullptr || U_FAILURE(*pErrorCode)) {
+        return 0;
+    }
+
+    // Check data format and format version.
+    const UDataInfo *pInfo = (const UDataInfo *)((const char *)inData + 4);
+    if (!(
+            pInfo->dataFormat[0] == UNITS_FMT_0 &&    // dataFormat="Unit"
+            pInfo->dataFormat[1] == UNITS_FMT_1 &&
+            pInfo->dataFormat[2] == UNITS_FMT_2 &&
+            pInfo->dataFormat[3] == UNITS_FMT_3 &&
+            pInfo->formatVersion[0] == 1)) {
+        udata_printError(ds,
+            "units_swap(): data format %02x.%02x.%02x.%02x (format version %02x) "
+            "is not recognized as units data\n",
+            pInfo->dataFormat[0], pInfo->dataFormat[1],
+            pInfo->dataFormat[2], pInfo->dataFormat[3],
+            pInfo->formatVersion[0]);
+        *pErrorCode = U_UNSUPPORTED_ERROR;
+        return 0;
+    }
+    // The unit identifiers in the tries cannot be converted to another
+    // charset family.
+    if (ds->inCharset != ds->outCharset) {
+        udata_printError(ds, "units_swap(): charset family swapping is not supported\n");
+        *pErrorCode = U_UNSUPPORTED_ERROR;
+        return 0;
+    }
+
+    const uint8_t *inBytes = (const uint8_t *)inData + headerSize;
+    uint8_t *outBytes = (uint8_t *)outData + headerSize;
+
+    const int32_t *inIndexes = (const int32_t *)inBytes;
+
+    if (length >= 0) {
+        length -= headerSize;
+        if (length < UNITS_IX_COUNT * 4) {
+            udata_printError(ds,
+                "units_swap(): too few bytes (%d after header) for units data\n",
+                length);
+            *pErrorCode = U_INDEX_OUTOFBOUNDS_ERROR;
+            return 0;
+        }
+    }
+
+    int32_t indexesLength = udata_readInt32(ds, inIndexes[UNITS_IX_INDEXES_LENGTH]);
+    if (indexesLength < UNITS_IX_COUNT) {
+        udata_printError(ds,
+            "units_swap(): too few indexes (%d) for units data\n",
+            indexesLength);
+        *pErrorCode = U_INDEX_OUTOFBOUNDS_ERROR;
+        return 0;
+    }
+
+    // Read the data offsets before swapping anything.
+    int32_t indexes[UNITS_IX_COUNT];
+    for (int32_t i = 0; i < UNITS_IX_COUNT; ++i) {
+        indexes[i] = udata_readInt32(ds, inIndexes[i]);
+    }
+    int32_t size = indexes[UNITS_IX_TOTAL_SIZE];
+
+    if (length >= 0) {
+        if (length < size) {
+            udata_printError(ds,
+                "units_swap(): too few bytes (%d after header) for all of units data\n",
+                length);
+            *pErrorCode = U_INDEX_OUTOFBOUNDS_ERROR;
+            return 0;
+        }
+
+        // Copy the data for the tries and strings, which are not swapped.
+        if (inBytes != outBytes) {
+            uprv_memcpy(outBytes, inBytes, size);
+        }
+
+        // Swap the int32_t indexes[].
+        ds->swapArray32(ds, inBytes, indexesLength * 4, outBytes, pErrorCode);
+
+        // Swap the double factors[].
+        int32_t offset = indexes[UNITS_IX_FACTORS_OFFSET];
+        int32_t count = indexes[UNITS_IX_EXPONENTS_OFFSET] - offset;
+        ds->swapArray64(ds, inBytes + offset, count, outBytes + offset, pErrorCode);
+
+        // Swap the int32_t arrays from exponents[] to categories[].
+        offset = indexes[UNITS_IX_EXPONENTS_OFFSET];
+        count = indexes[UNITS_IX_UCHARS_OFFSET] - offset;
+        ds->swapArray32(ds, inBytes + offset, count, outBytes + offset, pErrorCode);
+
+        // Swap the UChar category names.
+        offset = indexes[UNITS_IX_UCHARS_OFFSET];
+        count = indexes[UNITS_IX_STEM_TRIE_OFFSET] - offset;
+        ds->swapArray16(ds, inBytes + offset, count, outBytes + offset, pErrorCode);
+    }
+
+    return headerSize + size;
+}
+
+#endif  // !UCONFIG_NO_FORMATTING
+
 /* Swap 'Test' data from gentest */
 static int32_t U_CALLCONV
 test_swap(const UDataSwapper *ds,
@@ -848,6 +961,10 @@ static const struct {
     { { 0x75, 0x6e, 0x61, 0x6d }, uchar_swapNames },    /* dataFormat="unam" */
 #if !UCONFIG_NO_NORMALIZATION
     { { 0x43, 0x66, 0x75, 0x20 }, uspoof_swap },         /* dataFormat="Cfu " */
+#endif
+#if !UCONFIG_NO_FORMATTING
+    { { UNITS_FMT_0, UNITS_FMT_1, UNITS_FMT_2, UNITS_FMT_3 },
+                                  units_swap },         // dataFormat="Unit"
 #endif
     { { 0x54, 0x65, 0x73, 0x74 }, test_swap }            /* dataFormat="Test" */
 };